@@ -1,144 +1,248 @@
+#ifndef _GNU_SOURCE
 #define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
 #include "paragon.h"
+#include "bench.h"
 #include <stdarg.h> 
 
-static double now_ms(){
+BenchOpts g_opt = {
+  .warmup = 3, .iters = 20, .ci = 0.02, .max_iters = 2000, .batch_iters = 3,
+  .format = "text", .threshold = 0.10,
+  .thread_ms = 1000, .pin = 1, .batch_wait_us = 500,
+  .train_step = 32,
+  .sweep_width = 256, .sweep_depth = 2, .sweep_input = 784, .sweep_output = 10, .sweep_batch = 1,
+};
+
+/* human-readable progress; moves to stderr when records go to stdout */
+FILE* g_txt = NULL;
+
+double now_ms(void){
   struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
   return ts.tv_sec*1000.0 + ts.tv_nsec/1e6;
 }
 
-static void append(char** buf, size_t* cap, size_t* len, const char* fmt, ...){
-  va_list ap; va_start(ap, fmt);
-  char tmp[512]; int w = vsnprintf(tmp, sizeof(tmp), fmt, ap);
-  va_end(ap);
-  if(w<0) exit(1);
-  if(*len + w + 1 > *cap){
-    *cap = (*cap + w + 1024) * 2;
-    *buf = (char*)realloc(*buf, *cap);
-    if(!*buf) exit(1);
-  }
-  memcpy(*buf + *len, tmp, w); *len += w; (*buf)[*len]=0;
+/* Request JSON lives in the caller's arena: sized up front, freed with the arena. */
+static char* arena_buf(ParagonArena* a, size_t cap){
+  char* b = (char*)paragon_arena_alloc(a, cap);
+  if(!b) exit(1);
+  return b;
 }
 
-static char* json_layers(const int* dims, int ndims){
-  size_t cap=1024,len=0; char* b=malloc(cap); if(!b) exit(1); b[0]=0;
-  append(&b,&cap,&len,"[");
-  for(int i=0;i<ndims;i++){
-    if(i) append(&b,&cap,&len,",");
-    append(&b,&cap,&len,"{\"Width\":%d,\"Height\":1}", dims[i]);
-  }
-  append(&b,&cap,&len,"]");
+char* json_layers(ParagonArena* a, const int* dims, int ndims){
+  size_t cap = (size_t)ndims*40 + 4, len = 0;
+  char* b = arena_buf(a, cap);
+  b[len++] = '[';
+  for(int i=0;i<ndims;i++)
+    len += (size_t)snprintf(b+len, cap-len, "%s{\"Width\":%d,\"Height\":1}", i?",":"", dims[i]);
+  snprintf(b+len, cap-len, "]");
   return b;
 }
-static char* json_activs(int ndims){
-  size_t cap=512,len=0; char* b=malloc(cap); if(!b) exit(1); b[0]=0;
-  append(&b,&cap,&len,"[\"linear\"");
-  for(int i=1;i<ndims-1;i++) append(&b,&cap,&len,",\"relu\"");
-  append(&b,&cap,&len,",\"softmax\"]");
+char* json_activs(ParagonArena* a, int ndims){
+  size_t cap = (size_t)ndims*10 + 16, len = 0;
+  char* b = arena_buf(a, cap);
+  len += (size_t)snprintf(b, cap, "[\"linear\"");
+  for(int i=1;i<ndims-1;i++) len += (size_t)snprintf(b+len, cap-len, ",\"relu\"");
+  snprintf(b+len, cap-len, ",\"softmax\"]");
   return b;
 }
-static char* json_trainable(int ndims){
-  size_t cap=256,len=0; char* b=malloc(cap); if(!b) exit(1); b[0]=0;
-  append(&b,&cap,&len,"[");
-  for(int i=0;i<ndims;i++) append(&b,&cap,&len, i?",true":"true");
-  append(&b,&cap,&len,"]");
+char* json_trainable(ParagonArena* a, int ndims){
+  size_t cap = (size_t)ndims*5 + 4, len = 0;
+  char* b = arena_buf(a, cap);
+  b[len++] = '[';
+  for(int i=0;i<ndims;i++) len += (size_t)snprintf(b+len, cap-len, i?",true":"true");
+  snprintf(b+len, cap-len, "]");
   return b;
 }
-static char* json_fixed784(){
-  /* Reproduce C#’s vector: LCG 1664525/1013904223, /0xffffffff, rounded-ish. */
-  size_t cap=20000,len=0; char* b=malloc(cap); if(!b) exit(1); b[0]=0;
-  append(&b,&cap,&len,"[[");
-  unsigned s = 123u;
-  for(int i=0;i<784;i++){
+void fill_lcg(float* x, int n, unsigned seed){
+  /* Reproduce C#’s vector: LCG 1664525/1013904223, /0xffffffff, rounded to 6 places. */
+  unsigned s = seed;
+  for(int i=0;i<n;i++){
     s = s*1664525u + 1013904223u;
     double v = (double)s / 4294967295.0;
-    append(&b,&cap,&len, (i?",%.6f":"%.6f"), v);
+    x[i] = (float)(round(v*1e6)/1e6);
   }
-  append(&b,&cap,&len,"]]");
-  return b;
+}
+static void fixed784(float* x){ fill_lcg(x, 784, 123u); }
+
+static int cmp_double(const void* a, const void* b){
+  double x=*(const double*)a, y=*(const double*)b;
+  return (x>y) - (x<y);
+}
+
+/* nearest-rank percentile over sorted samples */
+static double pct(const double* v, int n, double p){
+  if(n<=0) return 0.0;
+  int k = (int)ceil(p/100.0*n) - 1;
+  if(k<0) k=0;
+  if(k>=n) k=n-1;
+  return v[k];
+}
+
+void stats_of(double* v, int n, Stats* st){
+  memset(st, 0, sizeof(*st));
+  st->n = n;
+  if(n<=0) return;
+  qsort(v, (size_t)n, sizeof(double), cmp_double);
+  double sum=0.0;
+  for(int i=0;i<n;i++) sum += v[i];
+  st->mean = sum/n;
+  double ss=0.0;
+  for(int i=0;i<n;i++){ double d=v[i]-st->mean; ss += d*d; }
+  st->sd  = n>1 ? sqrt(ss/(n-1)) : 0.0;
+  st->min = v[0]; st->max = v[n-1];
+  st->p50 = pct(v,n,50); st->p90 = pct(v,n,90); st->p99 = pct(v,n,99);
+}
+
+/* 95% CI half-width relative to the mean */
+static double rel_ci(const double* v, int n){
+  if(n<2) return INFINITY;
+  double sum=0.0, ss=0.0;
+  for(int i=0;i<n;i++) sum += v[i];
+  double m = sum/n;
+  for(int i=0;i<n;i++){ double d=v[i]-m; ss += d*d; }
+  if(m<=0) return INFINITY;
+  return 1.96*sqrt(ss/(n-1)/n)/m;
 }
 
-static int parse_vector_tolerant(const char* txt, double* out, int maxn){
-  if(!txt) return 0;
-  const char* p = strchr(txt, '[');
-  const char* q = strrchr(txt, ']');
-  if(!p || !q || q<=p) return 0;
+/* one request: forward+extract, or write into the staging buffer and forward from it */
+static int step(ParagonAPI* api, ParagonHandle h, const float* x, int dim,
+                float* out, int cap, ParagonStaging* stg){
+  if(stg){
+    memcpy(stg->in, x, sizeof(float)*(size_t)dim);
+    int got = paragon_staging_forward(api, stg, 1, dim);
+    if(got>cap) got = cap;
+    if(got>0) memcpy(out, stg->out, sizeof(float)*(size_t)got);
+    return got;
+  }
+  if(!paragon_forward_f32(api,h,x,1,dim)) return -1;
+  return paragon_extract_f32(api,h,out,cap);
+}
+
+/* Time one sample per request: warmup, then iters (or until the CI is tight).
+   *failed counts the timed requests that errored; the last good output stays in out. */
+static int measure(ParagonAPI* api, ParagonHandle h, const float* x, int dim,
+                   float* out, int cap, Stats* st, ParagonStaging* stg, int* failed){
+  int got = 0, r;
+  *failed = 0;
+  for(int i=0;i<g_opt.warmup;i++) got = step(api,h,x,dim,out,cap,stg);
+  int maxn = g_opt.autocal ? (g_opt.max_iters>g_opt.iters ? g_opt.max_iters : g_opt.iters) : g_opt.iters;
+  if(maxn<1) maxn = 1;
+  double* v = malloc(sizeof(double)*(size_t)maxn);
+  if(!v) exit(1);
   int n=0;
-  for(const char* s=p+1; s<q && n<maxn; ){
-    char* e=NULL; double v = strtod(s,&e);
-    if(e==s){ ++s; continue; }
-    out[n++] = v; s = e;
+  while(n<maxn){
+    double t0 = now_ms();
+    r = step(api,h,x,dim,out,cap,stg);
+    v[n++] = now_ms() - t0;
+    if(r<0) ++*failed; else got = r;
+    if(n>=g_opt.iters && (!g_opt.autocal || rel_ci(v,n)<=g_opt.ci)) break;
   }
-  return n;
+  stats_of(v, n, st);
+  free(v);
+  return got;
 }
 
-static void try_gpu_enable(ParagonAPI* api, ParagonHandle h){
-  if(!api || !api->Call) return;
-  /* best-effort knobs, all optional */
-  paragon_call0(api,h,"SetWebGPUNative");    /* some builds use bool default=true */
-  paragon_call0(api,h,"WebGPUNativeOn");
-  api->Call(h,"Configure","[{\"WebGPUNative\":true}]");
-  api->Call(h,"SetOptions","[{\"WebGPUNative\":true}]");
-  api->Call(h,"SetField","[\"WebGPUNative\",true]");
-  /* generic message-based */
-  api->Call(h,"Call","[\"SetWebGPUNative\",[true]]");
+void print_stats(const char* label, const Stats* st){
+  fprintf(g_txt, "%s  ⏱ p50 %.3f ms  p90 %.3f  p99 %.3f  min %.3f  max %.3f  sd %.3f  (n=%d)\n",
+    label, st->p50, st->p90, st->p99, st->min, st->max, st->sd, st->n);
 }
 
-static void run_one(ParagonAPI* api, const char* id, const int* dims, int ndims){
-  char* layers = json_layers(dims, ndims);
-  char* activs = json_activs(ndims);
-  char* fully  = json_trainable(ndims);
-  char* xin    = json_fixed784();
-
-  printf("\n=== %s (%d", id, dims[0]);
-  for(int i=1;i<ndims;i++) printf("→%d", dims[i]);
-  printf(") ===\n");
-
-  char* newr = paragon_new_net_any(api, layers, activs, fully, false, false);
-  ParagonHandle h = paragon_parse_handle(newr);
-  if(h<=0){
-    fprintf(stderr, "NewNetwork failed or missing. newr=%s\n", newr?newr:"<null>");
-    goto out;
+static const int BATCHES[] = {1, 8, 64, 256, 1024};
+#define NBATCHES ((int)(sizeof(BATCHES)/sizeof(BATCHES[0])))
+
+/* per-call latency and samples/sec for each batch size through paragon_forward_batch */
+static void bench_batches(ParagonAPI* api, ParagonHandle h, int in_dim, int out_dim,
+                          Stats* st, double* sps){
+  int maxn = BATCHES[NBATCHES-1];
+  float* X = malloc(sizeof(float)*(size_t)maxn*in_dim);
+  float* Y = malloc(sizeof(float)*(size_t)maxn*out_dim);
+  if(!X || !Y) exit(1);
+  for(int i=0;i<maxn;i++) fill_lcg(X+(size_t)i*in_dim, in_dim, 123u+(unsigned)i);
+  for(int k=0;k<NBATCHES;k++){
+    if(g_opt.warmup>0) (void)paragon_forward_batch(api, h, X, BATCHES[k], in_dim, Y, out_dim);
+    double v[64];
+    int n = g_opt.batch_iters<1 ? 1 : (g_opt.batch_iters>64 ? 64 : g_opt.batch_iters);
+    int got = 0;
+    for(int i=0;i<n;i++){
+      double t0 = now_ms();
+      got = paragon_forward_batch(api, h, X, BATCHES[k], in_dim, Y, out_dim);
+      v[i] = now_ms() - t0;
+    }
+    stats_of(v, n, &st[k]);
+    sps[k] = (got>0 && st[k].p50>0) ? got*1000.0/st[k].p50 : 0.0;
   }
+  free(X); free(Y);
+}
+
+static void print_vector(const char* label, const float* v, int n){
+  fprintf(g_txt, "%s: [[", label);
+  for(int i=0;i<n;i++) fprintf(g_txt, i?", %.9g":"%.9g", (double)v[i]);
+  fprintf(g_txt, "]]\n");
+}
+
+ParagonHandle bench_new_net(ParagonAPI* api, const int* dims, int ndims){
+  ParagonArena ar; paragon_arena_init(&ar, 1024);
+  char* layers = json_layers(&ar, dims, ndims);
+  char* activs = json_activs(&ar, ndims);
+  char* fully  = json_trainable(&ar, ndims);
+  ParagonHandle h = paragon_new_handle(api, layers, activs, fully, false, false);
+  paragon_arena_free(&ar);
+  return h;
+}
+
+static void run_one(ParagonAPI* api, const char* id, const int* dims, int ndims){
+  ParagonArena ar; paragon_arena_init(&ar, 1024);
+  char* layers = json_layers(&ar, dims, ndims);
+  char* activs = json_activs(&ar, ndims);
+  char* fully  = json_trainable(&ar, ndims);
+  float xin[784];
+  fixed784(xin);
+
+  fprintf(g_txt, "\n=== %s (%d", id, dims[0]);
+  for(int i=1;i<ndims;i++) fprintf(g_txt, "→%d", dims[i]);
+  fprintf(g_txt, ") ===\n");
+
+  ParagonHandle h = paragon_new_handle(api, layers, activs, fully, false, false);
+  if(h<=0) goto out;
 
   /* GPU init */
   double t_gpu_init_s = now_ms();
-  char* adapter = paragon_call0(api,h,"InitializeOptimizedGPU");
+  char* adapter = paragon_init_gpu(api,h);
   double t_gpu_init_e = now_ms();
-  (void)adapter; /* we print via raw below */
-  try_gpu_enable(api,h); /* optional paths */
+  /* we print via raw below; the library's copy goes back right away */
+  char* raw = paragon_arena_printf(&ar, "%s", adapter ? adapter : "");
+  paragon_free_result(api, adapter);
+  adapter = raw;
+  (void)paragon_enable_gpu(api,h);  /* the one knob negotiated at load */
+  ParagonStaging stg;
+  int have_stg = paragon_staging_init(api, h, &stg, dims[0], dims[ndims-1]);
 
   /* CPU pass */
-  double t0 = now_ms();
-  {
-    size_t n=strlen(xin)+3; char* args=malloc(n); snprintf(args,n,"[%s]", xin);
-    (void)api->Call(h,"Forward",args); free(args);
-  }
-  char* outA = paragon_call0(api,h,"ExtractOutput");
-  double t1 = now_ms();
+  float a[1024]={0}, b[1024]={0};
+  Stats cpu_st, gpu_st;
+  int cpu_fail, gpu_fail, stg_fail = 0;
+  int na = measure(api,h,xin,784,a,1024,&cpu_st,NULL,&cpu_fail);
+  Stats cpu_bst[NBATCHES]; double cpu_sps[NBATCHES];
+  bench_batches(api,h,dims[0],dims[ndims-1],cpu_bst,cpu_sps);
 
   /* GPU pass */
-  (void) paragon_call0(api,h,"ToggleGPU");  /* optional; ignored if missing */
-  double tg0 = now_ms();
-  {
-    size_t n=strlen(xin)+3; char* args=malloc(n); snprintf(args,n,"[%s]", xin);
-    (void)api->Call(h,"Forward",args); free(args);
-  }
-  char* outB = paragon_call0(api,h,"ExtractOutput");
-  double tg1 = now_ms();
+  paragon_free_result(api, paragon_call_id(api,h,PARAGON_M_TOGGLE_GPU,"[]"));  /* optional; ignored if missing */
+  int nb = measure(api,h,xin,784,b,1024,&gpu_st,NULL,&gpu_fail);
+  Stats stg_st; memset(&stg_st, 0, sizeof(stg_st));
+  float c[1024]={0};
+  if(have_stg) (void)measure(api,h,xin,784,c,1024,&stg_st,&stg,&stg_fail);
+  Stats gpu_bst[NBATCHES]; double gpu_sps[NBATCHES];
+  bench_batches(api,h,dims[0],dims[ndims-1],gpu_bst,gpu_sps);
 
-  double a[1024]={0}, b[1024]={0};
-  int na = parse_vector_tolerant(outA, a, 1024);
-  int nb = parse_vector_tolerant(outB, b, 1024);
   int n  = na<nb?na:nb;
-  double mae=0.0, mx=0.0;
-  for(int i=0;i<n;i++){ double d=fabs(a[i]-b[i]); mae+=d; if(d>mx) mx=d; }
-  if(n>0) mae/=n;
+  ParagonParity par; paragon_parity_reset(&par);
+  paragon_parity_add(&par, a, b, n, 0);
+  double mae = par.mae, mx = par.max_abs;
 
   /* Console like C# */
   /* shape/estMB */
@@ -147,54 +251,322 @@ static void run_one(ParagonAPI* api, const char* id, const int* dims, int ndims)
   for(int i=1;i<ndims;i++)   params += dims[i];
   double estMB = params * 4.0 / (1024.0*1024.0);
 
-  printf("Shape: ");
-  for(int i=0;i<ndims;i++){ if(i) printf(" → "); printf("%d", dims[i]); }
-  printf("   (~weights %.2f MB)\n", estMB);
+  fprintf(g_txt, "Shape: ");
+  for(int i=0;i<ndims;i++){ if(i) fprintf(g_txt, " → "); fprintf(g_txt, "%d", dims[i]); }
+  fprintf(g_txt, "   (~weights %.2f MB)\n", estMB);
 
-  printf("GPU init: %s  in %.2f ms\n",
-    adapter && *adapter ? adapter : "{}", (t_gpu_init_e - t_gpu_init_s));
+  ParagonHandleInfo hi;
+  int gpu_cached = paragon_handle_info(api, h, &hi) && (hi.flags & PARAGON_HF_GPU_CACHED);
+  fprintf(g_txt, "GPU init: %s  in %.2f ms%s\n",
+    adapter && *adapter ? adapter : "{}", (t_gpu_init_e - t_gpu_init_s),
+    gpu_cached ? "  (pipeline cache hit)" : "");
+  ParagonMemInfo mi;
+  memset(&mi, 0, sizeof(mi));
+  if(paragon_handle_memory(api, h, &mi)){
+    char dev[48];
+    if(mi.device_bytes>=0) snprintf(dev, sizeof(dev), "%.2f MB", mi.device_bytes/(1024.0*1024.0));
+    else                   snprintf(dev, sizeof(dev), "unknown");
+    fprintf(g_txt, "Memory: estimated %.2f MB host / %.2f MB device, measured %.2f MB host (%s) / %s device\n",
+      mi.est_host/(1024.0*1024.0), mi.est_device/(1024.0*1024.0), mi.host_bytes/(1024.0*1024.0),
+      mi.from_library ? "MemoryInfo" : "RSS growth", dev);
+  }
 
-  double cpu_ms = (t1 - t0);
-  double gpu_ms = (tg1 - tg0);
-  printf("CPU  ⏱ %.3f ms\n", cpu_ms);
-  printf("GPU  ⏱ %.3f ms\n", gpu_ms);
-  printf("Speedup: %.2fx\n", (gpu_ms>0? cpu_ms/gpu_ms : 0.0));
-  printf("Δ(CPU vs GPU)  mae=%0.00E  max=%0.00E\n", mae, mx);
-  printf("CPU ExtractOutput: %s\n", outA?outA:"");
-  printf("GPU ExtractOutput: %s\n", outB?outB:"");
+  print_stats("CPU", &cpu_st);
+  print_stats("GPU", &gpu_st);
+  if(cpu_fail || gpu_fail)
+    fprintf(g_txt, "FAILED calls: CPU %d/%d, GPU %d/%d (those rows are marked failed)\n",
+      cpu_fail, cpu_st.n, gpu_fail, gpu_st.n);
+  if(have_stg){
+    print_stats("GPU staged", &stg_st);
+    if(stg_fail) fprintf(g_txt, "FAILED calls: GPU staged %d/%d\n", stg_fail, stg_st.n);
+    fprintf(g_txt, "Staging: %s%s\n", stg.registered ? "registered with library" : "bridge-side",
+      stg.locked ? ", mlock'd" : "");
+  }
+  fprintf(g_txt, "Speedup (p50): %.2fx\n", (gpu_st.p50>0? cpu_st.p50/gpu_st.p50 : 0.0));
+  fprintf(g_txt, "Δ(CPU vs GPU)  mae=%0.00E  max=%0.00E  (%u ulp, %lld/%lld bit-identical)\n",
+    mae, mx, par.max_ulp, par.exact, par.n);
+  fprintf(g_txt, "Batch   CPU samples/s   GPU samples/s   (%s)\n",
+    api->ForwardBatch_F32 ? "batched" : "per-row");
+  for(int k=0;k<NBATCHES;k++)
+    fprintf(g_txt, "%5d   %13.1f   %13.1f\n", BATCHES[k], cpu_sps[k], gpu_sps[k]);
+  fprintf(g_txt, "I/O: %s, dispatch by %s, GPU enabled by %s\n",
+    api->Forward_F32 && api->ExtractOutput_F32 ? "raw f32" : "json",
+    api->MethodID && api->CallID ? "id" : "name", paragon_gpu_enable_method(api));
+  if(!g_opt.quiet){
+    print_vector("CPU ExtractOutput", a, na>0?na:0);
+    print_vector("GPU ExtractOutput", b, nb>0?nb:0);
+  }
+
+  /* machine-readable rows: batch 1 from the latency series, larger batches from the table */
+  BenchRecord rec; memset(&rec, 0, sizeof(rec));
+  snprintf(rec.shape, sizeof(rec.shape), "%s", id);
+  for(int i=0, w=0; i<ndims && w<(int)sizeof(rec.dims); i++)
+    w += snprintf(rec.dims+w, sizeof(rec.dims)-(size_t)w, i?"-%d":"%d", dims[i]);
+  rec.est_mb = estMB;
+  rec.host_mb = mi.host_bytes/(1024.0*1024.0);
+  rec.device_mb = mi.device_bytes>=0 ? mi.device_bytes/(1024.0*1024.0) : -1.0;
+  rec.gpu_init_ms = t_gpu_init_e - t_gpu_init_s;
+  snprintf(rec.adapter, sizeof(rec.adapter), "%s", adapter ? adapter : "");
+  rec.mae = mae; rec.max_abs = mx; rec.max_ulp = par.max_ulp;
+  rec.threads = 1;
+  for(int g=0; g<2; g++){
+    snprintf(rec.backend, sizeof(rec.backend), "%s", g ? "gpu" : "cpu");
+    rec.batch = 1;
+    rec.st = g ? gpu_st : cpu_st;
+    rec.failed = g ? gpu_fail : cpu_fail;
+    rec.sps = rec.st.p50>0 && !rec.failed ? 1000.0/rec.st.p50 : 0.0;
+    bench_record(&rec);
+    rec.failed = 0;
+    for(int k=0;k<NBATCHES;k++){
+      if(BATCHES[k]<=1) continue;
+      rec.batch = BATCHES[k];
+      rec.st  = g ? gpu_bst[k] : cpu_bst[k];
+      rec.sps = g ? gpu_sps[k] : cpu_sps[k];
+      bench_record(&rec);
+    }
+  }
+
+  if(have_stg){
+    snprintf(rec.backend, sizeof(rec.backend), "gpu-stg");
+    rec.batch = 1;
+    rec.st  = stg_st;
+    rec.failed = stg_fail;
+    rec.sps = stg_st.p50>0 && !stg_fail ? 1000.0/stg_st.p50 : 0.0;
+    bench_record(&rec);
+    rec.failed = 0;
+    paragon_staging_free(api, &stg);
+  }
+
+  if(g_opt.pipeline>0) bench_pipeline(api, &rec, h, dims, ndims);   /* h is still on GPU */
+  if(g_opt.threads>0) bench_threads(api, &rec, dims, ndims);
+  if(g_opt.start) bench_start(api, &rec, dims, ndims);
+  if(g_opt.model_dir) bench_model(api, &rec, dims, ndims);
+  if(g_opt.ref) bench_ref(api, &rec, dims, ndims);
+  if(g_opt.adapters) bench_adapters(api, &rec, dims, ndims);
+  if(g_opt.quant) bench_quant(api, &rec, dims, ndims);
+  if(g_opt.microbatch) bench_batcher(api, &rec, dims, ndims);
+  if(g_opt.pool) bench_pool(api, &rec, dims, ndims);
+  if(g_opt.route) bench_route(api, &rec, dims, ndims);
+  if(g_opt.cache) bench_cache(api, &rec, dims, ndims);
+  if(g_opt.group) bench_group(api, &rec, dims, ndims);
+  if(g_opt.train) bench_train(api, &rec, dims, ndims);
+  if(g_opt.numa) bench_numa(api, &rec, dims, ndims);
+  if(g_opt.determinism) bench_determinism(api, &rec, dims, ndims);
+  if(g_opt.budget_mb>0) bench_budget(api, &rec, dims, ndims);
+  if(g_opt.inference) bench_inference(api, &rec, dims, ndims);
+  (void)paragon_free_handle(api, h);   /* else every shape stays resident, and under the budget */
 
 out:
-  free(layers); free(activs); free(fully); free(xin);
+  paragon_arena_free(&ar);
+}
+
+#define DEFAULT_GPU_CACHE ".paragon-gpu-cache"
+
+static void usage(const char* argv0){
+  fprintf(stderr,
+    "usage: %s [lib.so] [--warmup=N] [--iters=N] [--auto[=CI]] [--max-iters=N] [--quiet]\n"
+    "          [--batch-iters=N] [--format=text|json|csv] [--out=FILE]\n"
+    "          [--baseline=FILE] [--threshold=FRAC]\n"
+    "          [--threads=N] [--shared-handle] [--thread-ms=MS] [--no-pin]\n"
+    "          [--pipeline=DEPTH] [--gpu-cache=DIR] [--cache-miss|--cache-hit]\n"
+    "          [--model-dir=DIR] [--ref] [--adapters[=rr|load]] [--clients=N]\n"
+    "          [--quant] [--microbatch=B] [--batch-wait-us=T] [--pool=N] [--route]\n"
+    "          [--cache=N] [--group=N] [--train[=STEP]] [--numa[=T]]\n"
+    "          [--determinism[=N]] [--budget=MB[:evict]] [--inference]\n"
+    "          [--lazy] [--prewarm]\n"
+    "          [--trace=FILE] [--sweep=AXIS:LO..HI[:POINTS]] [--width=W] [--depth=D]\n"
+    "          [--input=N] [--output=N] [--batch=B]\n"
+    "  --warmup=N     untimed forwards before measuring (default %d)\n"
+    "  --iters=N      measured forwards per backend (default %d)\n"
+    "  --auto[=CI]    sample until the 95%% CI half-width is within CI of the mean\n"
+    "                 (default %.2f), capped by --max-iters (default %d)\n"
+    "  --quiet        do not print ExtractOutput vectors\n"
+    "  --batch-iters=N  measured calls per batch size (default %d, max 64)\n"
+    "  --format=F     records as json or csv (text only by default)\n"
+    "  --out=FILE     write records to FILE (stdout otherwise; text moves to stderr)\n"
+    "  --baseline=FILE  compare p50 with a previous json/csv run, exit 1 on regression\n"
+    "  --threshold=FRAC allowed p50 slowdown before it counts (default %.2f)\n"
+    "  --threads=N    CPU throughput at 1,2,4..N threads after each shape\n"
+    "  --shared-handle  all threads call one handle (default: one handle per thread)\n"
+    "  --thread-ms=MS measurement window per thread count (default %d)\n"
+    "  --no-pin       leave thread placement to the scheduler\n"
+    "  --pipeline=D   compare serial vs async submission with D requests in flight (GPU)\n"
+    "  --gpu-cache=DIR  persist compiled GPU pipelines in DIR across runs\n"
+    "  --cache-miss, --cache-hit  in-process fresh-handle start to first inference with\n"
+    "                 the shape's cache entry dropped / present (cache dir defaults to %s)\n"
+    "  --model-dir=DIR  JSON-weights vs mmap'd binary model startup (files kept in DIR)\n"
+    "  --ref          parity against the native reference forward (%s), and its speed\n"
+    "  --adapters[=M] spread GPU handles over all adapters, round-robin (rr) or by load;\n"
+    "  --clients=N    client threads for --adapters / --microbatch / --pool / --route\n"
+    "                 (default 2 per adapter / 2×B / 4×N / 4; window = --thread-ms)\n",
+    argv0, g_opt.warmup, g_opt.iters, g_opt.ci, g_opt.max_iters,
+    g_opt.batch_iters, g_opt.threshold, g_opt.thread_ms, DEFAULT_GPU_CACHE,
+    paragon_ref_isa());
+  fprintf(stderr,
+    "  --quant        fp16 / int8 weights vs fp32: latency, weight memory and error\n"
+    "  --microbatch=B one-sample clients direct vs through a micro-batcher of up to B\n"
+    "  --batch-wait-us=T  longest a queued sample waits for its batch (default %d)\n"
+    "  --pool=N       shared handle behind a mutex vs a lock-free pool of N handles vs\n"
+    "                 N work-stealing workers\n"
+    "  --route        calibrated CPU/GPU router vs pinning every call to one backend,\n"
+    "                 per batch size and under mixed-batch clients (default 4)\n"
+    "  --cache=N      N-entry result cache vs plain forwards over a 2N-image gallery,\n"
+    "                 then a PerturbWeights staleness check\n"
+    "  --group=N      N networks of the shape on one input: one by one vs\n"
+    "                 paragon_forward_group, CPU and GPU\n"
+    "  --train[=STEP] training samples/s through paragon_train, STEP rows per step\n"
+    "                 (default %d), CPU and GPU\n"
+    "  --numa[=T]     first-touch vs interleaved vs per-node replicated weights under\n"
+    "                 T node-pinned workers (default one per CPU)\n"
+    "  --determinism[=N]  N random inputs (default 64): CPU vs GPU and rerun parity in\n"
+    "                 ULPs, strict vs fast kernels and their latency when offered\n"
+    "  --budget=MB[:evict]  handles of the shape until a budget of MB (host and device) on\n"
+    "                 top of what is charged refuses them, or evicts the oldest\n"
+    "  --inference    trainable vs inference-only handle: memory (and a --pool of them)\n"
+    "                 and CPU latency\n"
+    "  --lazy         dlopen with RTLD_LAZY (bind functions on first call)\n"
+    "  --prewarm      load, probe and first GPU init on a helper thread\n"
+    "  --trace=FILE   record every bridge call and write a Chrome/Perfetto trace to FILE\n"
+    "  --sweep=AXIS:LO..HI[:P]  instead of S1..XL2, P points (default 8) of width, depth,\n"
+    "                 input or batch: latency, GFLOP/s, GPU/CPU crossover\n"
+    "  --width= --depth= --input= --output= --batch=  the axes the sweep holds fixed\n"
+    "                 (default %d, %d, %d, %d, %d)\n",
+    g_opt.batch_wait_us, g_opt.train_step, g_opt.sweep_width, g_opt.sweep_depth,
+    g_opt.sweep_input, g_opt.sweep_output, g_opt.sweep_batch);
 }
 
 int main(int argc, char** argv){
   const char* so = (argc>1 && argv[1][0]!='-') ? argv[1] : NULL;
 
+  for(int i=1;i<argc;i++){
+    const char* a = argv[i];
+    if(a[0]!='-') continue;
+    if(!strncmp(a,"--warmup=",9))         g_opt.warmup = atoi(a+9);
+    else if(!strncmp(a,"--iters=",8))     g_opt.iters = atoi(a+8);
+    else if(!strcmp(a,"--auto"))          g_opt.autocal = 1;
+    else if(!strncmp(a,"--auto=",7))    { g_opt.autocal = 1; g_opt.ci = atof(a+7); }
+    else if(!strncmp(a,"--max-iters=",12)) g_opt.max_iters = atoi(a+12);
+    else if(!strcmp(a,"--quiet"))         g_opt.quiet = 1;
+    else if(!strncmp(a,"--batch-iters=",14)) g_opt.batch_iters = atoi(a+14);
+    else if(!strncmp(a,"--format=",9))    g_opt.format = a+9;
+    else if(!strncmp(a,"--out=",6))       g_opt.out = a+6;
+    else if(!strncmp(a,"--baseline=",11)) g_opt.baseline = a+11;
+    else if(!strncmp(a,"--threshold=",12)) g_opt.threshold = atof(a+12);
+    else if(!strncmp(a,"--threads=",10))  g_opt.threads = atoi(a+10);
+    else if(!strcmp(a,"--shared-handle")) g_opt.shared_handle = 1;
+    else if(!strncmp(a,"--thread-ms=",12)) g_opt.thread_ms = atoi(a+12);
+    else if(!strcmp(a,"--no-pin"))        g_opt.pin = 0;
+    else if(!strncmp(a,"--pipeline=",11)) g_opt.pipeline = atoi(a+11);
+    else if(!strncmp(a,"--gpu-cache=",12)) g_opt.gpu_cache = a+12;
+    else if(!strcmp(a,"--cache-miss"))    g_opt.start = BENCH_START_MISS;
+    else if(!strcmp(a,"--cache-hit"))     g_opt.start = BENCH_START_HIT;
+    else if(!strncmp(a,"--model-dir=",12)) g_opt.model_dir = a+12;
+    else if(!strcmp(a,"--ref"))           g_opt.ref = 1;
+    else if(!strcmp(a,"--adapters") || !strcmp(a,"--adapters=rr")) g_opt.adapters = BENCH_ADAPTERS_RR;
+    else if(!strcmp(a,"--adapters=load")) g_opt.adapters = BENCH_ADAPTERS_LOAD;
+    else if(!strncmp(a,"--clients=",10))  g_opt.clients = atoi(a+10);
+    else if(!strcmp(a,"--quant"))         g_opt.quant = 1;
+    else if(!strncmp(a,"--microbatch=",13)) g_opt.microbatch = atoi(a+13);
+    else if(!strncmp(a,"--batch-wait-us=",16)) g_opt.batch_wait_us = atoi(a+16);
+    else if(!strncmp(a,"--pool=",7))      g_opt.pool = atoi(a+7);
+    else if(!strcmp(a,"--route"))         g_opt.route = 1;
+    else if(!strncmp(a,"--cache=",8))     g_opt.cache = atoi(a+8);
+    else if(!strncmp(a,"--group=",8))     g_opt.group = atoi(a+8);
+    else if(!strcmp(a,"--train"))         g_opt.train = 1;
+    else if(!strncmp(a,"--train=",8))   { g_opt.train = 1; g_opt.train_step = atoi(a+8); }
+    else if(!strcmp(a,"--numa"))          g_opt.numa = -1;
+    else if(!strncmp(a,"--numa=",7))      g_opt.numa = atoi(a+7)>0 ? atoi(a+7) : -1;
+    else if(!strcmp(a,"--determinism"))   g_opt.determinism = 64;
+    else if(!strncmp(a,"--determinism=",14)) g_opt.determinism = atoi(a+14);
+    else if(!strncmp(a,"--budget=",9))  { g_opt.budget_mb = atof(a+9); g_opt.budget_evict = strstr(a+9, ":evict")!=NULL; }
+    else if(!strcmp(a,"--inference"))     g_opt.inference = 1;
+    else if(!strcmp(a,"--lazy"))          g_opt.lazy = 1;
+    else if(!strcmp(a,"--prewarm"))       g_opt.prewarm = 1;
+    else if(!strncmp(a,"--trace=",8))     g_opt.trace = a+8;
+    else if(!strncmp(a,"--sweep=",8))   { if(!bench_sweep_parse(a+8)) return 2; g_opt.sweep = 1; }
+    else if(!strncmp(a,"--width=",8))     g_opt.sweep_width = atoi(a+8);
+    else if(!strncmp(a,"--depth=",8))     g_opt.sweep_depth = atoi(a+8);
+    else if(!strncmp(a,"--input=",8))     g_opt.sweep_input = atoi(a+8);
+    else if(!strncmp(a,"--output=",9))    g_opt.sweep_output = atoi(a+9);
+    else if(!strncmp(a,"--batch=",8))     g_opt.sweep_batch = atoi(a+8);
+    else { usage(argv[0]); return 2; }
+  }
+  if(g_opt.warmup<0) g_opt.warmup = 0;
+  if(g_opt.iters<1)  g_opt.iters = 1;
+  if(g_opt.thread_ms<1) g_opt.thread_ms = 1;
+  if(g_opt.microbatch<0) g_opt.microbatch = 0;
+  if(g_opt.pool<0) g_opt.pool = 0;
+  if(g_opt.cache<0) g_opt.cache = 0;
+  if(g_opt.group<0) g_opt.group = 0;
+  if(g_opt.train_step<1) g_opt.train_step = 1;
+  if(g_opt.determinism<0) g_opt.determinism = 0;
+  if(g_opt.determinism>4096) g_opt.determinism = 4096;
+  if(g_opt.batch_wait_us<0) g_opt.batch_wait_us = 0;
+  if(g_opt.sweep_width<1 || g_opt.sweep_input<1 || g_opt.sweep_output<1 || g_opt.sweep_batch<1 ||
+     g_opt.sweep_depth<0 || g_opt.sweep_depth>PARAGON_MODEL_MAX_LAYERS-2){
+    usage(argv[0]); return 2;
+  }
+  if(strcmp(g_opt.format,"text") && strcmp(g_opt.format,"json") && strcmp(g_opt.format,"csv")){
+    usage(argv[0]); return 2;
+  }
+  int records = strcmp(g_opt.format,"text") || g_opt.out;
+  if(records && !strcmp(g_opt.format,"text")) g_opt.format = "json";  /* --out alone */
+  g_txt = (records && !g_opt.out) ? stderr : stdout;
+
+  if(g_opt.start && !g_opt.gpu_cache) g_opt.gpu_cache = DEFAULT_GPU_CACHE;
+
   ParagonAPI api;
-  (void)paragon_load(&api, so);
-
-  const int S1[]  = {784,  64, 10};
-  const int S2[]  = {784, 128, 10};
-  const int S3[]  = {784, 256, 10};
-  const int M1[]  = {784, 256, 256, 10};
-  const int M2[]  = {784, 384, 384, 10};
-  const int M3[]  = {784, 512, 512, 10};
-  const int L1[]  = {784, 768, 768, 768, 10};
-  const int L2[]  = {784,1024,1024,1024, 10};
-  const int XL1[] = {784,1536,1536,1536,1536,10};
-  const int XL2[] = {784,2048,2048,2048,2048,10};
-
-  run_one(&api,"S1", S1,  (int)(sizeof(S1)/sizeof(S1[0])));
-  run_one(&api,"S2", S2,  (int)(sizeof(S2)/sizeof(S2[0])));
-  run_one(&api,"S3", S3,  (int)(sizeof(S3)/sizeof(S3[0])));
-  run_one(&api,"M1", M1,  (int)(sizeof(M1)/sizeof(M1[0])));
-  run_one(&api,"M2", M2,  (int)(sizeof(M2)/sizeof(M2[0])));
-  run_one(&api,"M3", M3,  (int)(sizeof(M3)/sizeof(M3[0])));
-  run_one(&api,"L1", L1,  (int)(sizeof(L1)/sizeof(L1[0])));
-  run_one(&api,"L2", L2,  (int)(sizeof(L2)/sizeof(L2[0])));
-  run_one(&api,"XL1",XL1, (int)(sizeof(XL1)/sizeof(XL1[0])));
-  run_one(&api,"XL2",XL2, (int)(sizeof(XL2)/sizeof(XL2[0])));
+  unsigned load_flags = g_opt.lazy ? PARAGON_LOAD_LAZY : 0u;
+  double blocked = 0.0;
+  if(g_opt.prewarm){
+    ParagonPrewarm* pw = paragon_prewarm_start(&api, so, load_flags | PARAGON_LOAD_GPU, g_opt.gpu_cache);
+    (void)paragon_prewarm_wait(pw, &blocked);
+    if(g_opt.gpu_cache && !api.gpu_cache_dir[0]) return 1;
+  } else {
+    (void)paragon_load_ex(&api, so, load_flags);
+    if(g_opt.gpu_cache && !paragon_gpu_cache_open(&api, g_opt.gpu_cache)) return 1;
+  }
+  char caps[512];
+  paragon_caps_string(&api, caps, sizeof(caps));
+  fprintf(g_txt, "Capabilities: %s\n", caps[0] ? caps : "none");
+  bench_load_report(&api, g_opt.prewarm ? &blocked : NULL);
+  if(g_opt.trace && !paragon_trace_start(&api, 0)){ fprintf(stderr, "trace: out of memory\n"); return 1; }
+
+  if(g_opt.sweep) bench_sweep(&api);
+  else {
+    const int S1[]  = {784,  64, 10};
+    const int S2[]  = {784, 128, 10};
+    const int S3[]  = {784, 256, 10};
+    const int M1[]  = {784, 256, 256, 10};
+    const int M2[]  = {784, 384, 384, 10};
+    const int M3[]  = {784, 512, 512, 10};
+    const int L1[]  = {784, 768, 768, 768, 10};
+    const int L2[]  = {784,1024,1024,1024, 10};
+    const int XL1[] = {784,1536,1536,1536,1536,10};
+    const int XL2[] = {784,2048,2048,2048,2048,10};
+
+    run_one(&api,"S1", S1,  (int)(sizeof(S1)/sizeof(S1[0])));
+    run_one(&api,"S2", S2,  (int)(sizeof(S2)/sizeof(S2[0])));
+    run_one(&api,"S3", S3,  (int)(sizeof(S3)/sizeof(S3[0])));
+    run_one(&api,"M1", M1,  (int)(sizeof(M1)/sizeof(M1[0])));
+    run_one(&api,"M2", M2,  (int)(sizeof(M2)/sizeof(M2[0])));
+    run_one(&api,"M3", M3,  (int)(sizeof(M3)/sizeof(M3[0])));
+    run_one(&api,"L1", L1,  (int)(sizeof(L1)/sizeof(L1[0])));
+    run_one(&api,"L2", L2,  (int)(sizeof(L2)/sizeof(L2[0])));
+    run_one(&api,"XL1",XL1, (int)(sizeof(XL1)/sizeof(XL1[0])));
+    run_one(&api,"XL2",XL2, (int)(sizeof(XL2)/sizeof(XL2[0])));
+  }
+
+  if(g_opt.trace) bench_trace_report(&api, g_opt.trace);
+
+  int rc = 0;
+  if(records && !bench_write_records(g_opt.out, g_opt.format)) rc = 1;
+  if(g_opt.baseline){
+    int reg = bench_compare_baseline(g_opt.baseline, g_opt.threshold);
+    if(reg != 0) rc = 1;
+  }
+  bench_records_free();
 
   paragon_unload(&api);
-  return 0;
+  return rc;
 }
@@ -0,0 +1,127 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include "paragon.h"
+
+typedef struct {
+  int    warmup;     /* untimed iterations before measuring */
+  int    iters;      /* measured iterations (minimum when auto) */
+  int    autocal;    /* keep sampling until the CI is tight */
+  double ci;         /* target 95% CI half-width, fraction of mean */
+  int    max_iters;  /* auto-calibration cap */
+  int    quiet;      /* skip raw output vectors */
+  int    batch_iters;/* measured calls per batch size */
+  const char* format;   /* text | json | csv */
+  const char* out;      /* records file (stdout when NULL) */
+  const char* baseline; /* previous json/csv run to compare against */
+  double threshold;     /* allowed p50 regression, fraction */
+  int    threads;       /* >0: multi-threaded CPU throughput up to N threads */
+  int    shared_handle; /* threads share one handle instead of one each */
+  int    thread_ms;     /* measurement window per thread count */
+  int    pin;           /* pin worker i to core i % ncpu */
+  int    pipeline;      /* >0: async submission depth for the pipelined mode */
+  const char* gpu_cache;/* GPU pipeline cache directory (off when NULL) */
+  int    start;         /* BENCH_START_*: time-to-first-inference mode */
+  const char* model_dir;/* binary model files for the load mode (off when NULL) */
+  int    ref;           /* native reference parity + baseline */
+  int    adapters;      /* BENCH_ADAPTERS_*: spread GPU handles over every adapter */
+  int    clients;       /* client threads for the adapters mode (0 = 2 per adapter) */
+  int    quant;         /* fp16/int8 weights vs fp32 */
+  int    microbatch;    /* >0: max batch for the micro-batching mode */
+  int    batch_wait_us; /* micro-batcher window */
+  int    pool;          /* >0: handles in the pool / dispatcher workers */
+  const char* trace;    /* Chrome trace of every bridge call (off when NULL) */
+  int    route;         /* calibrated CPU/GPU router vs pinned backends */
+  int    cache;         /* >0: result-cache entries for the cache mode */
+  int    group;         /* >0: ensemble size for the grouped-forward mode */
+  int    train;         /* training throughput mode */
+  int    train_step;    /* rows per paragon_train step */
+  int    numa;          /* NUMA placement mode; >0 = worker threads */
+  int    determinism;   /* >0: random inputs for the ULP parity / determinism mode */
+  double budget_mb;     /* >0: memory-budget mode, MB on top of what is charged */
+  int    budget_evict;  /* ...evicting LRU handles instead of refusing */
+  int    inference;     /* trainable vs inference-only handles */
+  int    lazy;          /* dlopen with RTLD_LAZY */
+  int    prewarm;       /* load + GPU init on a helper thread */
+  int    sweep;         /* parametric shape sweep instead of S1..XL2 */
+  int    sweep_axis, sweep_lo, sweep_hi, sweep_points;
+  int    sweep_width, sweep_depth, sweep_input, sweep_output, sweep_batch;  /* fixed axes */
+} BenchOpts;
+
+enum { BENCH_START_OFF, BENCH_START_MISS, BENCH_START_HIT };
+enum { BENCH_ADAPTERS_OFF, BENCH_ADAPTERS_RR, BENCH_ADAPTERS_LOAD };
+
+extern BenchOpts g_opt;
+extern FILE*     g_txt;   /* human-readable progress; stderr when records go to stdout */
+
+/* Latency summary over one measured series (milliseconds) */
+typedef struct {
+  int    n;
+  double mean, sd, min, max, p50, p90, p99;
+} Stats;
+
+/* One machine-readable result row: shape × backend × batch */
+typedef struct {
+  char   shape[16];
+  char   dims[96];       /* "784-64-10" */
+  char   backend[16];    /* "cpu" | "gpu" | "gpu-stg" | "gpu-pipe" | "cpu-mt" … */
+  int    batch;
+  int    threads;        /* concurrent callers (1 for the serial records) */
+  Stats  st;             /* ms per call (a call is one batch) */
+  double sps;            /* samples/sec at p50 */
+  double est_mb;
+  double host_mb, device_mb;   /* measured for the shape's handle (-1 = unknown) */
+  double gpu_init_ms;
+  char   adapter[256];   /* raw InitializeOptimizedGPU result */
+  double mae, max_abs;   /* CPU vs GPU parity of the shape */
+  unsigned max_ulp;      /* same, in ULPs */
+  double gflops;         /* 2·batch·Σ in×out at p50 (sweep records; 0 otherwise) */
+  int    failed;         /* calls that returned an error; >0 marks the row failed */
+} BenchRecord;
+
+/* bench.c helpers shared by the mode files */
+double now_ms(void);
+void   fill_lcg(float* x, int n, unsigned seed);
+char*  json_layers(ParagonArena* a, const int* dims, int ndims);
+char*  json_activs(ParagonArena* a, int ndims);
+char*  json_trainable(ParagonArena* a, int ndims);
+void   stats_of(double* v, int n, Stats* st);   /* sorts v in place */
+void   print_stats(const char* label, const Stats* st);
+ParagonHandle bench_new_net(ParagonAPI* api, const int* dims, int ndims);  /* -1 on failure */
+
+/* modes: base carries shape/adapter/parity fields to copy into new records */
+void bench_threads(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_pipeline(ParagonAPI* api, const BenchRecord* base, ParagonHandle h,
+                    const int* dims, int ndims);
+void bench_start(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_model(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_ref(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_adapters(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_quant(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_batcher(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_pool(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_route(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_cache(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_group(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_train(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_numa(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_determinism(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_budget(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_inference(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims);
+void bench_trace_report(ParagonAPI* api, const char* path);   /* export + per-method split */
+void bench_load_report(const ParagonAPI* api, const double* blocked_ms);   /* prewarm when set */
+int  bench_sweep_parse(const char* spec);                      /* fills g_opt.sweep_*, 1 = ok */
+void bench_sweep(ParagonAPI* api);
+
+/* --model-dir (or DEFAULT_MODEL_DIR) file for the shape, written on first use; 1 = ok */
+#define DEFAULT_MODEL_DIR ".paragon-models"
+int  bench_model_file(const BenchRecord* base, const int* dims, int ndims, char* path, size_t n);
+
+void bench_record(const BenchRecord* r);
+int  bench_write_records(const char* path, const char* format);   /* 1 = ok */
+/* regressions (failed rows count as one), -1 when unreadable or nothing matched */
+int  bench_compare_baseline(const char* path, double threshold);
+void bench_records_free(void);
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* Spreads GPU handles over every adapter and drives them from client threads.
+   Each adapter owns `per` handles; a request picks an adapter (round-robin, or the one
+   with the fewest requests in flight), then the first idle handle on it. The single-
+   device baseline sends the same clients to adapter 0's handles only. */
+
+#define MAX_ADAPTERS 16
+#define MAX_LAT      65536
+
+typedef struct {
+  ParagonHandle   h;
+  pthread_mutex_t mu;     /* a handle runs one request at a time */
+} Slot;
+
+typedef struct {
+  ParagonAPI* api;
+  Slot*       slots;      /* slots[k*per + j] */
+  int         per, nad, load;
+  int         inflight[MAX_ADAPTERS];
+  long long   served[MAX_ADAPTERS];
+  const float* x;
+  int         in_dim, out_dim;
+  double      end;
+} Pool;
+
+typedef struct {
+  Pool*     p;
+  int       id;
+  long long count;
+  double*   lat;
+  int       nlat;
+} Client;
+
+static int pick_adapter(Pool* p, Client* c){
+  if(!p->load) return (int)((c->id + c->count) % p->nad);
+  int best = 0, bl = __atomic_load_n(&p->inflight[0], __ATOMIC_RELAXED);
+  for(int k=1; k<p->nad; ++k){
+    int l = __atomic_load_n(&p->inflight[k], __ATOMIC_RELAXED);
+    if(l<bl){ bl = l; best = k; }
+  }
+  return best;
+}
+
+static Slot* acquire(Pool* p, int k, int hint){
+  Slot* s = &p->slots[(size_t)k*p->per];
+  for(int j=0; j<p->per; ++j) if(!pthread_mutex_trylock(&s[j].mu)) return &s[j];
+  Slot* w = &s[hint % p->per];   /* all busy: queue on one */
+  pthread_mutex_lock(&w->mu);
+  return w;
+}
+
+static void* client_main(void* arg){
+  Client* c = (Client*)arg;
+  Pool* p = c->p;
+  float* y = malloc(sizeof(float)*(size_t)p->out_dim);
+  if(!y) exit(1);
+  for(;;){
+    double t0 = now_ms();
+    if(t0>=p->end) break;
+    int k = pick_adapter(p, c);
+    __atomic_add_fetch(&p->inflight[k], 1, __ATOMIC_RELAXED);
+    Slot* s = acquire(p, k, c->id);
+    (void)paragon_forward_f32(p->api, s->h, p->x, 1, p->in_dim);
+    (void)paragon_extract_f32(p->api, s->h, y, p->out_dim);
+    pthread_mutex_unlock(&s->mu);
+    __atomic_sub_fetch(&p->inflight[k], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&p->served[k], 1, __ATOMIC_RELAXED);
+    if(c->nlat<MAX_LAT) c->lat[c->nlat++] = now_ms() - t0;
+    ++c->count;
+  }
+  free(y);
+  return NULL;
+}
+
+/* clients for thread_ms over the first nad adapters; returns inferences/s */
+static double drive(Pool* p, int nad, int clients, Stats* st){
+  p->nad = nad;
+  memset(p->served, 0, sizeof(p->served));
+  Client* cs = calloc((size_t)clients, sizeof(Client));
+  pthread_t* th = calloc((size_t)clients, sizeof(pthread_t));
+  if(!cs || !th) exit(1);
+  p->end = now_ms() + g_opt.thread_ms;
+  double t0 = now_ms();
+  for(int i=0;i<clients;i++){
+    cs[i].p = p; cs[i].id = i;
+    cs[i].lat = malloc(sizeof(double)*MAX_LAT);
+    if(!cs[i].lat) exit(1);
+    pthread_create(&th[i], NULL, client_main, &cs[i]);
+  }
+  long long total = 0; int nlat = 0;
+  for(int i=0;i<clients;i++){ pthread_join(th[i], NULL); total += cs[i].count; nlat += cs[i].nlat; }
+  double dt = now_ms() - t0;
+  double* all = malloc(sizeof(double)*(size_t)(nlat>0?nlat:1));
+  if(!all) exit(1);
+  for(int i=0, o=0;i<clients;i++){ memcpy(all+o, cs[i].lat, sizeof(double)*(size_t)cs[i].nlat); o += cs[i].nlat; free(cs[i].lat); }
+  stats_of(all, nlat, st);
+  free(all); free(cs); free(th);
+  return dt>0 ? total*1000.0/dt : 0.0;
+}
+
+void bench_adapters(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int nad = paragon_adapter_count(api);
+  if(nad>MAX_ADAPTERS) nad = MAX_ADAPTERS;
+  int clients = g_opt.clients>0 ? g_opt.clients : 2*nad;
+  int per = (clients + nad - 1) / nad;
+
+  Pool p; memset(&p, 0, sizeof(p));
+  p.api = api; p.per = per; p.load = g_opt.adapters==BENCH_ADAPTERS_LOAD;
+  p.in_dim = dims[0]; p.out_dim = dims[ndims-1];
+  float* x = malloc(sizeof(float)*(size_t)p.in_dim);
+  p.slots = calloc((size_t)nad*per, sizeof(Slot));
+  if(!x || !p.slots) exit(1);
+  fill_lcg(x, p.in_dim, 123u);
+  p.x = x;
+
+  int bound = 1;
+  for(int k=0; k<nad; ++k) for(int j=0; j<per; ++j){
+    Slot* s = &p.slots[(size_t)k*per + j];
+    pthread_mutex_init(&s->mu, NULL);
+    s->h = bench_new_net(api, dims, ndims);
+    if(s->h<=0){ fprintf(stderr, "adapters: NewNetwork failed\n"); exit(1); }
+    paragon_free_result(api, paragon_init_gpu_on(api, s->h, k));
+    (void)paragon_enable_gpu(api, s->h);
+    paragon_free_result(api, paragon_call_id(api, s->h, PARAGON_M_TOGGLE_GPU, "[]"));
+    ParagonHandleInfo hi;
+    if(!paragon_handle_info(api, s->h, &hi) || hi.adapter!=k) bound = 0;
+  }
+
+  Stats multi_st, single_st;
+  double single = drive(&p, 1, clients, &single_st);
+  double multi  = nad>1 ? drive(&p, nad, clients, &multi_st) : single;
+  if(nad<=1) multi_st = single_st;
+
+  fprintf(g_txt, "Adapters (%d found%s, %s, %d clients, %d handle%s/adapter, %d ms)\n",
+    nad, bound ? "" : ", binding unsupported: library default", p.load ? "by load" : "round-robin",
+    clients, per, per>1 ? "s" : "", g_opt.thread_ms);
+  long long tot = 0;
+  for(int k=0;k<nad;k++) tot += p.served[k];
+  for(int k=0;k<nad;k++){
+    char* info = paragon_adapter_info(api, k);
+    fprintf(g_txt, "  #%d %-40.40s served %lld (%.0f%%)\n", k, info ? info : "default",
+      p.served[k], tot ? 100.0*p.served[k]/tot : 0.0);
+    paragon_free_result(api, info);
+  }
+  fprintf(g_txt, "  all adapters   %11.1f inf/s   p50 %.3f ms   p99 %.3f ms\n", multi, multi_st.p50, multi_st.p99);
+  fprintf(g_txt, "  adapter 0 only %11.1f inf/s   p50 %.3f ms   p99 %.3f ms   scaling %.2fx\n",
+    single, single_st.p50, single_st.p99, single>0 ? multi/single : 0.0);
+
+  BenchRecord rec = *base;
+  rec.batch = 1; rec.threads = clients;
+  snprintf(rec.backend, sizeof(rec.backend), "gpu-single");
+  rec.st = single_st; rec.sps = single;
+  bench_record(&rec);
+  snprintf(rec.backend, sizeof(rec.backend), "gpu-multi");
+  rec.st = multi_st; rec.sps = multi;
+  bench_record(&rec);
+
+  for(int i=0;i<nad*per;i++){ pthread_mutex_destroy(&p.slots[i].mu); (void)paragon_free_handle(api, p.slots[i].h); }
+  free(p.slots); free(x);
+}
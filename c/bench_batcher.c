@@ -0,0 +1,128 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* Service-style load: client threads each send one sample at a time and wait for it.
+   "direct" is what the bindings do today, one forward per request on a shared handle
+   (serialised by a mutex); "batched" routes the same clients through a ParagonBatcher. */
+
+#define MAX_LAT 65536
+
+typedef struct {
+  ParagonAPI*     api;
+  ParagonHandle   h;
+  ParagonBatcher* b;          /* NULL: direct */
+  pthread_mutex_t mu;
+  int             in_dim, out_dim;
+  double          end;
+} Load;
+
+typedef struct {
+  Load*     L;
+  int       id;
+  long long count;
+  double*   lat;
+  int       nlat;
+} Client;
+
+static void* client_main(void* arg){
+  Client* c = (Client*)arg;
+  Load* L = c->L;
+  float* x = malloc(sizeof(float)*(size_t)L->in_dim);
+  float* y = malloc(sizeof(float)*(size_t)L->out_dim);
+  if(!x || !y) exit(1);
+  fill_lcg(x, L->in_dim, 777u + (unsigned)c->id);
+  for(;;){
+    double t0 = now_ms();
+    if(t0>=L->end) break;
+    if(L->b) (void)paragon_batcher_infer(L->b, x, y, L->out_dim);
+    else {
+      pthread_mutex_lock(&L->mu);
+      (void)paragon_forward_f32(L->api, L->h, x, 1, L->in_dim);
+      (void)paragon_extract_f32(L->api, L->h, y, L->out_dim);
+      pthread_mutex_unlock(&L->mu);
+    }
+    if(c->nlat<MAX_LAT) c->lat[c->nlat++] = now_ms() - t0;
+    ++c->count;
+  }
+  free(x); free(y);
+  return NULL;
+}
+
+/* clients for thread_ms; returns requests/s */
+static double drive(Load* L, int clients, Stats* st){
+  Client* cs = calloc((size_t)clients, sizeof(Client));
+  pthread_t* th = calloc((size_t)clients, sizeof(pthread_t));
+  if(!cs || !th) exit(1);
+  L->end = now_ms() + g_opt.thread_ms;
+  double t0 = now_ms();
+  for(int i=0;i<clients;i++){
+    cs[i].L = L; cs[i].id = i;
+    cs[i].lat = malloc(sizeof(double)*MAX_LAT);
+    if(!cs[i].lat) exit(1);
+    pthread_create(&th[i], NULL, client_main, &cs[i]);
+  }
+  long long total = 0; int nlat = 0;
+  for(int i=0;i<clients;i++){ pthread_join(th[i], NULL); total += cs[i].count; nlat += cs[i].nlat; }
+  double dt = now_ms() - t0;
+  double* all = malloc(sizeof(double)*(size_t)(nlat>0?nlat:1));
+  if(!all) exit(1);
+  for(int i=0, o=0;i<clients;i++){ memcpy(all+o, cs[i].lat, sizeof(double)*(size_t)cs[i].nlat); o += cs[i].nlat; free(cs[i].lat); }
+  stats_of(all, nlat, st);
+  free(all); free(cs); free(th);
+  return dt>0 ? total*1000.0/dt : 0.0;
+}
+
+static void run_backend(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims,
+                        int gpu, int clients){
+  ParagonHandle h = bench_new_net(api, dims, ndims);
+  if(h<=0){ fprintf(stderr, "microbatch: NewNetwork failed\n"); return; }
+  if(gpu){
+    paragon_free_result(api, paragon_init_gpu(api, h));
+    (void)paragon_enable_gpu(api, h);
+    paragon_free_result(api, paragon_call_id(api, h, PARAGON_M_TOGGLE_GPU, "[]"));
+  }
+  Load L; memset(&L, 0, sizeof(L));
+  L.api = api; L.h = h; L.in_dim = dims[0]; L.out_dim = dims[ndims-1];
+  pthread_mutex_init(&L.mu, NULL);
+
+  Stats dst, bst;
+  double direct = drive(&L, clients, &dst);
+  L.b = paragon_batcher_new(api, h, L.in_dim, L.out_dim, g_opt.microbatch, g_opt.batch_wait_us, 0);
+  if(!L.b){ fprintf(stderr, "microbatch: paragon_batcher_new failed\n"); pthread_mutex_destroy(&L.mu); return; }
+  double batched = drive(&L, clients, &bst);
+  ParagonBatcherStats bs;
+  paragon_batcher_stats(L.b, &bs);
+  paragon_batcher_free(L.b);
+  pthread_mutex_destroy(&L.mu);
+
+  const char* be = gpu ? "GPU" : "CPU";
+  fprintf(g_txt, "  %s direct  %11.1f req/s   p50 %.3f ms   p99 %.3f ms\n", be, direct, dst.p50, dst.p99);
+  fprintf(g_txt, "  %s batched %11.1f req/s   p50 %.3f ms   p99 %.3f ms   gain %.2fx   mean batch %.1f (%lld full, %lld by wait)\n",
+    be, batched, bst.p50, bst.p99, direct>0 ? batched/direct : 0.0, bs.mean_batch, bs.full, bs.timed_out);
+
+  BenchRecord rec = *base;
+  rec.threads = clients;
+  rec.batch = 1;
+  snprintf(rec.backend, sizeof(rec.backend), "%s-direct", gpu ? "gpu" : "cpu");
+  rec.st = dst; rec.sps = direct;
+  bench_record(&rec);
+  rec.batch = g_opt.microbatch;
+  snprintf(rec.backend, sizeof(rec.backend), "%s-mbatch", gpu ? "gpu" : "cpu");
+  rec.st = bst; rec.sps = batched;
+  bench_record(&rec);
+}
+
+void bench_batcher(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int clients = g_opt.clients>0 ? g_opt.clients : 2*g_opt.microbatch;
+  fprintf(g_txt, "Micro-batching (max batch %d, max wait %d us, %d clients, %d ms, %s)\n",
+    g_opt.microbatch, g_opt.batch_wait_us, clients, g_opt.thread_ms,
+    api->ForwardBatch_F32 ? "batched forward" : "per-row forward");
+  run_backend(api, base, dims, ndims, 0, clients);
+  run_backend(api, base, dims, ndims, 1, clients);
+}
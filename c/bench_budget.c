@@ -0,0 +1,80 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* --budget=MB[:evict]: MB of host and of device memory on top of what earlier handles
+   already hold; handles of the shape are made and moved to the GPU until the budget
+   refuses one. With :evict the run goes on to twice the expected count, so the oldest
+   handles are freed to make room and a forward on the first one must fail. Each
+   record sample is one create + GPU init. */
+
+#define MAX_HANDLES 4096
+
+void bench_budget(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  const double MBb = 1024.0*1024.0;
+  int policy = g_opt.budget_evict ? PARAGON_BUDGET_EVICT : PARAGON_BUDGET_REFUSE;
+  long long lim = (long long)(g_opt.budget_mb * MBb);
+  ParagonArena ar; paragon_arena_init(&ar, 1024);
+  long long est_host, est_device;
+  paragon_mem_estimate(json_layers(&ar, dims, ndims), &est_host, &est_device);
+  paragon_arena_free(&ar);
+  long long per = est_host>est_device ? est_host : est_device;
+  if(per>lim){
+    fprintf(g_txt, "Budget %.1f MB: one handle needs an estimated %.2f MB, nothing to measure\n",
+      g_opt.budget_mb, per/MBb);
+    return;
+  }
+  int expect = per>0 ? (int)(lim / per) : 0;
+  int cap = policy==PARAGON_BUDGET_EVICT ? 2*expect + 2 : expect + 8;
+  if(cap>MAX_HANDLES) cap = MAX_HANDLES;
+
+  ParagonMemUsage u0; paragon_mem_usage(api, &u0);
+  paragon_mem_budget(api, u0.host_bytes + lim, u0.device_bytes + lim, policy);
+  ParagonHandle* hs = calloc((size_t)cap, sizeof(ParagonHandle));
+  double* v = malloc(sizeof(double)*(size_t)cap);
+  if(!hs || !v) exit(1);
+  int made = 0;
+  for(int i=0;i<cap;i++){
+    ParagonMemUsage ui; paragon_mem_usage(api, &ui);
+    double t0 = now_ms();
+    ParagonHandle h = bench_new_net(api, dims, ndims);
+    if(h<=0) break;
+    paragon_free_result(api, paragon_init_gpu(api, h));
+    ParagonMemUsage uo; paragon_mem_usage(api, &uo);
+    if(uo.refused!=ui.refused){ (void)paragon_free_handle(api, h); break; }  /* device side said no */
+    (void)paragon_enable_gpu(api, h);
+    v[made] = now_ms() - t0;
+    hs[made++] = h;
+  }
+  ParagonMemUsage u; paragon_mem_usage(api, &u);
+  fprintf(g_txt, "Budget %.1f MB host + device (%s), %.2f MB estimated per handle:\n",
+    g_opt.budget_mb, policy==PARAGON_BUDGET_EVICT ? (api->FreeNetwork ? "evict" : "evict unsupported, refusing") : "refuse",
+    per/MBb);
+  fprintf(g_txt, "  %d handles admitted (estimate says %d), %lld refused, %lld evicted; charged %.2f MB host %.2f MB device over the start\n",
+    made, expect, u.refused - u0.refused, u.evicted - u0.evicted,
+    (u.host_bytes - u0.host_bytes)/MBb, (u.device_bytes - u0.device_bytes)/MBb);
+  if(made && u.evicted>u0.evicted){
+    float* xs = calloc((size_t)dims[0], sizeof(float));
+    int ok = xs && paragon_forward_f32(api, hs[0], xs, 1, dims[0]);
+    fprintf(g_txt, "  forward on the first (evicted) handle %s\n", ok ? "still ran: eviction did not release it" : "refused, as it should");
+    free(xs);
+  }
+  paragon_mem_budget(api, 0, 0, PARAGON_BUDGET_REFUSE);
+  for(int i=0;i<made;i++) (void)paragon_free_handle(api, hs[i]);   /* no-op without FreeNetwork */
+
+  if(made>0){
+    BenchRecord rec = *base;
+    rec.batch = 1; rec.threads = 1;
+    snprintf(rec.backend, sizeof(rec.backend), "budget-%s", policy==PARAGON_BUDGET_EVICT ? "evict" : "refuse");
+    stats_of(v, made, &rec.st);
+    rec.sps = rec.st.p50>0 ? 1000.0/rec.st.p50 : 0.0;
+    rec.host_mb = (u.host_bytes - u0.host_bytes)/MBb;
+    rec.device_mb = (u.device_bytes - u0.device_bytes)/MBb;
+    bench_record(&rec);
+  }
+  free(hs); free(v);
+}
@@ -0,0 +1,99 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* --cache=N: a gallery of 2N distinct inputs is requested with a skew towards the first
+   ones (the way a fixed image set gets re-served), for --thread-ms each, straight through
+   paragon_forward_f32 and then through an N-entry ParagonCache. Afterwards the weights are
+   perturbed and a pass over the gallery checks every cached answer against a fresh
+   forward, so a stale entry would show up as a mismatch. */
+
+#define MAX_LAT 65536
+
+/* request k → gallery index; squaring a uniform draw favours low indices */
+static int pick(unsigned* s, int n){
+  *s = *s*1664525u + 1013904223u;
+  double u = (*s>>8)/16777216.0;
+  int i = (int)(u*u*n);
+  return i<n ? i : n-1;
+}
+
+static void serve(ParagonAPI* api, ParagonCache* c, ParagonHandle h, const float* G, int ng,
+                  int in_dim, float* y, int out_dim, Stats* st, double* rps){
+  double* lat = malloc(sizeof(double)*MAX_LAT);
+  if(!lat) exit(1);
+  unsigned s = 77u;
+  long long count = 0; int nlat = 0;
+  double t0 = now_ms(), end = t0 + g_opt.thread_ms;
+  for(;;){
+    double t = now_ms();
+    if(t>=end) break;
+    const float* x = G + (size_t)pick(&s, ng)*in_dim;
+    if(c) (void)paragon_cache_forward(c, h, x, in_dim, y, out_dim);
+    else if(paragon_forward_f32(api, h, x, 1, in_dim)) (void)paragon_extract_f32(api, h, y, out_dim);
+    if(nlat<MAX_LAT) lat[nlat++] = now_ms() - t;
+    ++count;
+  }
+  double dt = now_ms() - t0;
+  stats_of(lat, nlat, st);
+  free(lat);
+  *rps = dt>0 ? count*1000.0/dt : 0.0;
+}
+
+void bench_cache(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int in_dim = dims[0], out_dim = dims[ndims-1];
+  int cap = g_opt.cache, ng = 2*cap;
+  ParagonHandle h = bench_new_net(api, dims, ndims);
+  if(h<=0){ fprintf(stderr, "cache: NewNetwork failed\n"); return; }
+  ParagonCache* c = paragon_cache_new(api, cap, in_dim, out_dim);
+  float* G = malloc(sizeof(float)*(size_t)ng*in_dim);
+  float* y = malloc(sizeof(float)*(size_t)out_dim);
+  float* ref = malloc(sizeof(float)*(size_t)out_dim);
+  if(!c || !G || !y || !ref){ fprintf(stderr, "cache: out of memory\n"); exit(1); }
+  for(int i=0;i<ng;i++) fill_lcg(G+(size_t)i*in_dim, in_dim, 4242u+(unsigned)i);
+
+  Stats st[2]; double rps[2];
+  serve(api, NULL, h, G, ng, in_dim, y, out_dim, &st[0], &rps[0]);
+  serve(api, c, h, G, ng, in_dim, y, out_dim, &st[1], &rps[1]);
+  ParagonCacheStats cs;
+  paragon_cache_stats(c, &cs);
+
+  /* weights change: every gallery entry must come back as a fresh forward would */
+  int ok = paragon_perturb_weights(api, h, "[0.1, 42]");
+  long long inv0 = cs.invalidated;
+  int stale = 0, checked = 0;
+  for(int i=0;i<ng && i<cap;i++){
+    const float* x = G + (size_t)i*in_dim;
+    int n = paragon_cache_forward(c, h, x, in_dim, y, out_dim);
+    if(!paragon_forward_f32(api, h, x, 1, in_dim)) continue;
+    int m = paragon_extract_f32(api, h, ref, out_dim);
+    if(n!=m || (n>0 && memcmp(y, ref, sizeof(float)*(size_t)n))) ++stale;
+    ++checked;
+  }
+  ParagonCacheStats after;
+  paragon_cache_stats(c, &after);
+
+  fprintf(g_txt, "Result cache (%d entries, gallery %d, %d ms each)\n", cap, ng, g_opt.thread_ms);
+  fprintf(g_txt, "  uncached %10.1f req/s   p50 %.4f ms   p99 %.4f ms\n", rps[0], st[0].p50, st[0].p99);
+  fprintf(g_txt, "  cached   %10.1f req/s   p50 %.4f ms   p99 %.4f ms   %.2fx\n",
+    rps[1], st[1].p50, st[1].p99, rps[0]>0 ? rps[1]/rps[0] : 0.0);
+  fprintf(g_txt, "  hits %lld  misses %lld  hit rate %.1f%%  evictions %lld\n",
+    cs.hits, cs.misses, 100.0*cs.hit_rate, cs.evictions);
+  fprintf(g_txt, "  PerturbWeights%s: %lld entries invalidated, %d/%d mismatches vs fresh forward\n",
+    ok ? "" : " failed (version bumped anyway)", after.invalidated - inv0, stale, checked);
+  if(stale) fprintf(stderr, "cache: %d stale results served after a weight change\n", stale);
+
+  BenchRecord rec = *base;
+  rec.batch = 1; rec.threads = 1;
+  for(int k=0;k<2;k++){
+    snprintf(rec.backend, sizeof(rec.backend), "%s", k ? "cpu-cache" : "cpu-nocache");
+    rec.st = st[k]; rec.sps = rps[k];
+    bench_record(&rec);
+  }
+  free(G); free(y); free(ref);
+  paragon_cache_free(c);
+}
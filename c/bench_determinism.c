@@ -0,0 +1,109 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* --determinism[=N]: N random inputs per shape through one handle, on CPU and then GPU,
+   compared element by element in ULPs: CPU against GPU, and each backend against a
+   rerun of itself. When the library offers SetDeterministic, every step runs once with
+   reproducible kernels (strict) and once without (fast), and the batch-1 latency of each
+   is what strict reproducibility costs. Without the knob there is one "default" mode. */
+
+#define DET_TOL 4   /* ulp an element may be off by and still count as close */
+
+static void time_one(ParagonAPI* api, ParagonHandle h, const float* X, int n, int in_dim,
+                     float* y, int out_dim, Stats* st){
+  double* v = malloc(sizeof(double)*(size_t)g_opt.iters);
+  if(!v) exit(1);
+  for(int i=0;i<g_opt.warmup + g_opt.iters;i++){
+    const float* x = X + (size_t)(i % n)*in_dim;
+    double t0 = now_ms();
+    if(paragon_forward_f32(api, h, x, 1, in_dim)) (void)paragon_extract_f32(api, h, y, out_dim);
+    if(i>=g_opt.warmup) v[i-g_opt.warmup] = now_ms() - t0;
+  }
+  stats_of(v, g_opt.iters, st);
+  free(v);
+}
+
+static void hist_str(const ParagonParity* p, char* out, size_t cap){
+  size_t w = 0;
+  for(int k=0;k<PARAGON_ULP_BUCKETS && w<cap;k++)
+    w += (size_t)snprintf(out+w, cap-w, k ? "/%lld" : "%lld", p->hist[k]);
+}
+
+void bench_determinism(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int n = g_opt.determinism, in_dim = dims[0], out_dim = dims[ndims-1];
+  size_t ny = (size_t)n*out_dim;
+  float* X = malloc(sizeof(float)*(size_t)n*in_dim);
+  float* Y[2][2];
+  float* R = malloc(sizeof(float)*ny);
+  float* y = malloc(sizeof(float)*(size_t)out_dim);
+  if(!X || !R || !y) exit(1);
+  for(int m=0;m<2;m++)
+    for(int d=0;d<2;d++){ Y[m][d] = calloc(ny, sizeof(float)); if(!Y[m][d]) exit(1); }
+  for(int r=0;r<n;r++) fill_lcg(X + (size_t)r*in_dim, in_dim, 5150u + (unsigned)r);
+
+  ParagonHandle h = bench_new_net(api, dims, ndims);
+  if(h<=0){ fprintf(stderr, "determinism: NewNetwork failed\n"); goto out; }
+  int knob = paragon_set_deterministic(api, h, 1);
+  if(knob<0) fprintf(stderr, "determinism: library refused SetDeterministic, measuring its default\n");
+  int nmodes = knob==1 ? 2 : 1;
+  static const char* MODE[2] = { "strict", "fast" };
+
+  Stats st[2][2];
+  ParagonParity rerun[2][2];
+  for(int d=0; d<2; d++){
+    if(d){
+      paragon_free_result(api, paragon_init_gpu(api, h));
+      (void)paragon_enable_gpu(api, h);
+      paragon_free_result(api, paragon_call_id(api, h, PARAGON_M_TOGGLE_GPU, "[]"));
+    }
+    for(int m=0; m<nmodes; m++){
+      if(nmodes>1) (void)paragon_set_deterministic(api, h, m==0);
+      (void)paragon_forward_batch(api, h, X, n, in_dim, Y[m][d], out_dim);
+      (void)paragon_forward_batch(api, h, X, n, in_dim, R, out_dim);
+      paragon_parity_reset(&rerun[m][d]);
+      paragon_parity_add(&rerun[m][d], Y[m][d], R, (long long)ny, 0);
+      time_one(api, h, X, n, in_dim, y, out_dim, &st[m][d]);
+    }
+  }
+
+  fprintf(g_txt, "Determinism (%d inputs × %d outputs, %s)\n", n, out_dim,
+    api->SetDeterministic ? "SetDeterministic export" :
+    nmodes>1 ? "SetDeterministic method" : "no determinism knob in library");
+  BenchRecord rec = *base;
+  rec.batch = 1; rec.threads = 1;
+  for(int m=0; m<nmodes; m++){
+    ParagonParity x; paragon_parity_reset(&x);
+    paragon_parity_add(&x, Y[m][0], Y[m][1], (long long)ny, DET_TOL);
+    char hist[160]; hist_str(&x, hist, sizeof(hist));
+    fprintf(g_txt, "  %-7s CPU p50 %.3f ms   GPU p50 %.3f ms   CPU↔GPU %lld/%lld bit-identical, "
+      "%lld within %d ulp, max %u ulp (mae %.2E)   rerun max CPU %u GPU %u ulp\n",
+      nmodes>1 ? MODE[m] : "default", st[m][0].p50, st[m][1].p50, x.exact, x.n,
+      x.within, DET_TOL, x.max_ulp, x.mae, rerun[m][0].max_ulp, rerun[m][1].max_ulp);
+    fprintf(g_txt, "          ulp histogram 0/1/2-3/4-15/16-255/256+: %s\n", hist);
+    for(int d=0; d<2; d++){
+      snprintf(rec.backend, sizeof(rec.backend), "%s-%s", d ? "gpu" : "cpu", nmodes>1 ? MODE[m] : "default");
+      rec.st = st[m][d];
+      rec.sps = st[m][d].p50>0 ? 1000.0/st[m][d].p50 : 0.0;
+      rec.mae = x.mae; rec.max_abs = x.max_abs; rec.max_ulp = x.max_ulp;
+      bench_record(&rec);
+    }
+  }
+  if(nmodes>1){
+    ParagonParity drift[2];
+    for(int d=0; d<2; d++){
+      paragon_parity_reset(&drift[d]);
+      paragon_parity_add(&drift[d], Y[0][d], Y[1][d], (long long)ny, DET_TOL);
+    }
+    fprintf(g_txt, "  strict costs CPU %.2fx  GPU %.2fx   fast drifts from strict by max CPU %u GPU %u ulp\n",
+      st[1][0].p50>0 ? st[0][0].p50/st[1][0].p50 : 0.0, st[1][1].p50>0 ? st[0][1].p50/st[1][1].p50 : 0.0,
+      drift[0].max_ulp, drift[1].max_ulp);
+  }
+out:
+  for(int m=0;m<2;m++) for(int d=0;d<2;d++) free(Y[m][d]);
+  free(X); free(R); free(y);
+}
@@ -0,0 +1,82 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* --group=N: an ensemble of N networks of the shape evaluated on one sample, first one
+   handle after another (forward + extract each), then with one paragon_forward_group,
+   on CPU and again after every handle moved to the GPU. Both orders must give the same
+   outputs; the records count model evaluations per second. */
+
+static void seq(ParagonAPI* api, const ParagonHandle* hs, int n, const float* x, int dim,
+                float* const* outs, int out_dim){
+  for(int i=0;i<n;i++)
+    if(paragon_forward_f32(api, hs[i], x, 1, dim)) (void)paragon_extract_f32(api, hs[i], outs[i], out_dim);
+}
+
+static void time_mode(ParagonAPI* api, int group, const ParagonHandle* hs, int n, const float* x,
+                      int dim, float* const* outs, const int* caps, Stats* st){
+  int iters = g_opt.iters;
+  double* v = malloc(sizeof(double)*(size_t)iters);
+  if(!v) exit(1);
+  for(int i=0;i<g_opt.warmup + iters;i++){
+    double t0 = now_ms();
+    if(group) (void)paragon_forward_group(api, hs, n, x, dim, outs, caps, NULL);
+    else      seq(api, hs, n, x, dim, outs, caps[0]);
+    if(i>=g_opt.warmup) v[i-g_opt.warmup] = now_ms() - t0;
+  }
+  stats_of(v, iters, st);
+  free(v);
+}
+
+void bench_group(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int n = g_opt.group, in_dim = dims[0], out_dim = dims[ndims-1];
+  ParagonHandle* hs = calloc((size_t)n, sizeof(ParagonHandle));
+  float** outs = calloc((size_t)n, sizeof(float*));
+  float** ref  = calloc((size_t)n, sizeof(float*));
+  int* caps = malloc(sizeof(int)*(size_t)n);
+  float* x = malloc(sizeof(float)*(size_t)in_dim);
+  if(!hs || !outs || !ref || !caps || !x) exit(1);
+  for(int i=0;i<n;i++){
+    hs[i] = bench_new_net(api, dims, ndims);
+    outs[i] = calloc((size_t)out_dim, sizeof(float));
+    ref[i]  = calloc((size_t)out_dim, sizeof(float));
+    caps[i] = out_dim;
+    if(hs[i]<=0 || !outs[i] || !ref[i]){ fprintf(stderr, "group: NewNetwork failed for member %d\n", i); goto out; }
+  }
+  fill_lcg(x, in_dim, 31337u);
+
+  BenchRecord rec = *base;
+  rec.batch = 1; rec.threads = 1;
+  fprintf(g_txt, "Ensemble of %d (%s):\n", n, (api->caps & PARAGON_CAP_GROUP) ? "fused ForwardGroup" : "forwards issued together");
+  for(int g=0; g<2; g++){
+    if(g){
+      for(int i=0;i<n;i++){
+        paragon_free_result(api, paragon_init_gpu(api, hs[i]));
+        (void)paragon_enable_gpu(api, hs[i]);
+        paragon_free_result(api, paragon_call_id(api, hs[i], PARAGON_M_TOGGLE_GPU, "[]"));
+      }
+    }
+    Stats st[2];
+    time_mode(api, 0, hs, n, x, in_dim, ref, caps, &st[0]);
+    time_mode(api, 1, hs, n, x, in_dim, outs, caps, &st[1]);
+    double max_abs = 0.0;
+    for(int i=0;i<n;i++)
+      for(int k=0;k<out_dim;k++){ double d = fabs((double)outs[i][k] - ref[i][k]); if(d>max_abs) max_abs = d; }
+    fprintf(g_txt, "  %s  one by one p50 %.3f ms   grouped p50 %.3f ms   %.2fx   max|Δ| %.3g\n",
+      g ? "GPU" : "CPU", st[0].p50, st[1].p50, st[1].p50>0 ? st[0].p50/st[1].p50 : 0.0, max_abs);
+    for(int k=0;k<2;k++){
+      snprintf(rec.backend, sizeof(rec.backend), "%s-%s", g ? "gpu" : "cpu", k ? "group" : "seq");
+      rec.st = st[k];
+      rec.sps = st[k].p50>0 ? n*1000.0/st[k].p50 : 0.0;
+      bench_record(&rec);
+    }
+  }
+out:
+  for(int i=0;i<n;i++){ free(outs[i]); free(ref[i]); }
+  free(hs); free(outs); free(ref); free(caps); free(x);
+}
@@ -0,0 +1,68 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* --inference: the shape built the usual way (every layer trainable) next to a
+   PARAGON_NEW_INFERENCE handle. Memory is what each handle is charged (MemoryInfo when
+   the library reports it, the layout estimate otherwise), scaled to a pool of --pool
+   handles (default 8); latency is batch-1 forward + extract on the CPU. */
+
+static void time_cpu(ParagonAPI* api, ParagonHandle h, const float* x, int in_dim, int out_dim, Stats* st){
+  double* v = malloc(sizeof(double)*(size_t)g_opt.iters);
+  float* y = malloc(sizeof(float)*(size_t)out_dim);
+  if(!v || !y) exit(1);
+  for(int i=0;i<g_opt.warmup + g_opt.iters;i++){
+    double t0 = now_ms();
+    if(paragon_forward_f32(api, h, x, 1, in_dim)) (void)paragon_extract_f32(api, h, y, out_dim);
+    if(i>=g_opt.warmup) v[i-g_opt.warmup] = now_ms() - t0;
+  }
+  stats_of(v, g_opt.iters, st);
+  free(v); free(y);
+}
+
+void bench_inference(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  const double MBb = 1024.0*1024.0;
+  int in_dim = dims[0], out_dim = dims[ndims-1], pool = g_opt.pool>0 ? g_opt.pool : 8;
+  ParagonArena ar; paragon_arena_init(&ar, 1024);
+  char* layers = json_layers(&ar, dims, ndims);
+  char* activs = json_activs(&ar, ndims);
+  ParagonHandle hs[2];
+  hs[0] = bench_new_net(api, dims, ndims);
+  hs[1] = paragon_new_handle_ex(api, layers, activs, NULL, false, false, PARAGON_NEW_INFERENCE);
+  paragon_arena_free(&ar);
+  if(hs[0]<=0 || hs[1]<=0){ fprintf(stderr, "inference: NewNetwork failed\n"); return; }
+  float* x = malloc(sizeof(float)*(size_t)in_dim);
+  if(!x) exit(1);
+  fill_lcg(x, in_dim, 4242u);
+
+  ParagonHandleInfo hi;
+  int lean = paragon_handle_info(api, hs[1], &hi) && (hi.flags & PARAGON_HF_INFERENCE);
+  fprintf(g_txt, "Inference-only handles (%s):\n",
+    lean ? "library dropped training state" : "no SetInferenceOnly in library, layers only frozen");
+  BenchRecord rec = *base;
+  rec.batch = 1; rec.threads = 1;
+  double mb[2] = {0, 0}, p50[2] = {0, 0};
+  for(int k=0;k<2;k++){
+    ParagonMemInfo mi;
+    if(!paragon_handle_memory(api, hs[k], &mi)) memset(&mi, 0, sizeof(mi));
+    Stats st; time_cpu(api, hs[k], x, in_dim, out_dim, &st);
+    mb[k] = mi.charged_host/MBb; p50[k] = st.p50;
+    fprintf(g_txt, "  %-10s host %.3f MB (%s, estimate %.3f MB)   pool of %d %.2f MB   CPU p50 %.3f ms\n",
+      k ? "inference" : "trainable", mb[k], mi.from_library ? "MemoryInfo" : "charged",
+      mi.est_host/MBb, pool, pool*mb[k], st.p50);
+    snprintf(rec.backend, sizeof(rec.backend), "cpu-%s", k ? "inference" : "trainable");
+    rec.st = st;
+    rec.sps = st.p50>0 ? 1000.0/st.p50 : 0.0;
+    rec.host_mb = mb[k];
+    rec.device_mb = mi.from_library && mi.device_bytes>=0 ? mi.device_bytes/MBb : -1.0;
+    bench_record(&rec);
+  }
+  fprintf(g_txt, "  inference-only saves %.1f%% host memory, latency %.2fx\n",
+    mb[0]>0 ? 100.0*(mb[0]-mb[1])/mb[0] : 0.0, p50[0]>0 ? p50[1]/p50[0] : 0.0);
+  for(int k=0;k<2;k++) (void)paragon_free_handle(api, hs[k]);
+  free(x);
+}
@@ -0,0 +1,147 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "bench.h"
+
+/* Startup from weights: decoding them from JSON text (what a JSON model file costs)
+   against mapping a binary model file. Each shape's file is written once to
+   --model-dir with deterministic weights and reused by later runs. Both routes put
+   the same weights into the handle through SetLayerWeights_F32; without it only the
+   binary route is timed. */
+
+#define MAX_REPS 20
+
+static const char* HOW[] = { "shape only", "copied", "zero-copy" };
+
+static int write_shape_model(const char* path, const int* dims, int ndims){
+  const float* W[PARAGON_MODEL_MAX_LAYERS-1];
+  const float* B[PARAGON_MODEL_MAX_LAYERS-1];
+  float* blocks[2*(PARAGON_MODEL_MAX_LAYERS-1)] = {0};
+  int ok = 1;
+  for(int l=0; l+1<ndims && ok; ++l){
+    size_t nw = (size_t)dims[l]*dims[l+1];
+    float* w = malloc(sizeof(float)*nw);
+    float* b = malloc(sizeof(float)*(size_t)dims[l+1]);
+    blocks[2*l] = w; blocks[2*l+1] = b;
+    if(!w || !b){ ok = 0; break; }
+    fill_lcg(w, (int)nw, 1000u + (unsigned)l);
+    for(size_t i=0;i<nw;i++) w[i] = (w[i] - 0.5f) * 0.1f;
+    fill_lcg(b, dims[l+1], 2000u + (unsigned)l);
+    for(int i=0;i<dims[l+1];i++) b[i] = (b[i] - 0.5f) * 0.01f;
+    W[l] = w; B[l] = b;
+  }
+  if(ok) ok = paragon_model_write(path, ndims, dims, NULL, NULL, W, B);
+  for(int i=0;i<2*(ndims-1);i++) free(blocks[i]);
+  return ok;
+}
+
+/* the text a JSON model dump carries for these weights (%.9g, like the bridge sends) */
+static char* weights_as_json(const ParagonModel* m, size_t* len){
+  size_t n = 0;
+  for(int l=0; l+1<m->nlayers; ++l) n += (size_t)m->dims[l]*m->dims[l+1] + m->dims[l+1];
+  size_t cap = n*16 + 16, p = 0;
+  char* s = malloc(cap);
+  if(!s) exit(1);
+  s[p++] = '[';
+  for(int l=0; l+1<m->nlayers; ++l){
+    size_t nw = (size_t)m->dims[l]*m->dims[l+1];
+    for(size_t i=0;i<nw;i++) p += (size_t)snprintf(s+p, cap-p, p>1?",%.9g":"%.9g", (double)m->W[l][i]);
+    for(int i=0;i<m->dims[l+1];i++) p += (size_t)snprintf(s+p, cap-p, ",%.9g", (double)m->B[l][i]);
+  }
+  s[p++] = ']'; s[p] = 0;
+  *len = n;
+  return s;
+}
+
+int bench_model_file(const BenchRecord* base, const int* dims, int ndims,
+                     char* path, size_t n){
+  snprintf(path, n, "%s/%s.pmdl", g_opt.model_dir ? g_opt.model_dir : DEFAULT_MODEL_DIR, base->shape);
+  struct stat sb;
+  if(!stat(path, &sb)) return 1;
+  (void)mkdir(g_opt.model_dir ? g_opt.model_dir : DEFAULT_MODEL_DIR, 0755);
+  if(!write_shape_model(path, dims, ndims) || stat(path, &sb)){
+    fprintf(stderr, "model: cannot create %s\n", path);
+    return 0;
+  }
+  return 1;
+}
+
+void bench_model(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  char path[600];
+  struct stat sb;
+  if(!bench_model_file(base, dims, ndims, path, sizeof(path)) || stat(path, &sb)) return;
+  int reps = g_opt.iters < 3 ? 3 : (g_opt.iters > MAX_REPS ? MAX_REPS : g_opt.iters);
+  double t_map[MAX_REPS], t_json[MAX_REPS];
+  double s_open = 0, s_new = 0;
+  int how = PARAGON_MODEL_SHAPE_ONLY;
+
+  /* JSON text route: parse every weight back from decimal text, build the net and copy
+     the decoded layers in, the same work the binary copy route does from the mapping */
+  ParagonModel m;
+  if(!paragon_model_open(&m, path)) return;
+  int json_ok = api->SetLayerWeights!=NULL;
+  size_t txt_bytes = 0;
+  if(json_ok){
+    size_t nw;
+    char* txt = weights_as_json(&m, &nw);
+    txt_bytes = strlen(txt);
+    float* dec = malloc(sizeof(float)*nw);
+    if(!dec) exit(1);
+    for(int i=0;i<reps && json_ok;i++){
+      double t0 = now_ms();
+      json_ok = paragon_parse_floats(txt, dec, (int)nw)==(int)nw;
+      ParagonHandle h = bench_new_net(api, dims, ndims);
+      json_ok = json_ok && h>0;
+      const float* w = dec;
+      for(int l=0; json_ok && l+1<ndims; ++l){
+        long long n_w = (long long)dims[l]*dims[l+1], n_b = dims[l+1];
+        json_ok = !api->SetLayerWeights(h, l, w, n_w, w + n_w, n_b);
+        w += n_w + n_b;
+      }
+      if(json_ok) paragon_weights_changed(api, h);
+      t_json[i] = now_ms() - t0;
+      if(h>0) (void)paragon_free_handle(api, h);
+    }
+    if(!json_ok) fprintf(stderr, "model: JSON weights route failed; reporting the binary route only\n");
+    free(dec); free(txt);
+  }
+  paragon_model_close(&m);
+
+  /* binary route: map + construct */
+  for(int i=0;i<reps;i++){
+    double t0 = now_ms();
+    if(!paragon_model_open(&m, path)) return;
+    double t1 = now_ms();
+    ParagonHandle h = paragon_new_from_model(api, &m, false, &how);
+    double t2 = now_ms();
+    t_map[i] = t2 - t0;
+    s_open += t1 - t0; s_new += t2 - t1;
+    /* a zero-copy library may read the mapping for the handle's lifetime: keep it if the
+       handle cannot be freed */
+    if(h<=0 || paragon_free_handle(api, h) || how!=PARAGON_MODEL_ZERO_COPY) paragon_model_close(&m);
+  }
+
+  BenchRecord rj = *base, rm = *base;
+  stats_of(t_map, reps, &rm.st);
+  fprintf(g_txt, "Model load (%.1f MB file, %d starts)\n", (double)sb.st_size/(1024.0*1024.0), reps);
+  if(json_ok){
+    stats_of(t_json, reps, &rj.st);
+    fprintf(g_txt, "  json weights   p50 %9.3f ms   (%.1f MB of text, copied)\n",
+      rj.st.p50, txt_bytes/(1024.0*1024.0));
+  }
+  fprintf(g_txt, "  mmap model     p50 %9.3f ms   (open %.3f, create %.3f, weights %s)",
+    rm.st.p50, s_open/reps, s_new/reps, HOW[how]);
+  if(json_ok && how!=PARAGON_MODEL_SHAPE_ONLY && rm.st.p50>0) fprintf(g_txt, "   %.1fx", rj.st.p50/rm.st.p50);
+  fprintf(g_txt, "\n");
+
+  rj.batch = rm.batch = 1; rj.threads = rm.threads = 1;
+  snprintf(rj.backend, sizeof(rj.backend), "load-json");
+  snprintf(rm.backend, sizeof(rm.backend), "load-mmap");
+  rj.sps = rm.sps = 0.0;
+  if(json_ok) bench_record(&rj);
+  bench_record(&rm);
+}
@@ -0,0 +1,105 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+
+/* --numa[=T]: T worker threads, worker i pinned to node i % nodes, each serving single
+   samples through ParagonReplicas for --thread-ms, once per placement. Every placement
+   has the same number of handles (one per worker), so the rows differ only in where the
+   weights live relative to the threads reading them. */
+
+#define MAX_LAT 65536
+
+typedef struct {
+  ParagonReplicas* r;
+  int              in_dim, out_dim;
+  double           end;
+} Load;
+
+typedef struct {
+  Load*     L;
+  int       id, node;
+  long long count;
+  double*   lat;
+  int       nlat;
+} Worker;
+
+static void* worker_main(void* arg){
+  Worker* w = (Worker*)arg;
+  Load* L = w->L;
+  (void)paragon_numa_pin(w->node);
+  float* x = malloc(sizeof(float)*(size_t)L->in_dim);
+  float* y = malloc(sizeof(float)*(size_t)L->out_dim);
+  if(!x || !y) exit(1);
+  fill_lcg(x, L->in_dim, 8080u + (unsigned)w->id);
+  for(;;){
+    double t0 = now_ms();
+    if(t0>=L->end) break;
+    (void)paragon_replicas_forward(L->r, x, L->in_dim, y, L->out_dim);
+    if(w->nlat<MAX_LAT) w->lat[w->nlat++] = now_ms() - t0;
+    ++w->count;
+  }
+  free(x); free(y);
+  return NULL;
+}
+
+void bench_numa(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int nodes = paragon_numa_nodes();
+  long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+  int T = g_opt.numa>0 ? g_opt.numa : (ncpu>1 ? (int)ncpu : 2);
+  int per_node = (T + nodes - 1) / nodes;
+  ParagonArena ar; paragon_arena_init(&ar, 1024);
+  char* layers = json_layers(&ar, dims, ndims);
+  char* activs = json_activs(&ar, ndims);
+  char* fully  = json_trainable(&ar, ndims);
+  double wmb = 0.0;
+  for(int i=0;i<ndims-1;i++) wmb += 4.0*((double)dims[i]*dims[i+1] + dims[i+1]);
+  wmb /= 1024.0*1024.0;
+
+  fprintf(g_txt, "NUMA placement (%d node%s, %d workers, %.1f MB weights per handle%s)\n",
+    nodes, nodes>1 ? "s" : "", T, wmb, nodes>1 ? "" : "; one node, placements coincide");
+  Worker* ws = calloc((size_t)T, sizeof(Worker));
+  pthread_t* th = calloc((size_t)T, sizeof(pthread_t));
+  if(!ws || !th) exit(1);
+  BenchRecord rec = *base;
+  rec.batch = 1; rec.threads = T;
+  static const int PLACES[] = { PARAGON_PLACE_FIRST_TOUCH, PARAGON_PLACE_INTERLEAVE, PARAGON_PLACE_REPLICATE };
+  for(int p=0;p<3;p++){
+    double tb = now_ms();
+    ParagonReplicas* r = paragon_replicas_new(api, layers, activs, fully, per_node, PLACES[p]);
+    double build_ms = now_ms() - tb;
+    if(!r){ fprintf(stderr, "numa: %s placement failed\n", paragon_place_name(PLACES[p])); continue; }
+    Load L = { r, dims[0], dims[ndims-1], 0.0 };
+    L.end = now_ms() + g_opt.thread_ms;
+    double t0 = now_ms();
+    for(int i=0;i<T;i++){
+      memset(&ws[i], 0, sizeof(ws[i]));
+      ws[i].L = &L; ws[i].id = i; ws[i].node = i % nodes;
+      ws[i].lat = malloc(sizeof(double)*MAX_LAT);
+      if(!ws[i].lat) exit(1);
+      pthread_create(&th[i], NULL, worker_main, &ws[i]);
+    }
+    long long total = 0; int nlat = 0;
+    for(int i=0;i<T;i++){ pthread_join(th[i], NULL); total += ws[i].count; nlat += ws[i].nlat; }
+    double dt = now_ms() - t0;
+    double* all = malloc(sizeof(double)*(size_t)(nlat>0?nlat:1));
+    if(!all) exit(1);
+    for(int i=0, o=0;i<T;i++){ memcpy(all+o, ws[i].lat, sizeof(double)*(size_t)ws[i].nlat); o += ws[i].nlat; free(ws[i].lat); }
+    Stats st; stats_of(all, nlat, &st);
+    free(all);
+    double rps = dt>0 ? total*1000.0/dt : 0.0;
+    fprintf(g_txt, "  %-12s %10.1f req/s   p50 %.3f ms   p99 %.3f ms   weights read %.2f GB/s   (built in %.1f ms)\n",
+      paragon_place_name(PLACES[p]), rps, st.p50, st.p99, rps*wmb/1024.0, build_ms);
+    snprintf(rec.backend, sizeof(rec.backend), "cpu-%s", paragon_place_name(PLACES[p]));
+    rec.st = st; rec.sps = rps;
+    bench_record(&rec);
+    paragon_replicas_free(r);
+  }
+  free(ws); free(th);
+  paragon_arena_free(&ar);
+}
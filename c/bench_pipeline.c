@@ -0,0 +1,88 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* Host-side work per request: what a service does before the forward (decode/normalize).
+   fill_lcg stands in for it so both modes pay the same preprocessing cost. */
+static void preprocess(float* x, int n, int i){
+  fill_lcg(x, n, 123u + (unsigned)i);
+  for(int k=0;k<n;k++) x[k] = (x[k] - 0.5f) * 2.0f;
+}
+
+/* completion time, or -1 for a request that failed; 0 = never completed */
+static void on_done(ParagonTicket t, int status, float* y, void* user){
+  (void)t; (void)y;
+  *(double*)user = status<0 ? -1.0 : now_ms();
+}
+
+void bench_pipeline(ParagonAPI* api, const BenchRecord* base, ParagonHandle h,
+                    const int* dims, int ndims){
+  int in_dim = dims[0], out_dim = dims[ndims-1], depth = g_opt.pipeline;
+  int m = g_opt.iters*8 < 64 ? 64 : g_opt.iters*8;
+  float* x  = malloc(sizeof(float)*(size_t)in_dim);
+  float* y  = malloc(sizeof(float)*(size_t)out_dim*depth);
+  double* t_sub  = malloc(sizeof(double)*(size_t)m);
+  double* t_done = calloc((size_t)m, sizeof(double));
+  double* lat    = malloc(sizeof(double)*(size_t)m);
+  ParagonTicket* tk = malloc(sizeof(ParagonTicket)*(size_t)m);
+  if(!x || !y || !t_sub || !t_done || !lat || !tk) exit(1);
+
+  /* serial: preprocess, forward, extract, repeat */
+  int serial_fail = 0;
+  double s0 = now_ms();
+  for(int i=0;i<m;i++){
+    double t0 = now_ms();
+    preprocess(x, in_dim, i);
+    if(!paragon_forward_f32(api, h, x, 1, in_dim) || paragon_extract_f32(api, h, y, out_dim)<0) ++serial_fail;
+    lat[i] = now_ms() - t0;
+  }
+  double serial_ms = now_ms() - s0;
+  Stats serial_st; stats_of(lat, m, &serial_st);
+
+  /* pipelined: request i+1 is preprocessed while i is in flight */
+  ParagonAsync* q = paragon_async_new(api, h, depth, in_dim);
+  if(!q){ fprintf(stderr, "pipeline: paragon_async_new failed\n"); goto out; }
+  double p0 = now_ms();
+  for(int i=0;i<m;i++){
+    t_sub[i] = now_ms();
+    preprocess(x, in_dim, i);
+    if(i>=depth && tk[i-depth]>=0) (void)paragon_async_wait(q, tk[i-depth]);
+    tk[i] = paragon_async_submit(q, x, 1, in_dim, y + (size_t)(i%depth)*out_dim,
+                                 out_dim, on_done, &t_done[i]);
+  }
+  for(int i=(m>depth?m-depth:0); i<m; i++) if(tk[i]>=0) (void)paragon_async_wait(q, tk[i]);
+  double pipe_ms = now_ms() - p0;
+  paragon_async_free(q);
+  /* failed submits and failed forwards stay out of the latency distribution */
+  int nlat = 0, pipe_fail = 0;
+  for(int i=0;i<m;i++){
+    if(tk[i]<0 || t_done[i]<=0){ ++pipe_fail; continue; }
+    lat[nlat++] = t_done[i] - t_sub[i];
+  }
+  Stats pipe_st; stats_of(lat, nlat, &pipe_st);
+
+  double serial_rps = serial_ms>0 ? (m-serial_fail)*1000.0/serial_ms : 0.0;
+  double pipe_rps   = pipe_ms>0   ? nlat*1000.0/pipe_ms : 0.0;
+  fprintf(g_txt, "Pipeline (depth %d, %d requests, preprocess+forward+extract)\n", depth, m);
+  fprintf(g_txt, "  serial     %10.1f req/s   p50 %.3f ms\n", serial_rps, serial_st.p50);
+  fprintf(g_txt, "  pipelined  %10.1f req/s   p50 %.3f ms   gain %.2fx\n",
+    pipe_rps, pipe_st.p50, serial_rps>0 ? pipe_rps/serial_rps : 0.0);
+  if(serial_fail || pipe_fail)
+    fprintf(g_txt, "  FAILED requests: serial %d/%d, pipelined %d/%d\n", serial_fail, m, pipe_fail, m);
+
+  BenchRecord rec = *base;
+  rec.batch = 1; rec.threads = 1;
+  snprintf(rec.backend, sizeof(rec.backend), "gpu-serial");
+  rec.st = serial_st; rec.sps = serial_rps; rec.failed = serial_fail;
+  bench_record(&rec);
+  snprintf(rec.backend, sizeof(rec.backend), "gpu-pipe");
+  rec.st = pipe_st; rec.sps = pipe_rps; rec.failed = pipe_fail;
+  bench_record(&rec);
+
+out:
+  free(x); free(y); free(t_sub); free(t_done); free(lat); free(tk);
+}
@@ -0,0 +1,155 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* Threaded-server shapes of the same work, one sample per request:
+   mutex    one handle behind a pthread mutex (what wrapping ParagonAPI looks like today)
+   pool     each client checks a handle out of the lock-free pool and calls it directly
+   steal    clients hand jobs to the work-stealing dispatcher and wait for them
+   Latency is per request as the client sees it; the mutex row also reports how long
+   clients spent waiting for the lock. */
+
+#define MAX_LAT 65536
+
+enum { MODE_MUTEX, MODE_POOL, MODE_STEAL };
+
+typedef struct {
+  ParagonAPI*      api;
+  int              mode;
+  ParagonHandle    h;
+  pthread_mutex_t  mu;
+  ParagonPool*     pool;
+  ParagonDispatch* disp;
+  int              in_dim, out_dim;
+  double           end;
+} Load;
+
+typedef struct {
+  Load*     L;
+  int       id;
+  long long count;
+  double    lock_ms;
+  double*   lat;
+  int       nlat;
+} Client;
+
+static void* client_main(void* arg){
+  Client* c = (Client*)arg;
+  Load* L = c->L;
+  float* x = malloc(sizeof(float)*(size_t)L->in_dim);
+  float* y = malloc(sizeof(float)*(size_t)L->out_dim);
+  if(!x || !y) exit(1);
+  fill_lcg(x, L->in_dim, 555u + (unsigned)c->id);
+  ParagonJob job; memset(&job, 0, sizeof(job));
+  job.x = x; job.y = y; job.out_cap = L->out_dim;
+  for(;;){
+    double t0 = now_ms();
+    if(t0>=L->end) break;
+    if(L->mode==MODE_MUTEX){
+      pthread_mutex_lock(&L->mu);
+      c->lock_ms += now_ms() - t0;
+      (void)paragon_forward_f32(L->api, L->h, x, 1, L->in_dim);
+      (void)paragon_extract_f32(L->api, L->h, y, L->out_dim);
+      pthread_mutex_unlock(&L->mu);
+    } else if(L->mode==MODE_POOL){
+      ParagonHandle h = paragon_pool_acquire(L->pool);
+      (void)paragon_forward_f32(L->api, h, x, 1, L->in_dim);
+      (void)paragon_extract_f32(L->api, h, y, L->out_dim);
+      paragon_pool_release(L->pool, h);
+    } else {
+      if(paragon_dispatch_submit(L->disp, &job)) (void)paragon_job_wait(&job);
+    }
+    if(c->nlat<MAX_LAT) c->lat[c->nlat++] = now_ms() - t0;
+    ++c->count;
+  }
+  free(x); free(y);
+  return NULL;
+}
+
+/* clients for thread_ms; returns requests/s, *lock_ms = mean lock wait per request */
+static double drive(Load* L, int clients, Stats* st, double* lock_ms){
+  Client* cs = calloc((size_t)clients, sizeof(Client));
+  pthread_t* th = calloc((size_t)clients, sizeof(pthread_t));
+  if(!cs || !th) exit(1);
+  L->end = now_ms() + g_opt.thread_ms;
+  double t0 = now_ms();
+  for(int i=0;i<clients;i++){
+    cs[i].L = L; cs[i].id = i;
+    cs[i].lat = malloc(sizeof(double)*MAX_LAT);
+    if(!cs[i].lat) exit(1);
+    pthread_create(&th[i], NULL, client_main, &cs[i]);
+  }
+  long long total = 0; int nlat = 0; double lock = 0.0;
+  for(int i=0;i<clients;i++){
+    pthread_join(th[i], NULL);
+    total += cs[i].count; nlat += cs[i].nlat; lock += cs[i].lock_ms;
+  }
+  double dt = now_ms() - t0;
+  double* all = malloc(sizeof(double)*(size_t)(nlat>0?nlat:1));
+  if(!all) exit(1);
+  for(int i=0, o=0;i<clients;i++){ memcpy(all+o, cs[i].lat, sizeof(double)*(size_t)cs[i].nlat); o += cs[i].nlat; free(cs[i].lat); }
+  stats_of(all, nlat, st);
+  free(all); free(cs); free(th);
+  if(lock_ms) *lock_ms = total ? lock/total : 0.0;
+  return dt>0 ? total*1000.0/dt : 0.0;
+}
+
+void bench_pool(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int n = g_opt.pool, clients = g_opt.clients>0 ? g_opt.clients : 4*n;
+  ParagonArena ar; paragon_arena_init(&ar, 1024);
+  char* layers = json_layers(&ar, dims, ndims);
+  char* activs = json_activs(&ar, ndims);
+  char* fully  = json_trainable(&ar, ndims);
+  double t0 = now_ms();
+  ParagonPool* pool = paragon_pool_new(api, layers, activs, fully, n, 0);
+  double t_pool = now_ms() - t0;
+  paragon_arena_free(&ar);
+  if(!pool){ fprintf(stderr, "pool: paragon_pool_new failed\n"); return; }
+
+  Load L; memset(&L, 0, sizeof(L));
+  L.api = api; L.pool = pool; L.in_dim = dims[0]; L.out_dim = dims[ndims-1];
+  pthread_mutex_init(&L.mu, NULL);
+  L.h = paragon_pool_acquire(pool);     /* the mutex row uses one pooled handle */
+
+  Stats st[3]; double rps[3], lock_ms = 0.0;
+  L.mode = MODE_MUTEX; rps[0] = drive(&L, clients, &st[0], &lock_ms);
+  paragon_pool_release(pool, L.h);
+  L.mode = MODE_POOL;  rps[1] = drive(&L, clients, &st[1], NULL);
+  long long ran = 0, stolen = 0;
+  L.disp = paragon_dispatch_new(pool, n, 0);
+  int steal = L.disp!=NULL;
+  if(steal){
+    L.mode = MODE_STEAL; rps[2] = drive(&L, clients, &st[2], NULL);
+    paragon_dispatch_stats(L.disp, &ran, &stolen);
+    paragon_dispatch_free(L.disp);
+  } else {
+    fprintf(stderr, "pool: paragon_dispatch_new failed\n");
+    rps[2] = 0.0; memset(&st[2], 0, sizeof(st[2]));
+  }
+  pthread_mutex_destroy(&L.mu);
+
+  fprintf(g_txt, "Handle pool (%d handles warmed in %.1f ms, %d clients, %d ms)\n",
+    n, t_pool, clients, g_opt.thread_ms);
+  fprintf(g_txt, "  mutex  %11.1f req/s   p50 %.3f ms   p99 %.3f ms   lock wait %.3f ms/req\n",
+    rps[0], st[0].p50, st[0].p99, lock_ms);
+  fprintf(g_txt, "  pool   %11.1f req/s   p50 %.3f ms   p99 %.3f ms   %.2fx\n",
+    rps[1], st[1].p50, st[1].p99, rps[0]>0 ? rps[1]/rps[0] : 0.0);
+  if(steal)
+    fprintf(g_txt, "  steal  %11.1f req/s   p50 %.3f ms   p99 %.3f ms   %.2fx   %d workers, %.0f%% stolen\n",
+      rps[2], st[2].p50, st[2].p99, rps[0]>0 ? rps[2]/rps[0] : 0.0, n, ran ? 100.0*stolen/ran : 0.0);
+
+  static const char* NAMES[3] = { "cpu-mutex", "cpu-pool", "cpu-steal" };
+  BenchRecord rec = *base;
+  rec.batch = 1; rec.threads = clients;
+  for(int k=0;k<(steal ? 3 : 2);k++){
+    snprintf(rec.backend, sizeof(rec.backend), "%s", NAMES[k]);
+    rec.st = st[k]; rec.sps = rps[k];
+    bench_record(&rec);
+  }
+  paragon_pool_free(pool);
+}
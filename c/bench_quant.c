@@ -0,0 +1,148 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* fp32 vs quantized weights for the shape's model file. Native rows run the bridge's
+   own kernels (paragon_ref_forward / paragon_qref_forward); library rows build a handle
+   from the same weights. Error is measured against the fp32 output of the same side,
+   so library rows show what quantization costs there, not library-vs-native drift. */
+
+#define Q_BATCH 64
+
+static const struct { int dtype, acc; } VARIANTS[] = {
+  { PARAGON_Q_F16,  PARAGON_QACC_F32 },
+  { PARAGON_Q_INT8, PARAGON_QACC_NATIVE },
+  { PARAGON_Q_INT8, PARAGON_QACC_F32 },
+};
+#define NVARIANTS ((int)(sizeof(VARIANTS)/sizeof(VARIANTS[0])))
+
+typedef int (*fwd_fn)(const void* model, const float* X, int n, float* Y, int cap);
+static int fwd_ref(const void* m, const float* X, int n, float* Y, int cap){
+  return paragon_ref_forward((const ParagonModel*)m, X, n, Y, cap);
+}
+static int fwd_q(const void* q, const float* X, int n, float* Y, int cap){
+  return paragon_qref_forward((const ParagonQModel*)q, X, n, Y, cap);
+}
+
+static void time_native(fwd_fn f, const void* model, const float* X, int n, float* Y, int cap,
+                        int iters, Stats* st){
+  double* t = malloc(sizeof(double)*(size_t)iters);
+  if(!t) exit(1);
+  for(int i=0;i<g_opt.warmup;i++) (void)f(model, X, n, Y, cap);
+  for(int i=0;i<iters;i++){
+    double t0 = now_ms();
+    (void)f(model, X, n, Y, cap);
+    t[i] = now_ms() - t0;
+  }
+  stats_of(t, iters, st);
+  free(t);
+}
+
+static void time_lib(ParagonAPI* api, ParagonHandle h, const float* X, int dim,
+                     float* Y, int out, Stats* st){
+  double* t = malloc(sizeof(double)*(size_t)g_opt.iters);
+  if(!t) exit(1);
+  for(int i=0;i<g_opt.warmup;i++) (void)paragon_forward_batch(api, h, X, 1, dim, Y, out);
+  for(int i=0;i<g_opt.iters;i++){
+    double t0 = now_ms();
+    (void)paragon_forward_batch(api, h, X, 1, dim, Y, out);
+    t[i] = now_ms() - t0;
+  }
+  stats_of(t, g_opt.iters, st);
+  free(t);
+}
+
+static void diff(const float* a, const float* b, int n, double* mae, double* mx){
+  *mae = 0.0; *mx = 0.0;
+  for(int i=0;i<n;i++){ double d = fabs((double)a[i]-(double)b[i]); *mae += d; if(d>*mx) *mx = d; }
+  if(n>0) *mae /= n;
+}
+
+static void record(const BenchRecord* base, const char* side, const char* type, int batch,
+                   const Stats* st, double mb, double mae, double mx){
+  BenchRecord rec = *base;
+  rec.threads = 1; rec.batch = batch; rec.st = *st;
+  rec.sps = st->p50>0 ? batch*1000.0/st->p50 : 0.0;
+  rec.est_mb = mb; rec.mae = mae; rec.max_abs = mx;
+  snprintf(rec.backend, sizeof(rec.backend), "%s-%s", side, type);
+  bench_record(&rec);
+}
+
+void bench_quant(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  char path[600];
+  if(!bench_model_file(base, dims, ndims, path, sizeof(path))) return;
+  ParagonModel m;
+  if(!paragon_model_open(&m, path)) return;
+  int in = dims[0], out = dims[ndims-1], cap = Q_BATCH*out;
+  float* X   = malloc(sizeof(float)*(size_t)Q_BATCH*in);
+  float* Y32 = malloc(sizeof(float)*(size_t)cap);
+  float* Yq  = malloc(sizeof(float)*(size_t)cap);
+  float* L32 = malloc(sizeof(float)*(size_t)cap);
+  float* Lq  = malloc(sizeof(float)*(size_t)cap);
+  if(!X || !Y32 || !Yq || !L32 || !Lq) exit(1);
+  for(int r=0;r<Q_BATCH;r++) fill_lcg(X + (size_t)r*in, in, 321u + (unsigned)r);
+
+  double mb32 = 0.0;
+  for(int l=0; l+1<m.nlayers; ++l) mb32 += 4.0*((double)m.dims[l]*m.dims[l+1] + m.dims[l+1]);
+  mb32 /= 1024.0*1024.0;
+
+  Stats n1, n64, l1;
+  (void)paragon_ref_forward(&m, X, Q_BATCH, Y32, cap);
+  time_native(fwd_ref, &m, X, 1, Yq, cap, g_opt.iters, &n1);
+  time_native(fwd_ref, &m, X, Q_BATCH, Yq, cap, g_opt.batch_iters, &n64);
+
+  int how32 = PARAGON_MODEL_SHAPE_ONLY;
+  ParagonHandle h32 = paragon_new_from_model(api, &m, false, &how32);
+  int lib = h32>0 && how32!=PARAGON_MODEL_SHAPE_ONLY &&
+            paragon_forward_batch(api, h32, X, Q_BATCH, in, L32, out)==Q_BATCH;
+  if(lib) time_lib(api, h32, X, in, Lq, out, &l1);
+
+  fprintf(g_txt, "Quantized (native %s, library %s)\n", paragon_ref_isa(),
+    !lib ? "n/a: cannot take model weights" : api->SetLayerWeightsQ ? "quantized weights" : "fp32 copies of rounded weights");
+  fprintf(g_txt, "  type         weights MB  native p50  b%d samples/s   mae vs fp32  max abs   library p50  mae vs fp32\n", Q_BATCH);
+  fprintf(g_txt, "  %-11s %11.2f %9.3f ms %14.1f %12s %9s", "fp32", mb32, n1.p50,
+    n64.p50>0 ? Q_BATCH*1000.0/n64.p50 : 0.0, "-", "-");
+  if(lib) fprintf(g_txt, " %9.3f ms %12s", l1.p50, "-");
+  fprintf(g_txt, "\n");
+  record(base, "ref", "fp32", 1, &n1, mb32, 0.0, 0.0);
+  record(base, "ref", "fp32", Q_BATCH, &n64, mb32, 0.0, 0.0);
+
+  for(int v=0; v<NVARIANTS; ++v){
+    ParagonQModel q;
+    if(!paragon_quantize(&q, &m, VARIANTS[v].dtype, VARIANTS[v].acc)) continue;
+    const char* name = paragon_qtype_name(q.dtype, q.acc);
+    double mb = (double)q.bytes/(1024.0*1024.0), mae, mx;
+    Stats q1, q64;
+    (void)paragon_qref_forward(&q, X, Q_BATCH, Yq, cap);
+    diff(Yq, Y32, cap, &mae, &mx);
+    time_native(fwd_q, &q, X, 1, Yq, cap, g_opt.iters, &q1);
+    time_native(fwd_q, &q, X, Q_BATCH, Yq, cap, g_opt.batch_iters, &q64);
+    fprintf(g_txt, "  %-11s %11.2f %9.3f ms %14.1f %12.2E %9.2E", name, mb, q1.p50,
+      q64.p50>0 ? Q_BATCH*1000.0/q64.p50 : 0.0, mae, mx);
+    record(base, "ref", name, 1, &q1, mb, mae, mx);
+    record(base, "ref", name, Q_BATCH, &q64, mb, mae, mx);
+
+    int how = PARAGON_MODEL_SHAPE_ONLY;
+    ParagonHandle hq = lib ? paragon_new_quantized(api, &m, &q, false, &how) : -1;
+    if(hq>0 && how!=PARAGON_MODEL_SHAPE_ONLY &&
+       paragon_forward_batch(api, hq, X, Q_BATCH, in, Lq, out)==Q_BATCH){
+      double lmae, lmx;
+      diff(Lq, L32, cap, &lmae, &lmx);
+      Stats lq;
+      time_lib(api, hq, X, in, Lq, out, &lq);
+      fprintf(g_txt, " %9.3f ms %12.2E", lq.p50, lmae);
+      record(base, "lib", name, 1, &lq, how==PARAGON_MODEL_QUANTIZED ? mb : mb32, lmae, lmx);
+    }
+    fprintf(g_txt, "\n");
+    paragon_qmodel_free(&q);
+  }
+
+  free(X); free(Y32); free(Yq); free(L32); free(Lq);
+  /* a zero-copy library may read the mapping for the handle's lifetime */
+  if(h32<=0 || how32!=PARAGON_MODEL_ZERO_COPY) paragon_model_close(&m);
+}
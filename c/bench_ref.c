@@ -0,0 +1,117 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* Ground truth and native baseline: the shape's model file runs through the bridge's
+   own vectorized forward and through a library handle built from the same weights.
+   Parity is only meaningful when the library took the weights (copied or zero-copy). */
+
+#define REF_BATCH 64
+
+static void diff(const float* a, const float* b, int n, double* mae, double* mx){
+  *mae = 0.0; *mx = 0.0;
+  for(int i=0;i<n;i++){ double d = fabs((double)a[i]-(double)b[i]); *mae += d; if(d>*mx) *mx = d; }
+  if(n>0) *mae /= n;
+}
+
+static void time_ref(const ParagonModel* m, const float* X, int n, float* Y, int cap,
+                     int iters, Stats* st){
+  double* t = malloc(sizeof(double)*(size_t)iters);
+  if(!t) exit(1);
+  for(int i=0;i<g_opt.warmup;i++) (void)paragon_ref_forward(m, X, n, Y, cap);
+  for(int i=0;i<iters;i++){
+    double t0 = now_ms();
+    (void)paragon_ref_forward(m, X, n, Y, cap);
+    t[i] = now_ms() - t0;
+  }
+  stats_of(t, iters, st);
+  free(t);
+}
+
+static void time_lib(ParagonAPI* api, ParagonHandle h, const float* X, int n, int dim,
+                     float* Y, int out, int iters, Stats* st){
+  double* t = malloc(sizeof(double)*(size_t)iters);
+  if(!t) exit(1);
+  for(int i=0;i<g_opt.warmup;i++) (void)paragon_forward_batch(api, h, X, n, dim, Y, out);
+  for(int i=0;i<iters;i++){
+    double t0 = now_ms();
+    (void)paragon_forward_batch(api, h, X, n, dim, Y, out);
+    t[i] = now_ms() - t0;
+  }
+  stats_of(t, iters, st);
+  free(t);
+}
+
+void bench_ref(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  char path[600];
+  if(!bench_model_file(base, dims, ndims, path, sizeof(path))) return;
+  ParagonModel m;
+  if(!paragon_model_open(&m, path)) return;
+  int in = dims[0], out = dims[ndims-1];
+  float* X  = malloc(sizeof(float)*(size_t)REF_BATCH*in);
+  float* Yr = malloc(sizeof(float)*(size_t)REF_BATCH*out);
+  float* Yl = malloc(sizeof(float)*(size_t)REF_BATCH*out);
+  if(!X || !Yr || !Yl) exit(1);
+  for(int r=0;r<REF_BATCH;r++) fill_lcg(X + (size_t)r*in, in, 123u + (unsigned)r);
+
+  int how = PARAGON_MODEL_SHAPE_ONLY;
+  ParagonHandle h = paragon_new_from_model(api, &m, false, &how);
+  int bi = g_opt.batch_iters;
+
+  Stats ref1, ref64, lib1, lib64;
+  time_ref(&m, X, 1, Yr, REF_BATCH*out, g_opt.iters, &ref1);
+  time_ref(&m, X, REF_BATCH, Yr, REF_BATCH*out, bi, &ref64);
+  memset(&lib1, 0, sizeof(lib1)); memset(&lib64, 0, sizeof(lib64));
+  double cpu_mae = 0, cpu_mx = 0, gpu_mae = 0, gpu_mx = 0;
+  int gpu_ok = 0;
+  if(h>0){
+    time_lib(api, h, X, 1, in, Yl, out, g_opt.iters, &lib1);
+    time_lib(api, h, X, REF_BATCH, in, Yl, out, bi, &lib64);
+    if(how!=PARAGON_MODEL_SHAPE_ONLY){
+      /* Yr holds the batch from time_ref; compare the whole batch */
+      if(paragon_forward_batch(api, h, X, REF_BATCH, in, Yl, out)==REF_BATCH)
+        diff(Yl, Yr, REF_BATCH*out, &cpu_mae, &cpu_mx);
+      paragon_free_result(api, paragon_init_gpu(api, h));
+      (void)paragon_enable_gpu(api, h);
+      paragon_free_result(api, paragon_call_id(api, h, PARAGON_M_TOGGLE_GPU, "[]"));
+      if(paragon_forward_batch(api, h, X, REF_BATCH, in, Yl, out)==REF_BATCH){
+        diff(Yl, Yr, REF_BATCH*out, &gpu_mae, &gpu_mx);
+        gpu_ok = 1;
+      }
+    }
+  }
+
+  double ref_sps = ref64.p50>0 ? REF_BATCH*1000.0/ref64.p50 : 0.0;
+  double lib_sps = lib64.p50>0 ? REF_BATCH*1000.0/lib64.p50 : 0.0;
+  fprintf(g_txt, "Reference (%s, library weights %s)\n", paragon_ref_isa(),
+    h>0 ? (how==PARAGON_MODEL_ZERO_COPY ? "zero-copy" : how==PARAGON_MODEL_COPIED ? "copied" : "not loaded") : "n/a");
+  fprintf(g_txt, "  native   p50 %8.3f ms   batch %d %12.1f samples/s\n", ref1.p50, REF_BATCH, ref_sps);
+  if(h>0)
+    fprintf(g_txt, "  library  p50 %8.3f ms   batch %d %12.1f samples/s   %.2fx native time\n",
+      lib1.p50, REF_BATCH, lib_sps, ref1.p50>0 ? lib1.p50/ref1.p50 : 0.0);
+  if(h>0 && how!=PARAGON_MODEL_SHAPE_ONLY){
+    fprintf(g_txt, "  parity   CPU vs ref mae=%.2E max=%.2E", cpu_mae, cpu_mx);
+    if(gpu_ok) fprintf(g_txt, "   GPU vs ref mae=%.2E max=%.2E", gpu_mae, gpu_mx);
+    fprintf(g_txt, "\n");
+  } else {
+    fprintf(g_txt, "  parity   n/a (library cannot take model weights)\n");
+  }
+
+  BenchRecord rec = *base;
+  rec.threads = 1;
+  rec.mae = cpu_mae; rec.max_abs = cpu_mx;
+  snprintf(rec.backend, sizeof(rec.backend), "ref");
+  rec.batch = 1; rec.st = ref1; rec.sps = ref1.p50>0 ? 1000.0/ref1.p50 : 0.0;
+  bench_record(&rec);
+  rec.batch = REF_BATCH; rec.st = ref64; rec.sps = ref_sps;
+  bench_record(&rec);
+
+  free(X); free(Yr); free(Yl);
+  /* a zero-copy library may read the mapping for the handle's lifetime */
+  if(h<=0 || how!=PARAGON_MODEL_ZERO_COPY) paragon_model_close(&m);
+}
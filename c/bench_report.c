@@ -0,0 +1,213 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+static BenchRecord* g_recs = NULL;
+static int g_nrecs = 0, g_caprecs = 0;
+
+void bench_record(const BenchRecord* r){
+  if(g_nrecs == g_caprecs){
+    g_caprecs = g_caprecs ? g_caprecs*2 : 64;
+    g_recs = (BenchRecord*)realloc(g_recs, sizeof(BenchRecord)*(size_t)g_caprecs);
+    if(!g_recs) exit(1);
+  }
+  g_recs[g_nrecs++] = *r;
+}
+
+void bench_records_free(void){
+  free(g_recs); g_recs = NULL; g_nrecs = g_caprecs = 0;
+}
+
+static void put_json_str(FILE* f, const char* s){
+  fputc('"', f);
+  for(; *s; ++s){
+    unsigned char c = (unsigned char)*s;
+    if(c=='"' || c=='\\') { fputc('\\', f); fputc(c, f); }
+    else if(c<0x20)       fprintf(f, "\\u%04x", c);
+    else                  fputc(c, f);
+  }
+  fputc('"', f);
+}
+
+static void put_csv_str(FILE* f, const char* s){
+  fputc('"', f);
+  for(; *s; ++s){
+    if(*s=='"') fputc('"', f);
+    fputc(*s=='\n' || *s=='\r' ? ' ' : *s, f);
+  }
+  fputc('"', f);
+}
+
+/* One object per line so the baseline reader can scan line by line */
+static void write_json(FILE* f){
+  fprintf(f, "[\n");
+  for(int i=0;i<g_nrecs;i++){
+    const BenchRecord* r = &g_recs[i];
+    fprintf(f, "{\"shape\":"); put_json_str(f, r->shape);
+    fprintf(f, ",\"dims\":");  put_json_str(f, r->dims);
+    fprintf(f, ",\"backend\":"); put_json_str(f, r->backend);
+    fprintf(f, ",\"batch\":%d,\"threads\":%d,\"n\":%d", r->batch, r->threads, r->st.n);
+    fprintf(f, ",\"p50_ms\":%.6f,\"p90_ms\":%.6f,\"p99_ms\":%.6f", r->st.p50, r->st.p90, r->st.p99);
+    fprintf(f, ",\"min_ms\":%.6f,\"max_ms\":%.6f,\"mean_ms\":%.6f,\"sd_ms\":%.6f",
+            r->st.min, r->st.max, r->st.mean, r->st.sd);
+    fprintf(f, ",\"samples_per_s\":%.3f,\"est_mb\":%.4f,\"host_mb\":%.4f,\"device_mb\":%.4f,\"gpu_init_ms\":%.3f",
+            r->sps, r->est_mb, r->host_mb, r->device_mb, r->gpu_init_ms);
+    fprintf(f, ",\"adapter\":"); put_json_str(f, r->adapter);
+    fprintf(f, ",\"mae\":%.9g,\"max_abs\":%.9g,\"max_ulp\":%u,\"gflops\":%.4f,\"failed\":%d}%s\n",
+            r->mae, r->max_abs, r->max_ulp, r->gflops, r->failed, i+1<g_nrecs ? "," : "");
+  }
+  fprintf(f, "]\n");
+}
+
+static const char* CSV_HEADER =
+  "shape,dims,backend,batch,threads,n,p50_ms,p90_ms,p99_ms,min_ms,max_ms,mean_ms,sd_ms,"
+  "samples_per_s,est_mb,host_mb,device_mb,gpu_init_ms,adapter,mae,max_abs,max_ulp,gflops,failed";
+
+static void write_csv(FILE* f){
+  fprintf(f, "%s\n", CSV_HEADER);
+  for(int i=0;i<g_nrecs;i++){
+    const BenchRecord* r = &g_recs[i];
+    fprintf(f, "%s,%s,%s,%d,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.3f,%.4f,%.4f,%.4f,%.3f,",
+            r->shape, r->dims, r->backend, r->batch, r->threads, r->st.n,
+            r->st.p50, r->st.p90, r->st.p99, r->st.min, r->st.max, r->st.mean, r->st.sd,
+            r->sps, r->est_mb, r->host_mb, r->device_mb, r->gpu_init_ms);
+    put_csv_str(f, r->adapter);
+    fprintf(f, ",%.9g,%.9g,%u,%.4f,%d\n", r->mae, r->max_abs, r->max_ulp, r->gflops, r->failed);
+  }
+}
+
+int bench_write_records(const char* path, const char* format){
+  FILE* f = path ? fopen(path, "w") : stdout;
+  if(!f){ perror(path); return 0; }
+  if(!strcmp(format, "csv")) write_csv(f);
+  else                       write_json(f);
+  if(f!=stdout) fclose(f); else fflush(f);
+  return 1;
+}
+
+/* ---- baseline comparison ---- */
+
+typedef struct { char key[160]; double p50; int used; } BaseRow;
+
+/* shape[dims]/backend/batch[/tN]: the dims keep a changed layer spec under the same shape
+   id from being compared against the old numbers */
+static void make_key(char* out, size_t n, const char* shape, const char* dims,
+                     const char* backend, int batch, int threads){
+  if(threads>1) snprintf(out, n, "%s[%s]/%s/%d/t%d", shape, dims, backend, batch, threads);
+  else          snprintf(out, n, "%s[%s]/%s/%d", shape, dims, backend, batch);
+}
+
+static int json_str_field(const char* line, const char* key, char* out, size_t n){
+  char pat[32]; snprintf(pat, sizeof(pat), "\"%s\":\"", key);
+  const char* p = strstr(line, pat);
+  if(!p) return 0;
+  p += strlen(pat);
+  size_t k=0;
+  while(*p && *p!='"' && k+1<n) out[k++] = *p++;
+  out[k] = 0;
+  return 1;
+}
+
+static int json_num_field(const char* line, const char* key, double* out){
+  char pat[32]; snprintf(pat, sizeof(pat), "\"%s\":", key);
+  const char* p = strstr(line, pat);
+  if(!p) return 0;
+  char* e=NULL; *out = strtod(p+strlen(pat), &e);
+  return e != p+strlen(pat);
+}
+
+/* one unquoted CSV field (possibly empty) into out; returns what follows its comma */
+static const char* csv_field(const char* p, char* out, size_t n){
+  size_t k=0;
+  for(; *p && *p!=','; ++p) if(k+1<n) out[k++] = *p;
+  out[k] = 0;
+  return *p==',' ? p+1 : NULL;
+}
+
+/* CSV rows as written above: the first five columns never contain quotes */
+static int csv_row(const char* line, char* key, size_t n, double* p50){
+  char shape[16], dims[96], backend[16];
+  int batch=0, threads=1, cnt=0;
+  const char* p = csv_field(line, shape, sizeof(shape));
+  if(p) p = csv_field(p, dims, sizeof(dims));
+  if(p) p = csv_field(p, backend, sizeof(backend));
+  if(!p || sscanf(p, "%d,%d,%d,%lf", &batch, &threads, &cnt, p50) != 4) return 0;
+  make_key(key, n, shape, dims, backend, batch, threads);
+  return 1;
+}
+
+static int load_baseline(const char* path, BaseRow** rows){
+  FILE* f = fopen(path, "r");
+  if(!f){ perror(path); return -1; }
+  int n=0, cap=0; *rows = NULL;
+  char line[4096];
+  while(fgets(line, sizeof(line), f)){
+    BaseRow r; memset(&r, 0, sizeof(r));
+    if(strstr(line, "\"shape\"")){
+      char shape[16], dims[96] = "", backend[16]; double batch=0, threads=1;
+      if(!json_str_field(line,"shape",shape,sizeof(shape)) ||
+         !json_str_field(line,"backend",backend,sizeof(backend)) ||
+         !json_num_field(line,"batch",&batch) ||
+         !json_num_field(line,"p50_ms",&r.p50)) continue;
+      (void)json_num_field(line,"threads",&threads);
+      (void)json_str_field(line,"dims",dims,sizeof(dims));
+      make_key(r.key, sizeof(r.key), shape, dims, backend, (int)batch, (int)threads);
+    } else if(!strncmp(line, "shape,", 6)){
+      continue;
+    } else if(!csv_row(line, r.key, sizeof(r.key), &r.p50)){
+      continue;
+    }
+    if(n==cap){
+      cap = cap ? cap*2 : 64;
+      *rows = (BaseRow*)realloc(*rows, sizeof(BaseRow)*(size_t)cap);
+      if(!*rows) exit(1);
+    }
+    (*rows)[n++] = r;
+  }
+  fclose(f);
+  return n;
+}
+
+int bench_compare_baseline(const char* path, double threshold){
+  BaseRow* base = NULL;
+  int nb = load_baseline(path, &base);
+  if(nb<0) return -1;
+  int regressions = 0, matched = 0;
+  fprintf(stderr, "\n=== Baseline %s (threshold +%.1f%% p50) ===\n", path, threshold*100.0);
+  for(int i=0;i<g_nrecs;i++){
+    const BenchRecord* r = &g_recs[i];
+    char key[160]; make_key(key, sizeof(key), r->shape, r->dims, r->backend, r->batch, r->threads);
+    for(int j=0;j<nb;j++){
+      if(base[j].used || strcmp(base[j].key, key)) continue;
+      ++matched; base[j].used = 1;
+      if(r->failed>0){
+        ++regressions;
+        fprintf(stderr, "FAILED     %-16s %d call(s) errored\n", key, r->failed);
+        break;
+      }
+      if(base[j].p50<=0 || r->st.n<=0) break;
+      double ratio = r->st.p50 / base[j].p50;
+      if(ratio > 1.0 + threshold){
+        ++regressions;
+        fprintf(stderr, "REGRESSION %-16s p50 %.3f ms -> %.3f ms (%+.1f%%)\n",
+                key, base[j].p50, r->st.p50, (ratio-1.0)*100.0);
+      }
+      break;
+    }
+  }
+  int stale = 0;
+  for(int j=0;j<nb;j++)
+    if(!base[j].used){ ++stale; fprintf(stderr, "UNMATCHED  %s (in the baseline, not in this run)\n", base[j].key); }
+  fprintf(stderr, "%d/%d records matched, %d baseline row(s) unmatched, %d regression(s)\n",
+          matched, g_nrecs, stale, regressions);
+  free(base);
+  if(!matched){
+    fprintf(stderr, "baseline: no record matched %s, nothing was compared\n", path);
+    return -1;
+  }
+  return regressions;
+}
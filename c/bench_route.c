@@ -0,0 +1,179 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* --route: calibrate a ParagonRouter on a CPU and a GPU handle of the shape, then compare
+   it with pinning every call to one backend, first one batch size at a time, then under
+   --clients threads sending a mix of batch sizes (mostly single samples, some bulk). The
+   fixed policies are single-handle routers, so all three pay the same locking. */
+
+#define MAX_LAT 65536
+static const int SIZES[] = { 1, 8, 64, 256 };
+#define NSIZES ((int)(sizeof(SIZES)/sizeof(SIZES[0])))
+static const int MIX[] = { 1, 1, 1, 1, 8, 1, 1, 64, 1, 1, 1, 256 };
+#define NMIX ((int)(sizeof(MIX)/sizeof(MIX[0])))
+#define MIX_MAX 256
+
+enum { POL_CPU, POL_GPU, POL_ROUTED, NPOL };
+static const char* const POLICY[NPOL] = { "cpu-only", "gpu-only", "routed" };
+
+typedef struct {
+  ParagonRouter* r;
+  int            in_dim, out_dim;
+  double         end;
+} Load;
+
+typedef struct {
+  Load*     L;
+  int       id;
+  long long count, samples, gpu;
+  double*   lat;
+  int       nlat;
+} Client;
+
+static void* client_main(void* arg){
+  Client* c = (Client*)arg;
+  Load* L = c->L;
+  float* X = malloc(sizeof(float)*(size_t)MIX_MAX*L->in_dim);
+  float* Y = malloc(sizeof(float)*(size_t)MIX_MAX*L->out_dim);
+  if(!X || !Y) exit(1);
+  for(int i=0;i<MIX_MAX;i++) fill_lcg(X+(size_t)i*L->in_dim, L->in_dim, 901u + (unsigned)(c->id*MIX_MAX + i));
+  for(int k=c->id;;k++){
+    double t0 = now_ms();
+    if(t0>=L->end) break;
+    int n = MIX[k % NMIX], used = PARAGON_ROUTE_CPU;
+    if(paragon_router_forward(L->r, X, n, L->in_dim, Y, L->out_dim, &used)==n) c->samples += n;
+    if(used==PARAGON_ROUTE_GPU) ++c->gpu;
+    if(c->nlat<MAX_LAT) c->lat[c->nlat++] = now_ms() - t0;
+    ++c->count;
+  }
+  free(X); free(Y);
+  return NULL;
+}
+
+/* returns requests/s; *sps samples/s, *gpu_frac share of requests on the GPU */
+static double drive(Load* L, int clients, Stats* st, double* sps, double* gpu_frac){
+  Client* cs = calloc((size_t)clients, sizeof(Client));
+  pthread_t* th = calloc((size_t)clients, sizeof(pthread_t));
+  if(!cs || !th) exit(1);
+  L->end = now_ms() + g_opt.thread_ms;
+  double t0 = now_ms();
+  for(int i=0;i<clients;i++){
+    cs[i].L = L; cs[i].id = i;
+    cs[i].lat = malloc(sizeof(double)*MAX_LAT);
+    if(!cs[i].lat) exit(1);
+    pthread_create(&th[i], NULL, client_main, &cs[i]);
+  }
+  long long total = 0, samples = 0, gpu = 0; int nlat = 0;
+  for(int i=0;i<clients;i++){
+    pthread_join(th[i], NULL);
+    total += cs[i].count; samples += cs[i].samples; gpu += cs[i].gpu; nlat += cs[i].nlat;
+  }
+  double dt = now_ms() - t0;
+  double* all = malloc(sizeof(double)*(size_t)(nlat>0?nlat:1));
+  if(!all) exit(1);
+  for(int i=0, o=0;i<clients;i++){ memcpy(all+o, cs[i].lat, sizeof(double)*(size_t)cs[i].nlat); o += cs[i].nlat; free(cs[i].lat); }
+  stats_of(all, nlat, st);
+  free(all); free(cs); free(th);
+  *sps = dt>0 ? samples*1000.0/dt : 0.0;
+  *gpu_frac = total ? (double)gpu/total : 0.0;
+  return dt>0 ? total*1000.0/dt : 0.0;
+}
+
+/* batch-size latency on one policy; *gpu gets how many calls went to the GPU */
+static void time_size(ParagonRouter* r, const float* X, float* Y, int n, int in_dim, int out_dim,
+                      Stats* st, int* gpu){
+  int iters = g_opt.batch_iters<1 ? 1 : (g_opt.batch_iters>64 ? 64 : g_opt.batch_iters);
+  double v[64];
+  *gpu = 0;
+  if(g_opt.warmup>0) (void)paragon_router_forward(r, X, n, in_dim, Y, out_dim, NULL);
+  for(int i=0;i<iters;i++){
+    int used = PARAGON_ROUTE_CPU;
+    double t0 = now_ms();
+    (void)paragon_router_forward(r, X, n, in_dim, Y, out_dim, &used);
+    v[i] = now_ms() - t0;
+    if(used==PARAGON_ROUTE_GPU) ++*gpu;
+  }
+  stats_of(v, iters, st);
+}
+
+void bench_route(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int in_dim = dims[0], out_dim = dims[ndims-1];
+  int clients = g_opt.clients>0 ? g_opt.clients : 4;
+  ParagonHandle hc = bench_new_net(api, dims, ndims);
+  ParagonHandle hg = bench_new_net(api, dims, ndims);
+  if(hc<=0 || hg<=0){ fprintf(stderr, "route: NewNetwork failed\n"); return; }
+  paragon_free_result(api, paragon_init_gpu(api, hg));
+  (void)paragon_enable_gpu(api, hg);
+  paragon_free_result(api, paragon_call_id(api, hg, PARAGON_M_TOGGLE_GPU, "[]"));
+
+  ParagonRouter* pol[NPOL];
+  pol[POL_CPU]    = paragon_router_new(api, hc, -1, in_dim, out_dim);
+  pol[POL_GPU]    = paragon_router_new(api, hg, -1, in_dim, out_dim);
+  pol[POL_ROUTED] = paragon_router_new(api, hc, hg, in_dim, out_dim);
+  if(!pol[0] || !pol[1] || !pol[2]){
+    fprintf(stderr, "route: paragon_router_new failed\n");
+    for(int p=0;p<NPOL;p++) paragon_router_free(pol[p]);
+    return;
+  }
+  double t0 = now_ms();
+  int iters = g_opt.batch_iters<3 ? 3 : g_opt.batch_iters;
+  (void)paragon_router_calibrate(pol[POL_ROUTED], MIX_MAX, iters);
+  double t_cal = now_ms() - t0;
+
+  ParagonRouterStats rs;
+  paragon_router_stats(pol[POL_ROUTED], &rs);
+  char from[32];
+  if(rs.crossover>0) snprintf(from, sizeof(from), "from batch %d", rs.crossover);
+  else               snprintf(from, sizeof(from), "never");
+  fprintf(g_txt, "Router (calibrated in %.1f ms, GPU wins %s)\n", t_cal, from);
+  fprintf(g_txt, "  batch    CPU ms    GPU ms\n");
+  for(int k=0;k<rs.nsizes;k++)
+    fprintf(g_txt, "  %5d %9.3f %9.3f\n", rs.sizes[k], rs.cpu_ms[k], rs.gpu_ms[k]);
+
+  float* X = malloc(sizeof(float)*(size_t)MIX_MAX*in_dim);
+  float* Y = malloc(sizeof(float)*(size_t)MIX_MAX*out_dim);
+  if(!X || !Y) exit(1);
+  for(int i=0;i<MIX_MAX;i++) fill_lcg(X+(size_t)i*in_dim, in_dim, 123u+(unsigned)i);
+
+  BenchRecord rec = *base;
+  rec.threads = 1;
+  fprintf(g_txt, "  batch  cpu-only p50  gpu-only p50    routed p50   picked\n");
+  for(int k=0;k<NSIZES;k++){
+    Stats st[NPOL]; int gpu[NPOL];
+    for(int p=0;p<NPOL;p++) time_size(pol[p], X, Y, SIZES[k], in_dim, out_dim, &st[p], &gpu[p]);
+    fprintf(g_txt, "  %5d %13.3f %13.3f %13.3f   %s\n", SIZES[k], st[0].p50, st[1].p50, st[2].p50,
+      gpu[POL_ROUTED]*2 > st[POL_ROUTED].n ? "GPU" : "CPU");
+    rec.batch = SIZES[k];
+    for(int p=0;p<NPOL;p++){
+      snprintf(rec.backend, sizeof(rec.backend), "%s", POLICY[p]);
+      rec.st = st[p];
+      rec.sps = st[p].p50>0 ? SIZES[k]*1000.0/st[p].p50 : 0.0;
+      bench_record(&rec);
+    }
+  }
+  free(X); free(Y);
+
+  fprintf(g_txt, "  mixed batches, %d clients, %d ms:\n", clients, g_opt.thread_ms);
+  Load L; memset(&L, 0, sizeof(L));
+  L.in_dim = in_dim; L.out_dim = out_dim;
+  rec.threads = clients; rec.batch = 1;
+  for(int p=0;p<NPOL;p++){
+    Stats st; double sps = 0.0, gf = 0.0;
+    L.r = pol[p];
+    double rps = drive(&L, clients, &st, &sps, &gf);
+    fprintf(g_txt, "  %-8s %10.1f req/s %12.1f samples/s   p50 %.3f ms   p99 %.3f ms%s",
+      POLICY[p], rps, sps, st.p50, st.p99, p==POL_ROUTED ? "" : "\n");
+    if(p==POL_ROUTED) fprintf(g_txt, "   %.0f%% on GPU\n", 100.0*gf);
+    snprintf(rec.backend, sizeof(rec.backend), "%s-mix", POLICY[p]);
+    rec.st = st; rec.sps = sps;
+    bench_record(&rec);
+  }
+  for(int p=0;p<NPOL;p++) paragon_router_free(pol[p]);
+}
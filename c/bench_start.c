@@ -0,0 +1,100 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+
+/* Time to first inference on a fresh handle: NewNetwork, InitializeOptimizedGPU
+   (through the pipeline cache), ToggleGPU and one forward/extract. Miss drops the
+   shape's cache entry before every start; hit makes sure one exists. Both run inside
+   this process, with the library and its runtime already up: they isolate the
+   pipeline cache, not a cold process start. Each handle is freed after its start. */
+
+static void start_once(ParagonAPI* api, const int* dims, int ndims, const float* x,
+                       double* t_new, double* t_init, double* t_first, int* hit){
+  double t0 = now_ms();
+  ParagonHandle h = bench_new_net(api, dims, ndims);
+  double t1 = now_ms();
+  *t_new = t1 - t0; *t_init = *t_first = 0.0; *hit = 0;
+  if(h<=0) return;
+  char p[600];
+  if(g_opt.start==BENCH_START_MISS && paragon_gpu_cache_path(api, h, p, sizeof(p))) (void)unlink(p);
+  double t2 = now_ms();
+  paragon_free_result(api, paragon_init_gpu(api, h));
+  (void)paragon_enable_gpu(api, h);
+  double t3 = now_ms();
+  paragon_free_result(api, paragon_call_id(api, h, PARAGON_M_TOGGLE_GPU, "[]"));
+  float y[1024];
+  (void)paragon_forward_f32(api, h, x, 1, dims[0]);
+  (void)paragon_extract_f32(api, h, y, 1024);
+  double t4 = now_ms();
+  *t_init = t3 - t2; *t_first = t4 - t3;
+  ParagonHandleInfo hi;
+  *hit = paragon_handle_info(api, h, &hi) && (hi.flags & PARAGON_HF_GPU_CACHED);
+  (void)paragon_free_handle(api, h);   /* else reps+1 networks pile up under later starts */
+}
+
+void bench_start(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int miss = g_opt.start==BENCH_START_MISS;
+  int reps = g_opt.iters < 3 ? 3 : (g_opt.iters > 20 ? 20 : g_opt.iters);
+  float x[784];
+  fill_lcg(x, dims[0] < 784 ? dims[0] : 784, 123u);
+
+  if(!miss){
+    /* prime: a start that misses writes the entry the timed starts will read */
+    double a, b, c; int hit;
+    start_once(api, dims, ndims, x, &a, &b, &c, &hit);
+  }
+
+  double* tot = malloc(sizeof(double)*(size_t)reps);
+  if(!tot) exit(1);
+  double s_new=0, s_init=0, s_first=0; int hits=0;
+  for(int i=0;i<reps;i++){
+    double a, b, c; int hit;
+    start_once(api, dims, ndims, x, &a, &b, &c, &hit);
+    tot[i] = a + b + c;
+    s_new += a; s_init += b; s_first += c; hits += hit;
+  }
+  BenchRecord rec = *base;
+  stats_of(tot, reps, &rec.st);
+  free(tot);
+
+  fprintf(g_txt, "Start (%s, %d fresh handles, cache %s)\n", miss ? "cache miss" : "cache hit", reps,
+    !api->gpu_cache_dir[0] ? "off" :
+    (api->ExportGPUCache && api->ImportGPUCache) ? api->gpu_cache_dir : "unsupported by library");
+  fprintf(g_txt, "  new %.2f ms   gpu init %.2f ms   first inference %.2f ms   total p50 %.2f ms   cache hits %d/%d\n",
+    s_new/reps, s_init/reps, s_first/reps, rec.st.p50, hits, reps);
+
+  snprintf(rec.backend, sizeof(rec.backend), "%s", miss ? "start-miss" : "start-hit");
+  rec.batch = 1; rec.threads = 1;
+  rec.gpu_init_ms = s_init/reps;
+  rec.sps = rec.st.p50>0 ? 1000.0/rec.st.p50 : 0.0;
+  bench_record(&rec);
+}
+
+/* Load phases of this process (paragon_load_ex / paragon_prewarm_*), printed once after
+   the capability line and kept as one "load" record. blocked_ms is what the caller
+   waited in paragon_prewarm_wait; NULL for a plain load. */
+void bench_load_report(const ParagonAPI* api, const double* blocked_ms){
+  const ParagonLoadTimes* t = &api->load;
+  fprintf(g_txt, "Load: dlopen %.2f ms (%s), %d lookups in %.2f ms, probe %.2f ms",
+    t->dlopen_ms, t->lazy ? "RTLD_LAZY" : "RTLD_NOW", t->symbols, t->resolve_ms, t->probe_ms);
+  if(t->gpu_ms>0) fprintf(g_txt, ", gpu %.2f ms", t->gpu_ms);
+  fprintf(g_txt, ", total %.2f ms", t->total_ms);
+  if(blocked_ms) fprintf(g_txt, ", caller blocked %.2f ms", *blocked_ms);
+  fprintf(g_txt, "\n");
+
+  BenchRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  snprintf(rec.shape, sizeof(rec.shape), "load");
+  snprintf(rec.backend, sizeof(rec.backend), "%s%s", t->lazy ? "lazy" : "now", blocked_ms ? "-prewarm" : "");
+  rec.batch = 1; rec.threads = 1;
+  double v = blocked_ms ? *blocked_ms : t->total_ms;
+  rec.st.n = 1;
+  rec.st.mean = rec.st.min = rec.st.max = rec.st.p50 = rec.st.p90 = rec.st.p99 = v;
+  rec.gpu_init_ms = t->gpu_ms;
+  bench_record(&rec);
+}
@@ -0,0 +1,177 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* --sweep=AXIS:LO..HI[:POINTS]: one axis of input → depth×width → output at batch B moves
+   over POINTS values (geometric for width/input/batch, linear for depth) while the rest
+   stay at --width/--depth/--input/--output/--batch. Each point builds a fresh network
+   through json_layers & co., times CPU and then GPU on the same handle, and reports
+   latency, GFLOP/s (2·B·Σ in×out multiply-adds per call) and the rate the weights are
+   streamed at. The summary gives the point where GPU overtakes CPU and where each
+   backend's GFLOP/s flattens out. */
+
+#define MAX_POINTS 64
+#define MAX_DEPTH  (PARAGON_MODEL_MAX_LAYERS-2)
+
+static const char* const AXES[] = { "width", "depth", "input", "batch", NULL };
+enum { AX_WIDTH, AX_DEPTH, AX_INPUT, AX_BATCH };
+
+int bench_sweep_parse(const char* spec){
+  char axis[16]; int lo = 0, hi = 0, pts = 8;
+  int got = sscanf(spec, "%15[a-z]:%d..%d:%d", axis, &lo, &hi, &pts);
+  if(got<3){ fprintf(stderr, "--sweep: expected AXIS:LO..HI[:POINTS], got '%s'\n", spec); return 0; }
+  int a = -1;
+  for(int i=0; AXES[i]; i++) if(!strcmp(axis, AXES[i])) a = i;
+  if(a<0){ fprintf(stderr, "--sweep: axis must be width, depth, input or batch\n"); return 0; }
+  if(lo<1 || hi<lo || pts<1){ fprintf(stderr, "--sweep: need 1 <= LO <= HI and POINTS >= 1\n"); return 0; }
+  if(a==AX_DEPTH && hi>MAX_DEPTH){ fprintf(stderr, "--sweep: depth is at most %d\n", MAX_DEPTH); return 0; }
+  g_opt.sweep_axis = a; g_opt.sweep_lo = lo; g_opt.sweep_hi = hi;
+  g_opt.sweep_points = pts>MAX_POINTS ? MAX_POINTS : pts;
+  return 1;
+}
+
+/* distinct axis values, widths/inputs rounded to a multiple of 8 past 8 */
+static int axis_values(int* v){
+  int lo = g_opt.sweep_lo, hi = g_opt.sweep_hi, pts = g_opt.sweep_points, n = 0;
+  for(int i=0;i<pts;i++){
+    double f = pts>1 ? (double)i/(pts-1) : 0.0;
+    int x = g_opt.sweep_axis==AX_DEPTH ? (int)lround(lo + f*(hi-lo))
+                                       : (int)lround(lo*pow((double)hi/lo, f));
+    if((g_opt.sweep_axis==AX_WIDTH || g_opt.sweep_axis==AX_INPUT) && x>8) x = (x+4)/8*8;
+    if(x<lo) x = lo;
+    if(x>hi) x = hi;
+    if(n==0 || v[n-1]!=x) v[n++] = x;
+  }
+  return n;
+}
+
+typedef struct {
+  int    x;
+  Stats  st[2];        /* cpu, gpu */
+  double gflops[2], gbs[2];
+} Point;
+
+/* one batch size, warmup + iters calls; returns samples/s at p50 */
+static double time_batch(ParagonAPI* api, ParagonHandle h, const float* X, int batch,
+                         int in_dim, float* Y, int out_dim, Stats* st){
+  for(int i=0;i<g_opt.warmup;i++) (void)paragon_forward_batch(api, h, X, batch, in_dim, Y, out_dim);
+  int n = g_opt.iters;
+  double* v = malloc(sizeof(double)*(size_t)n);
+  if(!v) exit(1);
+  int got = 0;
+  for(int i=0;i<n;i++){
+    double t0 = now_ms();
+    got = paragon_forward_batch(api, h, X, batch, in_dim, Y, out_dim);
+    v[i] = now_ms() - t0;
+  }
+  stats_of(v, n, st);
+  free(v);
+  return got>0 && st->p50>0 ? got*1000.0/st->p50 : 0.0;
+}
+
+/* interpolated (geometric) axis value where ratio r = cpu/gpu first reaches 1 */
+static double crossover(const Point* p, int n, int* found){
+  *found = 0;
+  for(int i=0;i<n;i++){
+    if(p[i].st[0].p50<=0 || p[i].st[1].p50<=0) continue;
+    double r = p[i].st[0].p50 / p[i].st[1].p50;
+    if(r<1.0) continue;
+    *found = 1;
+    if(i==0) return p[0].x;
+    double r0 = p[i-1].st[1].p50>0 ? p[i-1].st[0].p50 / p[i-1].st[1].p50 : 0.0;
+    if(r0<=0 || r<=r0) return p[i].x;
+    double f = -log(r0) / (log(r) - log(r0));
+    return exp(log((double)p[i-1].x) + f*(log((double)p[i].x) - log((double)p[i-1].x)));
+  }
+  return 0.0;
+}
+
+void bench_sweep(ParagonAPI* api){
+  int xs[MAX_POINTS];
+  int npts = axis_values(xs);
+  const char* ax = AXES[g_opt.sweep_axis];
+  fprintf(g_txt, "\n=== Sweep %s %d..%d (%d points): input %d, depth %d × width %d, output %d, batch %d ===\n",
+    ax, g_opt.sweep_lo, g_opt.sweep_hi, npts, g_opt.sweep_input, g_opt.sweep_depth,
+    g_opt.sweep_width, g_opt.sweep_output, g_opt.sweep_batch);
+  fprintf(g_txt, "%8s %10s %9s %9s %10s %10s %9s %9s %8s\n",
+    ax, "weights MB", "CPU p50", "GPU p50", "CPU GF/s", "GPU GF/s", "CPU GB/s", "GPU GB/s", "speedup");
+
+  Point pts[MAX_POINTS];
+  memset(pts, 0, sizeof(pts));
+  for(int k=0;k<npts;k++){
+    int width = g_opt.sweep_width, depth = g_opt.sweep_depth;
+    int input = g_opt.sweep_input, batch = g_opt.sweep_batch;
+    switch(g_opt.sweep_axis){
+      case AX_WIDTH: width = xs[k]; break;
+      case AX_DEPTH: depth = xs[k]; break;
+      case AX_INPUT: input = xs[k]; break;
+      default:       batch = xs[k]; break;
+    }
+    int dims[PARAGON_MODEL_MAX_LAYERS], nd = 0;
+    dims[nd++] = input;
+    for(int i=0;i<depth;i++) dims[nd++] = width;
+    dims[nd++] = g_opt.sweep_output;
+
+    long long macs = 0, params = 0;
+    for(int i=0;i<nd-1;i++){ macs += (long long)dims[i]*dims[i+1]; params += (long long)dims[i]*dims[i+1] + dims[i+1]; }
+    double flops = 2.0*(double)macs*batch, wbytes = 4.0*(double)params;
+
+    Point* p = &pts[k];
+    p->x = xs[k];
+    ParagonHandle h = bench_new_net(api, dims, nd);
+    if(h<=0){ fprintf(stderr, "sweep: NewNetwork failed at %s=%d\n", ax, xs[k]); continue; }
+    int in_dim = dims[0], out_dim = dims[nd-1];
+    float* X = malloc(sizeof(float)*(size_t)batch*in_dim);
+    float* Y = malloc(sizeof(float)*(size_t)batch*out_dim);
+    if(!X || !Y) exit(1);
+    for(int i=0;i<batch;i++) fill_lcg(X+(size_t)i*in_dim, in_dim, 123u+(unsigned)i);
+
+    for(int g=0; g<2; g++){
+      if(g){
+        paragon_free_result(api, paragon_init_gpu(api, h));
+        (void)paragon_enable_gpu(api, h);
+        paragon_free_result(api, paragon_call_id(api, h, PARAGON_M_TOGGLE_GPU, "[]"));
+      }
+      double sps = time_batch(api, h, X, batch, in_dim, Y, out_dim, &p->st[g]);
+      double s = p->st[g].p50/1000.0;
+      p->gflops[g] = s>0 ? flops/s/1e9 : 0.0;
+      p->gbs[g]    = s>0 ? wbytes/s/1e9 : 0.0;
+
+      BenchRecord rec; memset(&rec, 0, sizeof(rec));
+      snprintf(rec.shape, sizeof(rec.shape), "sw-%c%d", ax[0], xs[k]);
+      for(int i=0, w=0; i<nd && w<(int)sizeof(rec.dims); i++)
+        w += snprintf(rec.dims+w, sizeof(rec.dims)-(size_t)w, i?"-%d":"%d", dims[i]);
+      snprintf(rec.backend, sizeof(rec.backend), "%s", g ? "gpu" : "cpu");
+      rec.batch = batch; rec.threads = 1;
+      rec.st = p->st[g]; rec.sps = sps;
+      rec.est_mb = wbytes/(1024.0*1024.0);
+      rec.gflops = p->gflops[g];
+      bench_record(&rec);
+    }
+    free(X); free(Y);
+
+    fprintf(g_txt, "%8d %10.2f %9.3f %9.3f %10.2f %10.2f %9.2f %9.2f %7.2fx\n",
+      p->x, wbytes/(1024.0*1024.0), p->st[0].p50, p->st[1].p50, p->gflops[0], p->gflops[1],
+      p->gbs[0], p->gbs[1], p->st[1].p50>0 ? p->st[0].p50/p->st[1].p50 : 0.0);
+  }
+
+  int found = 0;
+  double cx = crossover(pts, npts, &found);
+  if(found) fprintf(g_txt, "GPU overtakes CPU at %s ≈ %.0f\n", ax, cx);
+  else      fprintf(g_txt, "GPU does not overtake CPU in %s %d..%d\n", ax, g_opt.sweep_lo, g_opt.sweep_hi);
+  /* where throughput stops growing with the axis: compute- or bandwidth-bound past here */
+  for(int g=0; g<2; g++){
+    int best = -1;
+    for(int k=0;k<npts;k++) if(best<0 || pts[k].gflops[g] > pts[best].gflops[g]) best = k;
+    if(best<0 || pts[best].gflops[g]<=0) continue;
+    int knee = best;
+    for(int k=0;k<npts;k++) if(pts[k].gflops[g] >= 0.9*pts[best].gflops[g]){ knee = k; break; }
+    fprintf(g_txt, "%s: peak %.2f GFLOP/s at %s=%d, within 10%% of it from %s=%d (weights streamed at %.2f GB/s there)\n",
+      g ? "GPU" : "CPU", pts[best].gflops[g], ax, pts[best].x, ax, pts[knee].x, pts[knee].gbs[g]);
+  }
+}
@@ -0,0 +1,144 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "bench.h"
+
+#define MAX_LAT 65536   /* latency samples kept per worker */
+
+typedef struct {
+  ParagonAPI*        api;
+  ParagonHandle      h;        /* shared handle, or 0 to create one in-thread */
+  const int*         dims;
+  int                ndims;
+  int                cpu;      /* -1 = unpinned */
+  const float*       x;
+  const float*       ref;      /* serial output to check against (shared handle) */
+  int                nref;
+  float              own[1024];/* per-thread handles: their own warm output */
+  pthread_barrier_t* start;
+  long long          count;
+  long long          bad;      /* outputs that differ from ref */
+  int                ok;
+  double*            lat;
+  int                nlat;
+} Worker;
+
+static void* worker_main(void* arg){
+  Worker* w = (Worker*)arg;
+  if(w->cpu>=0){
+    cpu_set_t set; CPU_ZERO(&set); CPU_SET(w->cpu, &set);
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+  /* per-thread handles are built after pinning so first touch lands on the local node */
+  ParagonHandle h = w->h ? w->h : bench_new_net(w->api, w->dims, w->ndims);
+  w->ok = h>0;
+  int out_dim = w->dims[w->ndims-1];
+  float* y = malloc(sizeof(float)*(size_t)out_dim);
+  if(!y) exit(1);
+  if(w->ok && !w->h){
+    /* fresh handles get their own weights, so each checks against its own warm output */
+    (void)paragon_forward_f32(w->api, h, w->x, 1, w->dims[0]);
+    int n = paragon_extract_f32(w->api, h, w->own, 1024);
+    w->ref = w->own; w->nref = n>0 ? n : 0;
+  }
+  pthread_barrier_wait(w->start);
+  if(w->ok){
+    double end = now_ms() + g_opt.thread_ms;
+    for(;;){
+      double t0 = now_ms();
+      if(t0>=end) break;
+      (void)paragon_forward_f32(w->api, h, w->x, 1, w->dims[0]);
+      int got = paragon_extract_f32(w->api, h, y, out_dim);
+      double t1 = now_ms();
+      if(w->nlat<MAX_LAT) w->lat[w->nlat++] = t1 - t0;
+      ++w->count;
+      int n = got<w->nref ? got : w->nref;
+      if(n!=w->nref){ ++w->bad; continue; }
+      for(int i=0;i<n;i++) if(fabsf(y[i]-w->ref[i])>1e-6f){ ++w->bad; break; }
+    }
+  }
+  free(y);
+  if(!w->h && h>0) (void)paragon_free_handle(w->api, h);   /* or the sweep piles them up */
+  return NULL;
+}
+
+/* aggregate throughput with k workers; fills rec->st from the merged latencies */
+static double run_threads(ParagonAPI* api, ParagonHandle shared, const int* dims, int ndims,
+                          int k, const float* x, const float* ref, int nref,
+                          BenchRecord* rec, long long* bad, int* failed){
+  long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+  if(ncpu<1) ncpu = 1;
+  Worker* ws = calloc((size_t)k, sizeof(Worker));
+  pthread_t* th = calloc((size_t)k, sizeof(pthread_t));
+  if(!ws || !th) exit(1);
+  pthread_barrier_t start;
+  pthread_barrier_init(&start, NULL, (unsigned)k+1);
+  for(int i=0;i<k;i++){
+    Worker* w = &ws[i];
+    w->api = api; w->h = shared; w->dims = dims; w->ndims = ndims;
+    w->cpu = g_opt.pin ? (int)(i % ncpu) : -1;
+    w->x = x; w->ref = ref; w->nref = nref; w->start = &start;
+    w->lat = malloc(sizeof(double)*MAX_LAT);
+    if(!w->lat) exit(1);
+    pthread_create(&th[i], NULL, worker_main, w);
+  }
+  pthread_barrier_wait(&start);
+  double t0 = now_ms();
+  for(int i=0;i<k;i++) pthread_join(th[i], NULL);
+  double dt = now_ms() - t0;
+  pthread_barrier_destroy(&start);
+
+  long long total=0; int nlat=0;
+  *bad = 0; *failed = 0;
+  for(int i=0;i<k;i++){ total += ws[i].count; *bad += ws[i].bad; nlat += ws[i].nlat; if(!ws[i].ok) ++*failed; }
+  double* all = malloc(sizeof(double)*(size_t)(nlat>0?nlat:1));
+  if(!all) exit(1);
+  for(int i=0, o=0;i<k;i++){ memcpy(all+o, ws[i].lat, sizeof(double)*(size_t)ws[i].nlat); o += ws[i].nlat; }
+  stats_of(all, nlat, &rec->st);
+  free(all);
+  for(int i=0;i<k;i++) free(ws[i].lat);
+  free(ws); free(th);
+  return dt>0 ? total*1000.0/dt : 0.0;
+}
+
+void bench_threads(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  float x[784], ref[1024];
+  int in_dim = dims[0] < 784 ? dims[0] : 784;
+  fill_lcg(x, in_dim, 123u);
+
+  /* reference output from a fresh CPU handle, serially */
+  ParagonHandle h0 = bench_new_net(api, dims, ndims);
+  if(h0<=0){ fprintf(stderr, "threads: NewNetwork failed\n"); return; }
+  (void)paragon_forward_f32(api, h0, x, 1, in_dim);
+  int nref = paragon_extract_f32(api, h0, ref, 1024);
+  if(nref<0) nref = 0;
+  ParagonHandle shared = g_opt.shared_handle ? h0 : 0;
+
+  fprintf(g_txt, "Threads (%s handle%s, %s, %d ms window)\n",
+    shared ? "shared" : "per-thread", shared ? "" : "s",
+    g_opt.pin ? "pinned" : "unpinned", g_opt.thread_ms);
+  fprintf(g_txt, "  thr        inf/s    per-thread   efficiency   p50 ms   p99 ms   mismatches\n");
+
+  double base_ips = 0.0;
+  for(int k=1; k<=g_opt.threads; k = (k*2>g_opt.threads && k<g_opt.threads) ? g_opt.threads : k*2){
+    BenchRecord rec = *base;
+    long long bad; int failed;
+    double ips = run_threads(api, shared, dims, ndims, k, x, ref, nref, &rec, &bad, &failed);
+    if(k==1) base_ips = ips;
+    double eff = base_ips>0 ? ips/(k*base_ips) : 0.0;
+    fprintf(g_txt, "  %3d  %11.1f  %12.1f   %9.1f%%  %7.3f  %7.3f   %lld%s\n",
+      k, ips, ips/k, eff*100.0, rec.st.p50, rec.st.p99, bad,
+      failed ? "  (handle creation failed)" : "");
+    snprintf(rec.backend, sizeof(rec.backend), "cpu-mt");
+    rec.batch = 1; rec.threads = k; rec.sps = ips;
+    bench_record(&rec);
+  }
+  (void)paragon_free_handle(api, h0);
+}
@@ -0,0 +1,65 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* --trace=FILE: the whole run is traced; at the end the spans still in the ring are
+   summed per method so the split between marshalling and library time is visible
+   without opening the trace. */
+
+#define MAX_NAMES 64
+
+typedef struct {
+  char      name[24];
+  long long calls, bytes;
+  double    ser_us, lib_us, deser_us;
+} PerMethod;
+
+void bench_trace_report(ParagonAPI* api, const char* path){
+  ParagonTraceStats ts;
+  paragon_trace_stats(api, &ts);
+  int ok = paragon_trace_export(api, path);
+  fprintf(g_txt, "Trace: %lld calls (%.0f/s), %.2f MB marshalled (%.2f in, %.2f out), %lld spans dropped%s%s\n",
+    ts.calls, ts.calls_per_s, (ts.arg_bytes + ts.result_bytes)/1048576.0,
+    ts.arg_bytes/1048576.0, ts.result_bytes/1048576.0, ts.dropped,
+    ok ? " -> " : " (export failed)", ok ? path : "");
+  double tot = ts.ser_ms + ts.lib_ms + ts.deser_ms;
+  if(tot>0)
+    fprintf(g_txt, "  serialize %.1f%%   library %.1f%%   deserialize %.1f%%   (%.1f ms in bridge calls)\n",
+      100.0*ts.ser_ms/tot, 100.0*ts.lib_ms/tot, 100.0*ts.deser_ms/tot, tot);
+
+  int cap = PARAGON_TRACE_DEFAULT_CAP;
+  ParagonSpanRec* v = malloc(sizeof(*v)*(size_t)cap);
+  if(!v) return;
+  int n = paragon_trace_spans(api, v, cap);
+  PerMethod pm[MAX_NAMES]; int npm = 0;
+  for(int i=0;i<n;i++){
+    int k = 0;
+    while(k<npm && strcmp(pm[k].name, v[i].name)) ++k;
+    if(k==npm){
+      if(npm==MAX_NAMES) continue;
+      memset(&pm[npm], 0, sizeof(pm[npm]));
+      snprintf(pm[npm].name, sizeof(pm[npm].name), "%s", v[i].name);
+      ++npm;
+    }
+    pm[k].calls++;
+    pm[k].bytes    += v[i].arg_bytes + v[i].result_bytes;
+    pm[k].ser_us   += v[i].ser_ns/1e3;
+    pm[k].lib_us   += v[i].lib_ns/1e3;
+    pm[k].deser_us += v[i].deser_ns/1e3;
+  }
+  free(v);
+  if(!npm) return;
+  fprintf(g_txt, "  %-24s %9s %12s %12s %12s %10s %10s   (last %d spans)\n",
+    "method", "calls", "ser us", "lib us", "deser us", "KB/call", "marshal", n);
+  for(int k=0;k<npm;k++){
+    const PerMethod* p = &pm[k];
+    double all = p->ser_us + p->lib_us + p->deser_us;
+    fprintf(g_txt, "  %-24s %9lld %12.2f %12.2f %12.2f %10.2f %9.1f%%\n",
+      p->name, p->calls, p->ser_us/p->calls, p->lib_us/p->calls, p->deser_us/p->calls,
+      p->bytes/1024.0/p->calls, all>0 ? 100.0*(p->ser_us + p->deser_us)/all : 0.0);
+  }
+}
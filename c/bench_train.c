@@ -0,0 +1,75 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+/* --train[=STEP]: training throughput through paragon_train. A fresh handle per backend
+   sees TRAIN_ROWS labelled rows (label = row % outputs) in steps of STEP rows, shuffled,
+   for --warmup + --iters epochs; each measured epoch is one sample. Cross-entropy over
+   the first rows before and after shows the updates landed. */
+
+#define TRAIN_ROWS 256
+#define LOSS_ROWS  64
+
+static double xent(ParagonAPI* api, ParagonHandle h, const float* X, const int* lab,
+                   int n, int in_dim, int out_dim){
+  float* Y = malloc(sizeof(float)*(size_t)n*out_dim);
+  if(!Y) exit(1);
+  int got = paragon_forward_batch(api, h, X, n, in_dim, Y, out_dim);
+  double loss = 0.0;
+  for(int i=0;i<got;i++){
+    double p = Y[(size_t)i*out_dim + lab[i]];
+    loss += -log(p>1e-12 ? p : 1e-12);
+  }
+  free(Y);
+  return got>0 ? loss/got : NAN;
+}
+
+void bench_train(ParagonAPI* api, const BenchRecord* base, const int* dims, int ndims){
+  int in_dim = dims[0], out_dim = dims[ndims-1], n = TRAIN_ROWS;
+  float* X = malloc(sizeof(float)*(size_t)n*in_dim);
+  int* lab = malloc(sizeof(int)*(size_t)n);
+  double* v = malloc(sizeof(double)*(size_t)g_opt.iters);
+  if(!X || !lab || !v) exit(1);
+  for(int i=0;i<n;i++){ fill_lcg(X+(size_t)i*in_dim, in_dim, 2024u+(unsigned)i); lab[i] = i % out_dim; }
+
+  ParagonTrainOpts o;
+  paragon_train_defaults(&o);
+  o.step = g_opt.train_step;
+  o.shuffle = 1;
+  BenchRecord rec = *base;
+  rec.batch = o.step; rec.threads = 1;
+  fprintf(g_txt, "Training (%d rows, step %d, %s):\n", n, o.step,
+    (api->caps & PARAGON_CAP_TRAIN) ? "Train_F32" : "JSON Train");
+  for(int g=0; g<2; g++){
+    ParagonHandle h = bench_new_net(api, dims, ndims);
+    if(h<=0){ fprintf(stderr, "train: NewNetwork failed\n"); break; }
+    o.gpu = g;
+    int lrows = n<LOSS_ROWS ? n : LOSS_ROWS;
+    double before = xent(api, h, X, lab, lrows, in_dim, out_dim);
+    int steps = 0, failed = 0;
+    for(int i=0;i<g_opt.warmup + g_opt.iters && !failed;i++){
+      o.seed = 1u + (unsigned)i;
+      double t0 = now_ms();
+      int s = paragon_train_labels(api, h, X, n, in_dim, lab, out_dim, &o);
+      double dt = now_ms() - t0;
+      if(s<0){ failed = 1; break; }
+      steps += s;
+      if(i>=g_opt.warmup) v[i-g_opt.warmup] = dt;
+    }
+    if(failed){ fprintf(stderr, "train: %s training failed\n", g ? "GPU" : "CPU"); continue; }
+    double after = xent(api, h, X, lab, lrows, in_dim, out_dim);
+    Stats st; stats_of(v, g_opt.iters, &st);
+    double sps = st.p50>0 ? n*1000.0/st.p50 : 0.0;
+    fprintf(g_txt, "  %s  epoch p50 %.3f ms   %.1f samples/s   %d steps   loss %.4f -> %.4f\n",
+      g ? "GPU" : "CPU", st.p50, sps, steps, before, after);
+    snprintf(rec.backend, sizeof(rec.backend), "%s-train", g ? "gpu" : "cpu");
+    rec.st = st; rec.sps = sps;
+    bench_record(&rec);
+  }
+  free(X); free(lab); free(v);
+}
@@ -0,0 +1,544 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <dirent.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "paragon.h"
+
+/* loadgen: the MNIST serving path end to end under concurrency. Each request does what
+   the Go service does for one image: decode the PNG (or take an IDX record) to luma and
+   build the 28×28 input, marshal the Forward arguments (nothing to do when the library
+   exports Forward_F32), forward, then extract and take the argmax of the last 10
+   outputs. --clients handles come from a paragon pool, one per worker.
+
+   Closed loop: every client sends its next request when the last one is answered,
+   no faster than qps/clients when a rate is given. Open loop: Poisson arrivals at the
+   rate however long requests take, queued for the workers; latency then starts at the
+   arrival and includes the wait, and arrivals that find the queue full are dropped.
+   Every --qps level gets a latency distribution per stage and names the stage that
+   dominates it. */
+
+enum { ST_QUEUE, ST_DECODE, ST_MARSHAL, ST_FORWARD, ST_EXTRACT, ST_TOTAL, NSTAGES };
+static const char* STAGE[NSTAGES] = { "queue", "decode", "marshal", "forward", "extract", "total" };
+
+#define MAX_LEVELS  32
+#define MAX_CLIENTS 256
+#define DEFAULT_IMAGES "../golang/paragon_mnist_service_go/images"
+
+typedef struct {
+  const char* images;       /* PNG directory, PNG file or IDX file */
+  const char* model;        /* binary model file; Go's default shape when NULL */
+  int    open;
+  double qps[MAX_LEVELS];   /* load levels; closed loop with none runs unpaced */
+  int    nlevels;
+  int    clients;
+  double seconds;           /* per level */
+  int    warmup;            /* untimed requests per client before the first level */
+  int    queue;             /* open-loop queue capacity */
+  int    limit;             /* images kept from a directory or IDX file */
+  int    gpu;
+  const char* csv;
+} Opts;
+
+static Opts g = { .images = DEFAULT_IMAGES, .clients = 4, .seconds = 5.0, .warmup = 5,
+                  .queue = 1024, .limit = 10000 };
+
+typedef struct {
+  const unsigned char* bytes;   /* PNG file contents; NULL for an IDX record */
+  size_t               len;
+  ParagonImage         idx;
+} Source;
+
+typedef struct {
+  double t_sched;               /* open loop: arrival; closed: send */
+  double ms[NSTAGES];
+  int    ok, pred;
+} Req;
+
+typedef struct {
+  ParagonAPI*   api;
+  ParagonPool*  pool;
+  const Source* src;
+  int           nsrc;
+  int           rows, cols;     /* Forward grid */
+  int           iw, ih;         /* image the input is resized to */
+  int           out_dim;
+  /* the running level */
+  double        qps, t0, t_end;
+  Req*          reqs;           /* open loop: one slot per arrival */
+  size_t        cap;
+  ParagonMPMC   q;
+  int           done;           /* generator finished */
+} Ctx;
+
+typedef struct {
+  Ctx*         c;
+  int          id;
+  ParagonArena ar;
+  float*       x;
+  float*       y;
+  Req*         own;             /* closed loop: this client's requests */
+  size_t       n, cap;
+} Worker;
+
+static double now_ms(void){
+  struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec*1000.0 + ts.tv_nsec/1e6;
+}
+
+static void sleep_until(double ms){
+  struct timespec ts;
+  ts.tv_sec = (time_t)(ms/1000.0);
+  ts.tv_nsec = (long)((ms - ts.tv_sec*1000.0) * 1e6);
+  if(ts.tv_nsec>=1000000000L){ ts.tv_sec++; ts.tv_nsec -= 1000000000L; }
+  if(ts.tv_nsec<0) ts.tv_nsec = 0;
+  while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) ;
+}
+
+static int argmax(const float* v, int n){
+  int k = 0;
+  for(int i=1;i<n;i++) if(v[i]>v[k]) k = i;
+  return k;
+}
+
+/* queued: latency runs from r->t_sched (the arrival) rather than from the start */
+static void serve(Worker* w, ParagonHandle h, long long k, Req* r, int queued){
+  Ctx* c = w->c;
+  const Source* s = &c->src[k % c->nsrc];
+  double t0 = now_ms();
+  ParagonImage im = s->idx;
+  int ok = !s->bytes || paragon_png_decode(&w->ar, s->bytes, s->len, &im);
+  if(ok) paragon_image_input(&im, w->x, c->iw, c->ih);
+  double t1 = now_ms();
+  char* args = ok ? paragon_forward_args(c->api, &w->ar, w->x, c->rows, c->cols) : NULL;
+  double t2 = now_ms();
+  ok = ok && paragon_forward_with(c->api, h, w->x, c->rows, c->cols, args);
+  double t3 = now_ms();
+  int n = ok ? paragon_extract_f32(c->api, h, w->y, c->out_dim) : -1;
+  if(n>0) r->pred = argmax(w->y + (n>10 ? n-10 : 0), n>10 ? 10 : n);
+  double t4 = now_ms();
+  paragon_arena_reset(&w->ar);
+
+  r->ok = n>0;
+  r->ms[ST_QUEUE]   = queued ? t0 - r->t_sched : 0.0;
+  r->ms[ST_DECODE]  = t1 - t0;
+  r->ms[ST_MARSHAL] = t2 - t1;
+  r->ms[ST_FORWARD] = t3 - t2;
+  r->ms[ST_EXTRACT] = t4 - t3;
+  r->ms[ST_TOTAL]   = t4 - (queued ? r->t_sched : t0);
+}
+
+static Req* closed_slot(Worker* w){
+  if(w->n==w->cap){
+    size_t cap = w->cap ? 2*w->cap : 4096;
+    Req* v = realloc(w->own, sizeof(Req)*cap);
+    if(!v) return NULL;
+    w->own = v; w->cap = cap;
+  }
+  return &w->own[w->n++];
+}
+
+static void* worker_main(void* arg){
+  Worker* w = (Worker*)arg;
+  Ctx* c = w->c;
+  ParagonHandle h = paragon_pool_acquire(c->pool);
+  if(g.open){
+    for(int idle = 0;;){
+      long long k;
+      if(paragon_mpmc_pop(&c->q, &k)){ idle = 0; serve(w, h, k, &c->reqs[k], 1); continue; }
+      if(__atomic_load_n(&c->done, __ATOMIC_ACQUIRE)){
+        if(!paragon_mpmc_pop(&c->q, &k)) break;
+        serve(w, h, k, &c->reqs[k], 1);
+        continue;
+      }
+      if(++idle>64){ struct timespec ts = {0, 10000}; nanosleep(&ts, NULL); }
+    }
+  } else {
+    double interval = c->qps>0 ? 1000.0*g.clients/c->qps : 0.0;
+    double next = c->t0 + interval*w->id/g.clients;
+    for(long long k = w->id; ; k += g.clients){
+      if(interval>0 && next>now_ms()) sleep_until(next);
+      if(now_ms()>=c->t_end) break;
+      Req* r = closed_slot(w);
+      if(!r) break;
+      r->t_sched = now_ms();
+      serve(w, h, k, r, 0);
+      if(interval>0){ next += interval; double t = now_ms(); if(next<t) next = t; }
+    }
+  }
+  paragon_pool_release(c->pool, h);
+  return NULL;
+}
+
+/* ---- results ---- */
+
+typedef struct { int n; double mean, p50, p90, p99, max; } Dist;
+
+static int cmp_double(const void* a, const void* b){
+  double x=*(const double*)a, y=*(const double*)b;
+  return (x>y) - (x<y);
+}
+
+static double pct(const double* v, int n, double p){
+  int k = (int)ceil(p/100.0*n) - 1;
+  return v[k<0 ? 0 : k>=n ? n-1 : k];
+}
+
+static void dist_of(double* v, int n, Dist* d){
+  memset(d, 0, sizeof(*d));
+  d->n = n;
+  if(n<=0) return;
+  qsort(v, (size_t)n, sizeof(double), cmp_double);
+  double sum = 0.0;
+  for(int i=0;i<n;i++) sum += v[i];
+  d->mean = sum/n;
+  d->p50 = pct(v,n,50); d->p90 = pct(v,n,90); d->p99 = pct(v,n,99); d->max = v[n-1];
+}
+
+typedef struct {
+  double target, achieved;
+  long long sent, done, dropped, failed;
+  Dist   st[NSTAGES];
+  int    top;                   /* stage with the largest mean */
+  int    busiest;               /* same, leaving the queue out */
+} Level;
+
+static void summarize(const Req* const* rs, const size_t* ns, int nsets, Level* L){
+  size_t cap = 0;
+  for(int i=0;i<nsets;i++) cap += ns[i];
+  double* v = malloc(sizeof(double)*(cap ? cap : 1));
+  if(!v) exit(1);
+  for(int s=0; s<NSTAGES; ++s){
+    int n = 0;
+    for(int i=0;i<nsets;i++)
+      for(size_t j=0;j<ns[i];j++) if(rs[i][j].ok==1) v[n++] = rs[i][j].ms[s];
+    dist_of(v, n, &L->st[s]);
+  }
+  L->failed = 0;
+  for(int i=0;i<nsets;i++) for(size_t j=0;j<ns[i];j++) if(!rs[i][j].ok) ++L->failed;
+  free(v);
+  L->top = ST_DECODE; L->busiest = ST_DECODE;
+  for(int s=ST_QUEUE; s<ST_TOTAL; ++s){
+    if(L->st[s].mean>L->st[L->top].mean) L->top = s;
+    if(s!=ST_QUEUE && L->st[s].mean>L->st[L->busiest].mean) L->busiest = s;
+  }
+}
+
+static void print_level(const Ctx* c, const Level* L){
+  char rate[32];
+  if(L->target>0) snprintf(rate, sizeof(rate), "%.0f qps", L->target);
+  else snprintf(rate, sizeof(rate), "unpaced");
+  printf("\nLoad %s %s, %d clients, %.1f s: %lld sent, %lld done, %lld dropped, %lld failed, %.1f qps achieved\n",
+    g.open ? "open" : "closed", rate, g.clients, g.seconds,
+    L->sent, L->done, L->dropped, L->failed, L->achieved);
+  printf("  %-8s %9s %9s %9s %9s %9s %6s\n", "stage", "p50 ms", "p90 ms", "p99 ms", "max ms", "mean ms", "share");
+  for(int s=0; s<NSTAGES; ++s){
+    if(s==ST_QUEUE && !g.open) continue;
+    const Dist* d = &L->st[s];
+    double share = L->st[ST_TOTAL].mean>0 ? 100.0*d->mean/L->st[ST_TOTAL].mean : 0.0;
+    printf("  %-8s %9.3f %9.3f %9.3f %9.3f %9.3f %5.1f%%\n", STAGE[s], d->p50, d->p90, d->p99, d->max, d->mean, share);
+  }
+  if(c->api->Forward_F32) printf("  (Forward_F32 export: the input goes as floats, nothing to marshal)\n");
+  double service = L->st[ST_TOTAL].mean - L->st[ST_QUEUE].mean;
+  if(L->top==ST_QUEUE)
+    printf("  bottleneck: queue (workers saturated); busiest stage %s, %.0f%% of service time\n",
+      STAGE[L->busiest], service>0 ? 100.0*L->st[L->busiest].mean/service : 0.0);
+  else
+    printf("  bottleneck: %s\n", STAGE[L->top]);
+}
+
+static void csv_level(FILE* f, const Level* L){
+  for(int s=0; s<NSTAGES; ++s){
+    const Dist* d = &L->st[s];
+    fprintf(f, "%s,%.1f,%d,%.2f,%lld,%lld,%lld,%lld,%s,%d,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+      g.open ? "open" : "closed", L->target, g.clients, L->achieved, L->sent, L->done,
+      L->dropped, L->failed, STAGE[s], d->n, d->mean, d->p50, d->p90, d->p99, d->max);
+  }
+}
+
+/* ---- one level ---- */
+
+static unsigned long long g_rng = 0x853c49e6748fea9bull;
+static double uniform01(void){
+  g_rng = g_rng*6364136223846793005ull + 1442695040888963407ull;
+  return (double)(g_rng >> 11) * (1.0/9007199254740992.0);
+}
+
+static void run_level(Ctx* c, Worker* ws, double qps, Level* L){
+  memset(L, 0, sizeof(*L));
+  L->target = qps;
+  c->qps = qps; c->done = 0;
+  if(g.open){
+    c->cap = (size_t)(qps*g.seconds*1.5) + 64;
+    c->reqs = calloc(c->cap, sizeof(Req));
+    if(!c->reqs || !paragon_mpmc_init(&c->q, (size_t)g.queue)){ fprintf(stderr, "loadgen: out of memory\n"); exit(1); }
+  }
+  for(int i=0;i<g.clients;i++) ws[i].n = 0;
+  c->t0 = now_ms() + 1.0;
+  c->t_end = c->t0 + g.seconds*1000.0;
+  pthread_t th[MAX_CLIENTS];
+  for(int i=0;i<g.clients;i++) pthread_create(&th[i], NULL, worker_main, &ws[i]);
+
+  size_t nreq = 0;
+  if(g.open){
+    double t = c->t0;
+    for(;;){
+      t += -log(1.0 - uniform01()) * 1000.0/qps;
+      if(t>=c->t_end) break;
+      ++L->sent;
+      if(nreq==c->cap){ ++L->dropped; continue; }
+      sleep_until(t);
+      Req* r = &c->reqs[nreq];
+      r->t_sched = t; r->ok = -1;
+      if(paragon_mpmc_push(&c->q, (long long)nreq)) ++nreq;
+      else ++L->dropped;
+    }
+    __atomic_store_n(&c->done, 1, __ATOMIC_RELEASE);
+  }
+  for(int i=0;i<g.clients;i++) pthread_join(th[i], NULL);
+  double elapsed = now_ms() - c->t0;
+
+  if(g.open){
+    const Req* rs[1] = { c->reqs };
+    size_t ns[1] = { nreq };
+    summarize(rs, ns, 1, L);
+    paragon_mpmc_free(&c->q);
+    free(c->reqs); c->reqs = NULL;
+  } else {
+    const Req* rs[MAX_CLIENTS];
+    size_t ns[MAX_CLIENTS];
+    for(int i=0;i<g.clients;i++){ rs[i] = ws[i].own; ns[i] = ws[i].n; L->sent += (long long)ws[i].n; }
+    summarize(rs, ns, g.clients, L);
+  }
+  L->done = L->st[ST_TOTAL].n;
+  L->achieved = elapsed>0 ? L->done*1000.0/elapsed : 0.0;
+}
+
+/* ---- inputs ---- */
+
+static unsigned char* read_file(const char* path, size_t* len){
+  FILE* f = fopen(path, "rb");
+  if(!f) return NULL;
+  unsigned char* b = NULL;
+  if(!fseek(f, 0, SEEK_END)){
+    long n = ftell(f);
+    if(n>=0 && !fseek(f, 0, SEEK_SET) && (b = malloc((size_t)n + 1))){
+      if(fread(b, 1, (size_t)n, f)!=(size_t)n){ free(b); b = NULL; }
+      else *len = (size_t)n;
+    }
+  }
+  fclose(f);
+  return b;
+}
+
+static int cmp_name(const void* a, const void* b){ return strcmp(*(char* const*)a, *(char* const*)b); }
+
+static int add_png(Source* src, int n, unsigned char* bytes, size_t len, const char* name){
+  ParagonArena ar; paragon_arena_init(&ar, 4096);
+  ParagonImage im;
+  int ok = paragon_png_decode(&ar, bytes, len, &im);
+  paragon_arena_free(&ar);
+  if(!ok){ fprintf(stderr, "loadgen: skipping %s: not a PNG this decoder reads\n", name); free(bytes); return n; }
+  src[n].bytes = bytes; src[n].len = len;
+  return n + 1;
+}
+
+/* the replay set; IDX images point into *keep, which lives as long as the sources */
+static Source* load_sources(const char* path, int* count, unsigned char** keep){
+  *count = 0; *keep = NULL;
+  struct stat sb;
+  if(stat(path, &sb)){ fprintf(stderr, "loadgen: cannot open %s\n", path); return NULL; }
+  Source* src = calloc((size_t)g.limit, sizeof(Source));
+  if(!src) return NULL;
+  int n = 0;
+  if(S_ISDIR(sb.st_mode)){
+    DIR* d = opendir(path);
+    char** names = NULL;
+    int nn = 0, cap = 0;
+    for(struct dirent* e; d && (e = readdir(d)); ){
+      size_t l = strlen(e->d_name);
+      if(l<4 || strcasecmp(e->d_name + l - 4, ".png")) continue;
+      if(nn==cap){ cap = cap ? 2*cap : 64; char** v = realloc(names, sizeof(char*)*(size_t)cap); if(!v) break; names = v; }
+      names[nn++] = strdup(e->d_name);
+    }
+    if(d) closedir(d);
+    if(nn) qsort(names, (size_t)nn, sizeof(char*), cmp_name);
+    for(int i=0;i<nn;i++){
+      char full[4096];
+      snprintf(full, sizeof(full), "%s/%s", path, names[i]);
+      size_t len = 0;
+      unsigned char* b = n<g.limit ? read_file(full, &len) : NULL;
+      if(b) n = add_png(src, n, b, len, full);
+      free(names[i]);
+    }
+    free(names);
+  } else {
+    size_t len = 0;
+    unsigned char* b = read_file(path, &len);
+    int ni, r, cl;
+    const unsigned char* px;
+    if(!b) fprintf(stderr, "loadgen: cannot read %s\n", path);
+    else if(paragon_idx_images(b, len, &ni, &r, &cl, &px)){
+      for(int i=0; i<ni && n<g.limit; ++i, ++n){
+        src[n].idx.w = cl; src[n].idx.h = r; src[n].idx.px = px + (size_t)i*r*cl;
+      }
+      *keep = b;
+    } else n = add_png(src, 0, b, len, path);
+  }
+  if(!n){
+    fprintf(stderr, "loadgen: no images in %s (the Go service writes 0.png..9.png there on first run; "
+                    "an MNIST IDX image file works too)\n", path);
+    free(src); return NULL;
+  }
+  *count = n;
+  return src;
+}
+
+static void usage(const char* argv0){
+  fprintf(stderr,
+    "usage: %s [lib.so] [--images=DIR|FILE] [--model=FILE] [--open|--closed] [--qps=N[,N...]]\n"
+    "          [--clients=N] [--seconds=S] [--warmup=N] [--queue=N] [--limit=N] [--gpu] [--csv=FILE]\n"
+    "  --images=   directory of PNGs, one PNG, or an MNIST IDX image file (default %s)\n"
+    "  --model=    binary model file (see bench --model-dir); default 28x28 -> 256 relu -> 10 softmax\n"
+    "  --closed    each client waits for its answer, then sends again (default); with --qps paced to qps/clients\n"
+    "  --open      Poisson arrivals at --qps whatever the latency, queued for the clients; needs --qps\n"
+    "  --qps=      load levels, run in order (e.g. --qps=100,200,400,800)\n"
+    "  --clients=  worker threads, one pooled handle each (default 4)\n"
+    "  --seconds=  time per level (default 5)\n"
+    "  --warmup=   untimed requests per client before the first level (default 5)\n"
+    "  --queue=    open-loop queue capacity; arrivals beyond it are dropped (default 1024)\n"
+    "  --limit=    images kept from a directory or IDX file (default 10000)\n"
+    "  --gpu       GPU-initialize every handle\n"
+    "  --csv=      one row per level and stage\n",
+    argv0, DEFAULT_IMAGES);
+}
+
+static int parse_levels(const char* s){
+  g.nlevels = 0;
+  for(char* e; *s && g.nlevels<MAX_LEVELS; s = *e ? e+1 : e){
+    double v = strtod(s, &e);
+    if(e==s || v<=0 || (*e && *e!=',')) return 0;
+    g.qps[g.nlevels++] = v;
+  }
+  return g.nlevels>0;
+}
+
+int main(int argc, char** argv){
+  const char* so = (argc>1 && argv[1][0]!='-') ? argv[1] : NULL;
+  for(int i=1;i<argc;i++){
+    const char* a = argv[i];
+    if(a[0]!='-') continue;
+    if(!strncmp(a,"--images=",9))        g.images = a+9;
+    else if(!strncmp(a,"--model=",8))    g.model = a+8;
+    else if(!strcmp(a,"--open"))         g.open = 1;
+    else if(!strcmp(a,"--closed"))       g.open = 0;
+    else if(!strncmp(a,"--qps=",6))    { if(!parse_levels(a+6)){ usage(argv[0]); return 2; } }
+    else if(!strncmp(a,"--clients=",10)) g.clients = atoi(a+10);
+    else if(!strncmp(a,"--seconds=",10)) g.seconds = atof(a+10);
+    else if(!strncmp(a,"--warmup=",9))   g.warmup = atoi(a+9);
+    else if(!strncmp(a,"--queue=",8))    g.queue = atoi(a+8);
+    else if(!strncmp(a,"--limit=",8))    g.limit = atoi(a+8);
+    else if(!strcmp(a,"--gpu"))          g.gpu = 1;
+    else if(!strncmp(a,"--csv=",6))      g.csv = a+6;
+    else { usage(argv[0]); return 2; }
+  }
+  if(g.clients<1 || g.clients>MAX_CLIENTS || g.seconds<=0 || g.queue<1 || g.limit<1 || (g.open && !g.nlevels)){
+    usage(argv[0]); return 2;
+  }
+  if(g.warmup<0) g.warmup = 0;
+  if(!g.nlevels){ g.nlevels = 1; g.qps[0] = 0; }   /* closed, unpaced */
+
+  int nsrc;
+  unsigned char* idx_file;
+  Source* src = load_sources(g.images, &nsrc, &idx_file);
+  if(!src) return 1;
+
+  ParagonAPI api;
+  if(!paragon_load(&api, so)) return 1;
+  char caps[512];
+  paragon_caps_string(&api, caps, sizeof(caps));
+  printf("Capabilities: %s\n", caps[0] ? caps : "none");
+
+  Ctx c = { .api = &api, .src = src, .nsrc = nsrc };
+  int flags = g.gpu ? PARAGON_POOL_GPU : 0;
+  ParagonModel m;
+  int have_model = 0;
+  if(g.model){
+    if(!paragon_model_open(&m, g.model)) return 1;
+    have_model = 1;
+    ParagonHandle hs[MAX_CLIENTS];
+    for(int i=0;i<g.clients;i++)
+      if((hs[i] = paragon_new_from_model(&api, &m, g.gpu, NULL))<=0){ fprintf(stderr, "loadgen: cannot build handle %d from %s\n", i, g.model); return 1; }
+    c.pool = paragon_pool_adopt(&api, hs, g.clients, flags);
+    c.cols = m.width[0]; c.rows = m.height[0]>0 ? m.height[0] : 1;
+    c.out_dim = m.dims[m.nlayers-1];
+  } else {
+    c.pool = paragon_pool_new(&api,
+      "[{\"Width\":28,\"Height\":28},{\"Width\":256,\"Height\":1},{\"Width\":10,\"Height\":1}]",
+      "[\"linear\",\"relu\",\"softmax\"]", NULL, g.clients, flags | PARAGON_POOL_INFERENCE);
+    c.cols = 28; c.rows = 28; c.out_dim = 10;
+  }
+  if(!c.pool){ fprintf(stderr, "loadgen: could not build the handle pool\n"); return 1; }
+  c.iw = c.cols; c.ih = c.rows;
+  if(c.rows==1){     /* a flat input layer still takes a square image */
+    int s = (int)lround(sqrt((double)c.cols));
+    if(s*s==c.cols){ c.iw = c.ih = s; }
+  }
+  printf("Replaying %d image%s from %s through %s (%dx%d input, %d outputs), %s loop\n",
+    nsrc, nsrc==1 ? "" : "s", g.images, g.model ? g.model : "the Go service's default shape",
+    c.rows, c.cols, c.out_dim, g.open ? "open" : "closed");
+
+  Worker ws[MAX_CLIENTS];
+  memset(ws, 0, sizeof(ws));
+  for(int i=0;i<g.clients;i++){
+    ws[i].c = &c; ws[i].id = i;
+    paragon_arena_init(&ws[i].ar, (size_t)c.rows*c.cols*16 + 65536);
+    ws[i].x = malloc(sizeof(float)*(size_t)c.rows*c.cols);
+    ws[i].y = malloc(sizeof(float)*(size_t)c.out_dim);
+    if(!ws[i].x || !ws[i].y){ fprintf(stderr, "loadgen: out of memory\n"); return 1; }
+  }
+  for(int i=0;i<g.warmup*g.clients;i++){
+    Req r = {0};
+    ParagonHandle h = paragon_pool_acquire(c.pool);
+    serve(&ws[0], h, i, &r, 0);
+    paragon_pool_release(c.pool, h);
+  }
+
+  FILE* csv = NULL;
+  if(g.csv){
+    if(!(csv = fopen(g.csv, "w"))){ fprintf(stderr, "loadgen: cannot write %s\n", g.csv); return 1; }
+    fprintf(csv, "mode,target_qps,clients,achieved_qps,sent,done,dropped,failed,stage,n,mean_ms,p50_ms,p90_ms,p99_ms,max_ms\n");
+  }
+  Level L[MAX_LEVELS];
+  for(int k=0;k<g.nlevels;k++){
+    run_level(&c, ws, g.qps[k], &L[k]);
+    print_level(&c, &L[k]);
+    if(csv) csv_level(csv, &L[k]);
+  }
+  if(g.nlevels>1){
+    printf("\nSummary (%s loop, %d clients):\n", g.open ? "open" : "closed", g.clients);
+    printf("  %8s %9s %8s %11s %11s  %s\n", "target", "achieved", "dropped", "total p50", "total p99", "bottleneck");
+    for(int k=0;k<g.nlevels;k++){
+      double share = L[k].st[ST_TOTAL].mean>0 ? 100.0*L[k].st[L[k].top].mean/L[k].st[ST_TOTAL].mean : 0.0;
+      printf("  %8.1f %9.1f %8lld %11.3f %11.3f  %s %.0f%%\n", L[k].target, L[k].achieved, L[k].dropped,
+        L[k].st[ST_TOTAL].p50, L[k].st[ST_TOTAL].p99, STAGE[L[k].top], share);
+    }
+  }
+  int rc = 0;
+  if(csv && fclose(csv)){ fprintf(stderr, "loadgen: write to %s failed\n", g.csv); rc = 1; }
+
+  for(int i=0;i<g.clients;i++){ paragon_arena_free(&ws[i].ar); free(ws[i].x); free(ws[i].y); free(ws[i].own); }
+  paragon_pool_free(c.pool);
+  if(have_model) paragon_model_close(&m);
+  for(int i=0;i<nsrc;i++) free((void*)src[i].bytes);
+  free(src); free(idx_file);
+  paragon_unload(&api);
+  return rc;
+}
@@ -1,8 +1,13 @@
+#ifndef _GNU_SOURCE
 #define _GNU_SOURCE
+#endif
 #include <dlfcn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "paragon.h"
 
 static void* must_dlsym_try(void* so, const char* name){
@@ -13,17 +18,55 @@ static void* must_dlsym_try(void* so, const char* name){
   return p;
 }
 
-static void* resolve_any(void* so, const char* const names[]){
+/* *hit (nullable) gets the index of the name that resolved */
+static void* resolve_any(ParagonAPI* api, const char* const names[], int* hit){
   for(int i=0; names[i]; ++i){
-    void* p = must_dlsym_try(so, names[i]);
+    void* p = must_dlsym_try(api->so, names[i]);
+    ++api->load.symbols;
+    if(p){ if(hit) *hit = i; return p; }
+  }
+  return NULL;
+}
+
+/* Paragon_<name>, Teleport_<name>, <name>; the prefix the core symbols used goes first */
+static void* resolve_prefixed(ParagonAPI* api, const char* base){
+  static const char* const PREFIX[] = { "Paragon_", "Teleport_", "" };
+  char name[128];
+  for(int k=0; k<3; ++k){
+    int i = k==0 ? api->sym_prefix : (k<=api->sym_prefix ? k-1 : k);
+    snprintf(name, sizeof(name), "%s%s", PREFIX[i], base);
+    void* p = must_dlsym_try(api->so, name);
+    ++api->load.symbols;
     if(p) return p;
   }
   return NULL;
 }
 
+/* ISO C has no object->function pointer cast; dlsym's result is copied bytewise
+   into the fn_* slot instead (POSIX guarantees the representations match) */
+static void set_fn(void* slot, void* sym){
+  memcpy(slot, &sym, sizeof(sym));
+}
+
+static double mono_ms(void){
+  struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec*1000.0 + ts.tv_nsec/1e6;
+}
+
 int paragon_load(ParagonAPI* api, const char* so_path){
+  return paragon_load_ex(api, so_path, 0);
+}
+
+int paragon_load_ex(ParagonAPI* api, const char* so_path, unsigned flags){
   memset(api, 0, sizeof(*api));
-  api->so = dlopen(so_path && *so_path ? so_path : NULL, RTLD_NOW | RTLD_GLOBAL);
+  api->gpu_enable = -1;
+  paragon_registry_init(api);
+  double t0 = mono_ms();
+  api->load.lazy = (flags & PARAGON_LOAD_LAZY)!=0;
+  api->so = dlopen(so_path && *so_path ? so_path : NULL,
+                   (api->load.lazy ? RTLD_LAZY : RTLD_NOW) | RTLD_GLOBAL);
+  double t1 = mono_ms();
+  api->load.dlopen_ms = t1 - t0;
   if(!api->so){
     fprintf(stderr, "dlopen failed (%s): %s\n", so_path?so_path:"<NULL>", dlerror());
     return 1; /* keep running; we’ll no-op gracefully */
@@ -49,20 +92,75 @@ int paragon_load(ParagonAPI* api, const char* so_path){
     NULL
   };
 
-  api->New5 = (fn_NewNetworkFloat32_5) resolve_any(api->so, NEW5);
-  api->New3 = (fn_NewNetworkFloat32_3) resolve_any(api->so, NEW3);
-  api->Call = (fn_Call)                 resolve_any(api->so, CALLN);
+  int hit = 0;
+  set_fn(&api->New5, resolve_any(api, NEW5, &hit));
+  set_fn(&api->New3, resolve_any(api, NEW3, api->New5 ? NULL : &hit));
+  set_fn(&api->Call, resolve_any(api, CALLN, api->New5 || api->New3 ? NULL : &hit));
+  api->sym_prefix = hit;
+
+  /* Optional raw-buffer entry points; absent ones fall back to JSON quietly */
+  set_fn(&api->Forward_F32,        resolve_prefixed(api, "Forward_F32"));
+  set_fn(&api->ExtractOutput_F32,  resolve_prefixed(api, "ExtractOutput_F32"));
+  set_fn(&api->ForwardBatch_F32,   resolve_prefixed(api, "ForwardBatch_F32"));
+  set_fn(&api->ForwardGroup_F32,   resolve_prefixed(api, "ForwardGroup_F32"));
+  set_fn(&api->RegisterStaging,    resolve_prefixed(api, "RegisterStaging_F32"));
+  set_fn(&api->ForwardStaged,      resolve_prefixed(api, "ForwardStaged_F32"));
+  set_fn(&api->UnregisterStaging,  resolve_prefixed(api, "UnregisterStaging"));
+  set_fn(&api->MethodID,           resolve_prefixed(api, "MethodID"));
+  set_fn(&api->CallID,             resolve_prefixed(api, "CallID"));
+
+  set_fn(&api->ExportGPUCache,     resolve_prefixed(api, "ExportGPUCache"));
+  set_fn(&api->ImportGPUCache,     resolve_prefixed(api, "ImportGPUCache"));
+  set_fn(&api->Version,            resolve_prefixed(api, "Version"));
+  set_fn(&api->NewFromModel,       resolve_prefixed(api, "NewNetworkFromModel"));
+  set_fn(&api->SetLayerWeights,    resolve_prefixed(api, "SetLayerWeights_F32"));
+  set_fn(&api->SetLayerWeightsQ,   resolve_prefixed(api, "SetLayerWeights_Q"));
+  set_fn(&api->AdapterCount,       resolve_prefixed(api, "AdapterCount"));
+  set_fn(&api->AdapterInfo,        resolve_prefixed(api, "AdapterInfo"));
+  set_fn(&api->InitGPUOn,          resolve_prefixed(api, "InitializeOptimizedGPUOn"));
+  set_fn(&api->PerturbWeights,     resolve_prefixed(api, "PerturbWeights"));
+  set_fn(&api->Train_F32,          resolve_prefixed(api, "Train_F32"));
+  set_fn(&api->SetDeterministic,   resolve_prefixed(api, "SetDeterministic"));
+  set_fn(&api->MemoryInfo,         resolve_prefixed(api, "MemoryInfo"));
+  set_fn(&api->SetInferenceOnly,   resolve_prefixed(api, "SetInferenceOnly"));
+  set_fn(&api->FreeNetwork,        resolve_prefixed(api, "FreeNetwork"));
+  struct stat sb;
+  if(api->Version && api->Version())
+    snprintf(api->lib_version, sizeof(api->lib_version), "%s", api->Version());
+  else if(so_path && *so_path && !stat(so_path, &sb))
+    snprintf(api->lib_version, sizeof(api->lib_version), "%lld-%lld",
+             (long long)sb.st_size, (long long)sb.st_mtime);
+  else
+    snprintf(api->lib_version, sizeof(api->lib_version), "self");
+
+  /* whatever frees the char* results; libc free() otherwise (cgo C.CString is malloc'd) */
+  const char* FREEN[] = {
+    "Paragon_FreeResult", "Teleport_FreeResult", "FreeResult",
+    "Paragon_FreeCString", "Teleport_FreeCString", "FreeCString",
+    "Paragon_Free", "Teleport_Free",
+    NULL
+  };
+  set_fn(&api->FreeResult, resolve_any(api, FREEN, NULL));
+  double t2 = mono_ms();
+  api->load.resolve_ms = t2 - t1;
 
   if(!api->New5 && !api->New3 && !api->Call){
     fprintf(stderr, "No compatible symbols found: NewNetworkFloat32/Call.\n");
   }
+  if(!(flags & PARAGON_LOAD_NO_PROBE)) paragon_probe(api);
+  double t3 = mono_ms();
+  api->load.probe_ms = t3 - t2;
+  api->load.total_ms = t3 - t0;
+  paragon_trace_env(api);
   return 1;
 }
 
 void paragon_unload(ParagonAPI* api){
   if(!api) return;
+  paragon_trace_free(api);
   if(api->so){ dlclose(api->so); api->so = NULL; }
-  api->New5 = NULL; api->New3 = NULL; api->Call = NULL;
+  paragon_registry_free(api);
+  memset(api, 0, sizeof(*api));
 }
 
 /* Robust handle parser (bare integer string, {handle: N}, {result:{handle:N}}, …) */
@@ -72,6 +170,11 @@ ParagonHandle paragon_parse_handle(const char* txt){
   char* endp = NULL;
   long long v = strtoll(txt, &endp, 10);
   if(endp && *endp=='\0') return v;
+  /* 2) the common {"handle":N,...} spelling without scanning */
+  if(!strncmp(txt, "{\"handle\":", 10)){
+    v = strtoll(txt+10, &endp, 10);
+    if(endp != txt+10) return v;
+  }
 
   const char* keys[] = {
     "\"handle\"", "\"Handle\"", "\"id\"", "\"ID\"",
@@ -100,7 +203,285 @@ ParagonHandle paragon_parse_handle(const char* txt){
 
 char* paragon_call0(ParagonAPI* api, ParagonHandle h, const char* method){
   if(!api || !api->Call) return NULL;
-  return api->Call(h, method, "[]");
+  int t = paragon_mem_touch(api, h);
+  if(t<0) return NULL;
+  ParagonSpan sp; paragon_span_begin(api, &sp, method, h);
+  char* r = api->Call(h, method, "[]");
+  paragon_span_ret(&sp);
+  paragon_span_end(&sp, 2, sp.t && r ? (long long)strlen(r) : 0);
+  paragon_mem_untouch(api, h, t);
+  if(!strcmp(method, "ToggleGPU")) paragon_gpu_toggled(api, h, r);
+  if(strcmp(method, "Forward") && strcmp(method, "ExtractOutput")) paragon_weights_changed(api, h);
+  return r;
+}
+
+void paragon_free_result(ParagonAPI* api, char* r){
+  if(!r) return;
+  if(api && api->FreeResult){ api->FreeResult(r); return; }
+#ifndef PARAGON_KEEP_RESULTS
+  free(r);
+#endif
+}
+
+/* Forward args as [[[r0...],[r1...],...]]; %.9g round-trips float32 exactly */
+static char* json_rows_f32(ParagonArena* a, const float* x, int rows, int cols){
+  size_t cap = (size_t)rows*cols*16 + (size_t)rows*4 + 16;
+  char* b = (char*)paragon_arena_alloc(a, cap);
+  if(!b) return NULL;
+  size_t len = 0;
+  b[len++]='['; b[len++]='[';
+  for(int r=0; r<rows; ++r){
+    if(r) b[len++]=',';
+    b[len++]='[';
+    for(int c=0; c<cols; ++c){
+      len += (size_t)snprintf(b+len, cap-len, c?",%.9g":"%.9g", (double)x[(size_t)r*cols+c]);
+    }
+    b[len++]=']';
+  }
+  b[len++]=']'; b[len++]=']'; b[len]=0;
+  return b;
+}
+
+static int forward_raw(ParagonAPI* api, ParagonHandle h, ParagonSpan* sp,
+                       const float* x, int rows, int cols){
+  int ok = api->Forward_F32(h, x, rows, cols)==0;
+  paragon_span_ret(sp);
+  paragon_span_end(sp, (long long)rows*cols*(long long)sizeof(float), 0);
+  return ok;
+}
+
+static int forward_json(ParagonAPI* api, ParagonHandle h, ParagonSpan* sp, const char* args){
+  paragon_span_lib(sp);
+  char* r = paragon_call_id(api, h, PARAGON_M_FORWARD, args);
+  paragon_span_ret(sp);
+  long long nargs = sp->t ? (long long)strlen(args) : 0, nres = sp->t && r ? (long long)strlen(r) : 0;
+  int ok = r && !strstr(r, "\"error\"");   /* a failed Forward leaves the last output behind */
+  paragon_free_result(api, r);
+  paragon_span_end(sp, nargs, nres);
+  return ok;
+}
+
+static int forward_f32(ParagonAPI* api, ParagonHandle h, const float* x, int rows, int cols){
+  ParagonSpan sp; paragon_span_begin(api, &sp, "Forward", h);
+  if(api->Forward_F32) return forward_raw(api, h, &sp, x, rows, cols);
+  if(!api->Call){ paragon_span_end(&sp, 0, 0); return 0; }
+  ParagonArena* sc = paragon_scratch();
+  char* args = sc ? json_rows_f32(sc, x, rows, cols) : NULL;
+  if(!args){ paragon_span_end(&sp, 0, 0); return 0; }
+  int ok = forward_json(api, h, &sp, args);
+  paragon_arena_reset(sc);
+  return ok;
+}
+
+/* Each entry point below holds the handle in flight (paragon_mem_touch) around its
+   library calls, so an EVICT budget cannot free it underneath them */
+int paragon_forward_f32(ParagonAPI* api, ParagonHandle h,
+                        const float* x, int rows, int cols){
+  if(!api || !x || rows<=0 || cols<=0) return 0;
+  int t = paragon_mem_touch(api, h);
+  if(t<0) return 0;
+  int ok = forward_f32(api, h, x, rows, cols);
+  paragon_mem_untouch(api, h, t);
+  return ok;
+}
+
+char* paragon_forward_args(ParagonAPI* api, ParagonArena* a, const float* x, int rows, int cols){
+  if(!api || !a || !x || rows<=0 || cols<=0 || api->Forward_F32 || !api->Call) return NULL;
+  return json_rows_f32(a, x, rows, cols);
+}
+
+int paragon_forward_with(ParagonAPI* api, ParagonHandle h, const float* x, int rows, int cols,
+                         const char* args){
+  if(!api || !x || rows<=0 || cols<=0) return 0;
+  int t = paragon_mem_touch(api, h);
+  if(t<0) return 0;
+  ParagonSpan sp; paragon_span_begin(api, &sp, "Forward", h);
+  int ok = 0;
+  if(api->Forward_F32) ok = forward_raw(api, h, &sp, x, rows, cols);
+  else if(!api->Call || !args) paragon_span_end(&sp, 0, 0);
+  else ok = forward_json(api, h, &sp, args);
+  paragon_mem_untouch(api, h, t);
+  return ok;
+}
+
+static int extract_f32(ParagonAPI* api, ParagonHandle h, float* out, int cap){
+  ParagonSpan sp; paragon_span_begin(api, &sp, "ExtractOutput", h);
+  if(api->ExtractOutput_F32){
+    int n = api->ExtractOutput_F32(h, out, cap);
+    paragon_span_ret(&sp);
+    if(n>cap) n = cap;
+    paragon_span_end(&sp, 0, n>0 ? (long long)n*(long long)sizeof(float) : 0);
+    return n<0 ? -1 : n;
+  }
+  if(!api->Call){ paragon_span_end(&sp, 0, 0); return -1; }
+  char* r = paragon_call_id(api, h, PARAGON_M_EXTRACT_OUTPUT, "[]");
+  paragon_span_ret(&sp);
+  if(!r){ paragon_span_end(&sp, 2, 0); return -1; }
+  int n = paragon_parse_floats(r, out, cap);
+  long long nres = sp.t ? (long long)strlen(r) : 0;
+  paragon_free_result(api, r);
+  paragon_span_end(&sp, 2, nres);
+  return n;
+}
+
+int paragon_extract_f32(ParagonAPI* api, ParagonHandle h, float* out, int cap){
+  if(!api || !out || cap<=0) return -1;
+  int t = paragon_mem_touch(api, h);
+  if(t<0) return -1;
+  int n = extract_f32(api, h, out, cap);
+  paragon_mem_untouch(api, h, t);
+  return n;
+}
+
+static int forward_batch(ParagonAPI* api, ParagonHandle h,
+                         const float* X, int n, int dim,
+                         float* Y, int out_dim){
+  if(api->ForwardBatch_F32){
+    ParagonSpan sp; paragon_span_begin(api, &sp, "ForwardBatch", h);
+    int r = api->ForwardBatch_F32(h, X, n, dim, Y, out_dim);
+    paragon_span_ret(&sp);
+    paragon_span_end(&sp, (long long)n*dim*(long long)sizeof(float),
+                     r>0 ? (long long)r*out_dim*(long long)sizeof(float) : 0);
+    return r<0 ? -1 : r;
+  }
+  /* Forward takes one sample (a Height×Width grid), so rows go one at a time
+     (each row's forward and extract are their own spans) */
+  for(int i=0; i<n; ++i){
+    float* y = Y + (size_t)i*out_dim;
+    if(!forward_f32(api, h, X + (size_t)i*dim, 1, dim)) return i ? i : -1;
+    int got = extract_f32(api, h, y, out_dim);
+    if(got<0) return i ? i : -1;
+    if(got<out_dim) memset(y+got, 0, (size_t)(out_dim-got)*sizeof(float));
+  }
+  return n;
+}
+
+int paragon_forward_batch(ParagonAPI* api, ParagonHandle h,
+                          const float* X, int n, int dim,
+                          float* Y, int out_dim){
+  if(!api || !X || !Y || n<=0 || dim<=0 || out_dim<=0) return -1;
+  int t = paragon_mem_touch(api, h);
+  if(t<0) return -1;
+  int r = forward_batch(api, h, X, n, dim, Y, out_dim);
+  paragon_mem_untouch(api, h, t);
+  return r;
+}
+
+int paragon_forward_group(ParagonAPI* api, const ParagonHandle* hs, int n,
+                          const float* x, int dim,
+                          float* const* outs, const int* out_caps, int* counts){
+  if(!api || !hs || !x || !outs || !out_caps || n<=0 || dim<=0) return -1;
+  ParagonArena* sc = paragon_scratch();
+  int* cnt = counts ? counts : sc ? (int*)paragon_arena_alloc(sc, sizeof(int)*(size_t)n) : NULL;
+  if(!cnt) return -1;
+  long long in_bytes = (long long)dim*(long long)sizeof(float), out_bytes = 0;
+  int done = 0;
+  signed char* pin = NULL;
+  if(__atomic_load_n(&api->mem.touch, __ATOMIC_RELAXED)){
+    pin = sc ? (signed char*)paragon_arena_alloc(sc, (size_t)n) : NULL;
+    if(!pin){ if(sc) paragon_arena_reset(sc); return -1; }
+    memset(pin, 0, (size_t)n);
+    for(int i=0;i<n;i++)
+      if((pin[i] = (signed char)paragon_mem_touch(api, hs[i]))<0){ done = -1; goto out; }
+  }
+  ParagonSpan sp; paragon_span_begin(api, &sp, "ForwardGroup", hs[0]);
+  if(api->ForwardGroup_F32){
+    int r = api->ForwardGroup_F32(hs, n, x, dim, outs, out_caps, cnt);
+    paragon_span_ret(&sp);
+    for(int i=0;i<n;i++){
+      if(r!=0) cnt[i] = -1;
+      else if(cnt[i]>out_caps[i]) cnt[i] = out_caps[i];
+    }
+  } else {
+    /* all forwards first, so a library that queues GPU work can overlap the handles;
+       the JSON input is built once and handed to every Forward */
+    char* args = NULL;
+    if(!api->Forward_F32){
+      args = sc && api->Call ? json_rows_f32(sc, x, 1, dim) : NULL;
+      if(!args){ done = -1; paragon_span_end(&sp, 0, 0); goto out; }
+      in_bytes = (long long)strlen(args);
+    }
+    paragon_span_lib(&sp);
+    for(int i=0;i<n;i++){
+      if(args){
+        char* r = paragon_call_id(api, hs[i], PARAGON_M_FORWARD, args);
+        cnt[i] = r && !strstr(r, "\"error\"") ? 0 : -1;
+        paragon_free_result(api, r);
+      }
+      else cnt[i] = api->Forward_F32(hs[i], x, 1, dim)==0 ? 0 : -1;
+    }
+    for(int i=0;i<n;i++)
+      cnt[i] = cnt[i]<0 || out_caps[i]<=0 ? -1 : extract_f32(api, hs[i], outs[i], out_caps[i]);
+    paragon_span_ret(&sp);
+    in_bytes *= n;
+  }
+  for(int i=0;i<n;i++)
+    if(cnt[i]>0){ ++done; out_bytes += (long long)cnt[i]*(long long)sizeof(float); }
+  paragon_span_end(&sp, in_bytes, out_bytes);
+out:
+  if(pin) for(int i=0;i<n;i++) paragon_mem_untouch(api, hs[i], pin[i]);
+  if(sc) paragon_arena_reset(sc);
+  return done;
+}
+
+/* ---- per-handle staging buffers ---- */
+
+static float* staging_alloc(int n, int* locked){
+  void* p = NULL;
+  size_t bytes = ((size_t)n*sizeof(float) + 63) & ~(size_t)63;
+  if(posix_memalign(&p, 64, bytes)) return NULL;
+  memset(p, 0, bytes);                      /* fault pages in now, not on the first request */
+  if(mlock(p, bytes)==0) *locked = 1;       /* best effort: RLIMIT_MEMLOCK may say no */
+  return (float*)p;
+}
+
+int paragon_staging_init(ParagonAPI* api, ParagonHandle h, ParagonStaging* st,
+                         int in_cap, int out_cap){
+  if(!st) return 0;
+  memset(st, 0, sizeof(*st));
+  if(!api || in_cap<=0 || out_cap<=0) return 0;
+  st->h = h;
+  st->in_cap = in_cap; st->out_cap = out_cap;
+  st->in  = staging_alloc(in_cap,  &st->locked);
+  st->out = staging_alloc(out_cap, &st->locked);
+  if(!st->in || !st->out){ paragon_staging_free(api, st); return 0; }
+  paragon_mem_add_host(api, h, (long long)(in_cap + out_cap)*(long long)sizeof(float));
+  if(api->RegisterStaging && api->ForwardStaged)
+    st->registered = api->RegisterStaging(h, st->in, in_cap, st->out, out_cap)==0;
+  return 1;
+}
+
+static int staging_forward(ParagonAPI* api, ParagonStaging* st, int rows, int cols){
+  if(st->registered){
+    ParagonSpan sp; paragon_span_begin(api, &sp, "ForwardStaged", st->h);
+    int n = api->ForwardStaged(st->h, rows, cols);
+    paragon_span_ret(&sp);
+    paragon_span_end(&sp, (long long)rows*cols*(long long)sizeof(float),
+                     n>0 ? (long long)(n<st->out_cap ? n : st->out_cap)*(long long)sizeof(float) : 0);
+    if(n<0) return -1;
+    return n<st->out_cap ? n : st->out_cap;
+  }
+  if(!forward_f32(api, st->h, st->in, rows, cols)) return -1;
+  return extract_f32(api, st->h, st->out, st->out_cap);
+}
+
+int paragon_staging_forward(ParagonAPI* api, ParagonStaging* st, int rows, int cols){
+  if(!api || !st || !st->in || rows<=0 || cols<=0 || (long long)rows*cols > st->in_cap) return -1;
+  int t = paragon_mem_touch(api, st->h);
+  if(t<0) return -1;
+  int n = staging_forward(api, st, rows, cols);
+  paragon_mem_untouch(api, st->h, t);
+  return n;
+}
+
+void paragon_staging_free(ParagonAPI* api, ParagonStaging* st){
+  if(!st) return;
+  if(st->registered && api && api->UnregisterStaging) api->UnregisterStaging(st->h);
+  if(api && st->in && st->out)
+    paragon_mem_add_host(api, st->h, -(long long)(st->in_cap + st->out_cap)*(long long)sizeof(float));
+  if(st->in)  { if(st->locked) munlock(st->in,  (size_t)st->in_cap*sizeof(float));  free(st->in); }
+  if(st->out) { if(st->locked) munlock(st->out, (size_t)st->out_cap*sizeof(float)); free(st->out); }
+  memset(st, 0, sizeof(*st));
 }
 
 /* Create net via any available route:
@@ -114,24 +495,25 @@ char* paragon_new_net_any(ParagonAPI* api,
                           bool prefer_gpu,
                           bool expose_methods_json)
 {
+  ParagonSpan sp; paragon_span_begin(api, &sp, "NewNetworkFloat32", 0);
+  long long nargs = sp.t ? (long long)(strlen(layers_json) + strlen(activs_json) + strlen(trainable_json)) : 0;
+  char* r = NULL;
   if(api->New5){
-    return api->New5(layers_json, activs_json, trainable_json, prefer_gpu, expose_methods_json);
-  }
-  if(api->New3){
-    return api->New3(layers_json, activs_json, trainable_json);
-  }
-  if(api->Call){
+    r = api->New5(layers_json, activs_json, trainable_json, prefer_gpu, expose_methods_json);
+  } else if(api->New3){
+    r = api->New3(layers_json, activs_json, trainable_json);
+  } else if(api->Call){
     /* Build args: [layers, activs, trainable, prefer_gpu, expose] */
-    char* args = NULL;
-    size_t n = strlen(layers_json)+strlen(activs_json)+strlen(trainable_json)+64;
-    args = (char*)malloc(n);
-    snprintf(args, n, "[%s,%s,%s,%s,%s]",
+    ParagonArena* sc = paragon_scratch();
+    char* args = sc ? paragon_arena_printf(sc, "[%s,%s,%s,%s,%s]",
              layers_json, activs_json, trainable_json,
              prefer_gpu ? "true":"false",
-             expose_methods_json ? "true":"false");
-    char* r = api->Call(0, "NewNetworkFloat32", args);
-    free(args);
-    return r;
+             expose_methods_json ? "true":"false") : NULL;
+    paragon_span_lib(&sp);
+    r = args ? api->Call(0, "NewNetworkFloat32", args) : NULL;
+    if(sc) paragon_arena_reset(sc);
   }
-  return NULL;
+  paragon_span_ret(&sp);
+  paragon_span_end(&sp, nargs, sp.t && r ? (long long)strlen(r) : 0);
+  return r;
 }
@@ -2,6 +2,8 @@
 #define PARAGON_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
 
 typedef long long ParagonHandle;
 
@@ -27,19 +29,805 @@ typedef char* (*fn_Call)(
   const char* args_json_utf8
 );
 
+/* Optional raw-buffer fast path (no JSON round-trip).
+   Forward_F32 returns 0 on success; ExtractOutput_F32 returns the number
+   of floats the output holds (writing at most cap), <0 on error. */
+typedef int (*fn_Forward_F32)(
+  ParagonHandle handle,
+  const float* x,
+  int rows,
+  int cols
+);
+
+typedef int (*fn_ExtractOutput_F32)(
+  ParagonHandle handle,
+  float* out,
+  int cap
+);
+
+/* Optional batched forward: n samples of dim floats in, n×out_dim floats out.
+   Returns the number of rows written, <0 on error. */
+typedef int (*fn_ForwardBatch_F32)(
+  ParagonHandle handle,
+  const float* X,
+  int n,
+  int dim,
+  float* Y,
+  int out_dim
+);
+
+/* Optional: one sample into n handles at once; counts[i] floats into outs[i], -1 = failed */
+typedef int (*fn_ForwardGroup_F32)(const ParagonHandle* handles, int n,
+                                   const float* x, int dim,
+                                   float* const* outs, const int* out_caps, int* counts);
+
+/* Optional pre-registered staging: the library keeps the in/out pointers and
+   ForwardStaged reads rows×cols floats from `in`, writes the output to `out`,
+   and returns the output length (<0 on error). */
+typedef int  (*fn_RegisterStaging)(ParagonHandle handle, float* in, int in_cap, float* out, int out_cap);
+typedef int  (*fn_ForwardStaged)(ParagonHandle handle, int rows, int cols);
+typedef void (*fn_UnregisterStaging)(ParagonHandle handle);
+
+/* Optional id-based dispatch: resolve a method name once, then call by id */
+typedef int   (*fn_MethodID)(ParagonHandle handle, const char* method_utf8);   /* <0 unknown */
+typedef char* (*fn_CallID)(ParagonHandle handle, int method_id, const char* args_json_utf8);
+
+/* Optional GPU pipeline cache: Export writes up to cap bytes of compiled pipeline/shader
+   state and returns its full size (buf=NULL sizes it); Import hands a blob back before
+   InitializeOptimizedGPU and returns 0 if the library accepted it. */
+typedef long long (*fn_ExportGPUCache)(ParagonHandle handle, void* buf, long long cap);
+typedef int       (*fn_ImportGPUCache)(ParagonHandle handle, const void* buf, long long len);
+typedef const char* (*fn_Version)(void);
+
+/* Optional binary-model constructors (see paragon_model.c for the file layout).
+   NewNetworkFromModel may keep pointers into [base, base+len) for the handle's life;
+   SetLayerWeights_F32 copies one layer's out×in weights and out biases (0 = ok). */
+typedef char* (*fn_NewNetworkFromModel)(const void* base, long long len, bool use_gpu);
+typedef int   (*fn_SetLayerWeights_F32)(ParagonHandle handle, int layer,
+                                        const float* W, long long nw,
+                                        const float* B, long long nb);
+
+/* Optional quantized weights: dtype PARAGON_Q_F16 (W is uint16 halves, scale all 1) or
+   PARAGON_Q_INT8 (W is int8, one scale per output row); acc is the PARAGON_QACC_* the
+   library should accumulate with. Copies like SetLayerWeights_F32 (0 = ok). */
+typedef int   (*fn_SetLayerWeights_Q)(ParagonHandle handle, int layer, int dtype, int acc,
+                                      const void* W, long long nw,
+                                      const float* scale, long long ns,
+                                      const float* B, long long nb);
+
+/* Optional adapter enumeration: AdapterInfo returns a JSON description (caller frees
+   like any result); InitializeOptimizedGPUOn binds the handle's GPU state to adapter k. */
+typedef int   (*fn_AdapterCount)(void);
+typedef char* (*fn_AdapterInfo)(int k);
+typedef char* (*fn_InitGPUOn)(ParagonHandle handle, int k);
+
+/* Optional: `epochs` passes of backward + update over n rows of X (dim) against targets
+   Y (ydim), gradients clipped to [clip_min, clip_max]. 0 = ok. */
+typedef int   (*fn_Train_F32)(ParagonHandle handle, const float* X, int n, int dim,
+                              const float* Y, int ydim, int epochs, float lr,
+                              float clip_min, float clip_max);
+
+/* Optional: on=1 pins the handle to reproducible kernels (fixed reduction order), on=0
+   lets it use faster ones that may reassociate sums. 0 = ok. */
+typedef int   (*fn_SetDeterministic)(ParagonHandle handle, int on);
+
+/* Optional: what the library holds for a handle right now, host and device bytes
+   (weights, activations, optimizer state, its own staging). 0 = ok. */
+typedef int   (*fn_MemoryInfo)(ParagonHandle handle, long long* host_bytes, long long* device_bytes);
+/* Optional: drop gradient/optimizer state and keep only two activation buffers sized
+   for the widest layer, reused layer to layer. The handle can no longer train. 0 = ok. */
+typedef int   (*fn_SetInferenceOnly)(ParagonHandle handle);
+/* Optional: release a network and everything the library holds for it */
+typedef void  (*fn_FreeNetwork)(ParagonHandle handle);
+
+/* Optional: Paragon_PerturbWeights(handle, "[scale, seed]") as the C# wrapper calls it */
+typedef void  (*fn_PerturbWeights)(ParagonHandle handle, const char* args_json_utf8);
+
+/* Method tokens from paragon_method_id; the bridge's own methods are pre-interned */
+typedef int ParagonMethod;
+enum {
+  PARAGON_M_FORWARD,
+  PARAGON_M_EXTRACT_OUTPUT,
+  PARAGON_M_INIT_GPU,
+  PARAGON_M_TOGGLE_GPU,
+  PARAGON_M_BUILTINS
+};
+#define PARAGON_MAX_METHODS 64
+
+typedef struct {
+  char name[48];
+  int  lib_id;         /* MethodID result, -1 = dispatch by name */
+} ParagonMethodSlot;
+
+/* Cached per-handle facts, filled when the handle is created through the bridge */
+typedef struct {
+  ParagonHandle      h;
+  int                in_dim, out_dim;
+  unsigned long long methods;   /* bit per token the handle advertised (0 = not exposed) */
+  unsigned long long shape_key; /* paragon_hash64 of the layers JSON */
+  int                adapter;   /* bound adapter, -1 = library default */
+  unsigned           flags;     /* PARAGON_HF_* */
+  unsigned long long version;   /* bumped whenever the weights may have changed */
+  long long          host_bytes, device_bytes;  /* charged to the memory budget */
+  long long          est_host, est_device;      /* what the shape should need */
+  long long          rss_bytes;                 /* process RSS growth over create + GPU init */
+  unsigned long long last_use;                  /* budget clock, stamped per forward under EVICT */
+  unsigned long long born;                      /* budget clock at creation, 0 = not made here */
+  int                inflight;                  /* bridge calls running on it under EVICT */
+} ParagonHandleInfo;
+
+enum {
+  PARAGON_HF_GPU_INIT   = 1u<<0,  /* InitializeOptimizedGPU returned */
+  PARAGON_HF_GPU_CACHED = 1u<<1,  /* ...after the library accepted a cached pipeline blob */
+  PARAGON_HF_MEM_LIB    = 1u<<2,  /* host/device bytes came from the library's MemoryInfo */
+  PARAGON_HF_RELEASED   = 1u<<3,  /* freed or evicted; the handle must not be used again */
+  PARAGON_HF_INFERENCE  = 1u<<4,  /* library dropped training state (PARAGON_NEW_INFERENCE) */
+  PARAGON_HF_ON_GPU     = 1u<<5,  /* a successful ToggleGPU moved the handle onto the GPU */
+};
+
+/* Process-wide memory budget (paragon_mem.c), under api->lock */
+enum { PARAGON_BUDGET_REFUSE, PARAGON_BUDGET_EVICT };
+typedef struct {
+  long long          host_limit, device_limit;  /* bytes, 0 = unlimited */
+  int                policy;                    /* PARAGON_BUDGET_* */
+  int                touch;                     /* forwards stamp last_use */
+  long long          host_bytes, device_bytes;  /* charged to live handles */
+  long long          host_reserved, device_reserved;  /* admitted, not yet created */
+  long long          refused, evicted;
+  unsigned long long clock;
+  unsigned long long epoch;                     /* clock when the limits were set */
+  void             (*on_evict)(ParagonHandle h, void* user);
+  void*              evict_user;
+} ParagonMemBudget;
+
+/* Optional: the library's own free for char* results */
+typedef void (*fn_FreeResult)(char* result);
+
+typedef struct ParagonTrace ParagonTrace;   /* paragon_trace.c */
+
+/* Where paragon_load_ex spent its time */
+typedef struct {
+  double dlopen_ms;    /* dlopen, incl. relocation and the library's constructors */
+  double resolve_ms;   /* dlsym of every entry point, Version() */
+  double probe_ms;     /* capability probe: the first network the library builds */
+  double gpu_ms;       /* prewarm with PARAGON_LOAD_GPU: first GPU init */
+  double total_ms;
+  int    lazy;         /* RTLD_LAZY */
+  int    symbols;      /* dlsym lookups */
+} ParagonLoadTimes;
+
 typedef struct {
   void* so;
   fn_NewNetworkFloat32_5 New5;
   fn_NewNetworkFloat32_3 New3;
   fn_Call                 Call;
+  fn_Forward_F32          Forward_F32;        /* optional */
+  fn_ExtractOutput_F32    ExtractOutput_F32;  /* optional */
+  fn_ForwardBatch_F32     ForwardBatch_F32;   /* optional */
+  fn_ForwardGroup_F32     ForwardGroup_F32;   /* optional */
+  fn_RegisterStaging      RegisterStaging;    /* optional */
+  fn_ForwardStaged        ForwardStaged;      /* optional */
+  fn_UnregisterStaging    UnregisterStaging;  /* optional */
+  fn_MethodID             MethodID;           /* optional */
+  fn_CallID               CallID;             /* optional */
+  fn_FreeResult           FreeResult;         /* optional */
+  fn_ExportGPUCache       ExportGPUCache;     /* optional */
+  fn_ImportGPUCache       ImportGPUCache;     /* optional */
+  fn_Version              Version;            /* optional */
+  fn_NewNetworkFromModel  NewFromModel;       /* optional */
+  fn_SetLayerWeights_F32  SetLayerWeights;    /* optional */
+  fn_SetLayerWeights_Q    SetLayerWeightsQ;   /* optional */
+  fn_AdapterCount         AdapterCount;       /* optional */
+  fn_AdapterInfo          AdapterInfo;        /* optional */
+  fn_InitGPUOn            InitGPUOn;          /* optional */
+  fn_PerturbWeights       PerturbWeights;     /* optional */
+  fn_Train_F32            Train_F32;          /* optional */
+  fn_SetDeterministic     SetDeterministic;   /* optional */
+  fn_MemoryInfo           MemoryInfo;         /* optional */
+  fn_SetInferenceOnly     SetInferenceOnly;   /* optional */
+  fn_FreeNetwork          FreeNetwork;        /* optional */
+  char                    lib_version[64];    /* Version(), else .so size-mtime */
+  ParagonLoadTimes        load;
+  int                     sym_prefix;         /* 0 Paragon_, 1 Teleport_, 2 none */
+
+  /* GPU pipeline cache (paragon_gpucache.c); empty dir = off */
+  char                    gpu_cache_dir[512];
+  char                    adapter[128];       /* last InitializeOptimizedGPU reply */
+
+  /* capability negotiation (paragon_caps.c) */
+  unsigned long long      caps;               /* PARAGON_CAP_* */
+  int                     gpu_enable;         /* winning GPU knob; -1 unknown, -2 none */
+
+  /* per-call spans (paragon_trace.c); NULL = never traced */
+  ParagonTrace*           trace;
+
+  /* resolved-method cache and handle table (paragon_registry.c) */
+  pthread_mutex_t         lock;
+  ParagonMethodSlot       methods[PARAGON_MAX_METHODS];
+  int                     nmethods;
+  ParagonHandleInfo*      handles;            /* open addressing on h */
+  int                     nhandles, caphandles;
+  ParagonMemBudget        mem;                /* paragon_mem.c */
 } ParagonAPI;
 
+/* Reusable per-handle I/O buffers: 64-byte aligned, pre-faulted, mlock'd when allowed.
+   Write input floats into `in`, call paragon_staging_forward, read `out`. */
+typedef struct {
+  ParagonHandle h;
+  float* in;  int in_cap;
+  float* out; int out_cap;
+  int    registered;   /* library reads/writes the buffers directly */
+  int    locked;       /* pages are mlock'd */
+} ParagonStaging;
+
 int  paragon_load(ParagonAPI* api, const char* so_path);   /* 1 = ok */
+/* paragon_load with PARAGON_LOAD_* flags; paragon_load(api, p) is paragon_load_ex(api, p, 0) */
+enum {
+  PARAGON_LOAD_LAZY     = 1u<<0,   /* RTLD_LAZY: functions bind on first call */
+  PARAGON_LOAD_NO_PROBE = 1u<<1,   /* skip paragon_probe; caps stays 0 until it is called */
+  PARAGON_LOAD_GPU      = 1u<<2,   /* prewarm: also bring the GPU up on a throwaway handle */
+};
+int  paragon_load_ex(ParagonAPI* api, const char* so_path, unsigned flags);
+/* Load (and optionally GPU-init) on a helper thread while the caller sets up; api must
+   not be touched until paragon_prewarm_wait, which returns paragon_load_ex's result and
+   frees p. gpu_cache_dir (nullable) is opened before the GPU init so it can hit. */
+typedef struct ParagonPrewarm ParagonPrewarm;
+ParagonPrewarm* paragon_prewarm_start(ParagonAPI* api, const char* so_path, unsigned flags,
+                                      const char* gpu_cache_dir);
+int  paragon_prewarm_wait(ParagonPrewarm* p, double* blocked_ms);   /* blocked_ms nullable */
 void paragon_unload(ParagonAPI* api);
+void paragon_registry_init(ParagonAPI* api);               /* called by paragon_load */
+void paragon_registry_free(ParagonAPI* api);
+/* api->lock held: h's entry, made when create is set and h is unknown */
+ParagonHandleInfo* paragon_handle_locked(ParagonAPI* api, ParagonHandle h, int create);
 
 ParagonHandle paragon_parse_handle(const char* txt);       /* -1 on failure */
 char*         paragon_call0(ParagonAPI* api, ParagonHandle h, const char* method);
 
+/* Every char* the library returns (Call, New*, paragon_call0/_call_id, paragon_init_gpu)
+   belongs to the caller: release it here. Uses the library's exported free when present,
+   libc free() otherwise (build with -DPARAGON_KEEP_RESULTS if results are not malloc'd). */
+void paragon_free_result(ParagonAPI* api, char* result);
+
+/* Bump allocator (paragon_arena.c). Blocks chain on overflow; reset collapses them into
+   one block sized to the high-water mark, so steady workloads stop calling malloc. */
+typedef struct {
+  struct ParagonArenaBlock* head;
+  size_t min_block;
+  size_t in_use, high_water, reserved;
+} ParagonArena;
+
+void  paragon_arena_init(ParagonArena* a, size_t cap);
+void* paragon_arena_alloc(ParagonArena* a, size_t n);        /* 16-byte aligned, NULL on OOM */
+char* paragon_arena_printf(ParagonArena* a, const char* fmt, ...);
+void  paragon_arena_reset(ParagonArena* a);
+void  paragon_arena_free(ParagonArena* a);
+ParagonArena* paragon_scratch(void);   /* per-thread arena the bridge marshals JSON into */
+
+/* Float32 I/O: raw-buffer exports when present, JSON Forward/ExtractOutput otherwise */
+int paragon_forward_f32(ParagonAPI* api, ParagonHandle h,
+                        const float* x, int rows, int cols);       /* 1 = ok */
+int paragon_extract_f32(ParagonAPI* api, ParagonHandle h,
+                        float* out, int cap);                      /* count written, -1 on failure */
+/* paragon_forward_f32 in two steps, for callers that time marshalling on its own:
+   the Forward arguments built in a (NULL when Forward_F32 takes x as is, or on
+   failure), then the forward with them. */
+char* paragon_forward_args(ParagonAPI* api, ParagonArena* a, const float* x, int rows, int cols);
+int   paragon_forward_with(ParagonAPI* api, ParagonHandle h, const float* x, int rows, int cols,
+                           const char* args);                      /* 1 = ok */
+/* N×dim in, N×out_dim out in one crossing when ForwardBatch_F32 is exported,
+   one forward/extract per row otherwise. Returns rows written, -1 on failure. */
+int paragon_forward_batch(ParagonAPI* api, ParagonHandle h,
+                          const float* X, int n, int dim,
+                          float* Y, int out_dim);
+/* One dim-sized sample through n handles (an ensemble): a single crossing when
+   ForwardGroup_F32 is exported; otherwise every forward is issued before the first
+   output is read back, and on the JSON path the input is serialized once for all.
+   counts (nullable) gets each handle's output count, -1 where it failed. Returns the
+   number of handles that produced output, -1 on bad arguments. */
+int paragon_forward_group(ParagonAPI* api, const ParagonHandle* hs, int n,
+                          const float* x, int dim,
+                          float* const* outs, const int* out_caps, int* counts);
+int  paragon_staging_init(ParagonAPI* api, ParagonHandle h, ParagonStaging* st,
+                          int in_cap, int out_cap);                 /* 1 = ok */
+int  paragon_staging_forward(ParagonAPI* api, ParagonStaging* st,
+                             int rows, int cols);                   /* output count, -1 on failure */
+void paragon_staging_free(ParagonAPI* api, ParagonStaging* st);
+int paragon_parse_floats(const char* txt, float* out, int cap);    /* tolerant "[[a,b,...]]" scan */
+
+/* Streaming decode of numeric (nested) arrays (paragon_json.c): feed chunks in order,
+   numbers inside arrays land in out[0..cap); strings are skipped. No allocation. */
+typedef struct {
+  float*    out;
+  int       cap, n;          /* n = values stored (≤ cap) */
+  long long total;           /* values seen, stored or not */
+  int       rows, cols;      /* innermost arrays with values / length of the first */
+  int       depth, row_vals, in_str, esc, err;
+  int       ntok;
+  char      tok[64];         /* number split across chunks */
+} ParagonFloatReader;
+
+void paragon_floats_begin(ParagonFloatReader* r, float* out, int cap);
+void paragon_floats_feed(ParagonFloatReader* r, const char* chunk, size_t len);
+int  paragon_floats_end(ParagonFloatReader* r);   /* values stored, -1 if malformed/unbalanced */
+
+/* Method tokens: name → token once, then paragon_call_id skips name dispatch when
+   the library exports MethodID/CallID (ids are assumed stable for the library) */
+ParagonMethod paragon_method_id(ParagonAPI* api, ParagonHandle h, const char* method); /* -1 on failure */
+char*         paragon_call_id(ParagonAPI* api, ParagonHandle h, ParagonMethod m, const char* args_json);
+
+/* Handle table: create + parse once, then look facts up by handle */
+ParagonHandle paragon_new_handle(ParagonAPI* api,
+                                 const char* layers_json,
+                                 const char* activs_json,
+                                 const char* trainable_json,
+                                 bool prefer_gpu,
+                                 bool expose_methods_json);           /* -1 on failure */
+/* PARAGON_NEW_INFERENCE: serving-only handle. Every layer is created non-trainable (the
+   trainable JSON is ignored, nullable), then SetInferenceOnly lets the library free
+   training state and reuse a ping-pong activation pair; PARAGON_HF_INFERENCE says it
+   did. Without the export or method the handle is only frozen. It refuses paragon_train. */
+enum { PARAGON_NEW_INFERENCE = 1 };
+ParagonHandle paragon_new_handle_ex(ParagonAPI* api, const char* layers_json,
+                                    const char* activs_json, const char* trainable_json,
+                                    bool prefer_gpu, bool expose_methods_json, unsigned flags);
+int   paragon_handle_info(ParagonAPI* api, ParagonHandle h, ParagonHandleInfo* out);  /* 1 = found */
+/* Enter a handle made elsewhere; advertised (nullable) is the creation reply to scan for methods */
+int   paragon_register_handle(ParagonAPI* api, ParagonHandle h, const char* layers_json,
+                              const char* advertised);                          /* 1 = ok */
+char* paragon_init_gpu(ParagonAPI* api, ParagonHandle h);  /* InitializeOptimizedGPU + flag */
+/* Model version: starts at 0 and is bumped by every bridge call that may touch the
+   weights (any method other than Forward/ExtractOutput, PerturbWeights). Whoever writes
+   weights behind the bridge's back calls paragon_weights_changed. */
+unsigned long long paragon_handle_version(ParagonAPI* api, ParagonHandle h);
+void  paragon_weights_changed(ParagonAPI* api, ParagonHandle h);
+/* ToggleGPU flips placement, so callers read PARAGON_HF_ON_GPU before toggling;
+   paragon_call_id and paragon_call0 record each successful toggle here. */
+void  paragon_gpu_toggled(ParagonAPI* api, ParagonHandle h, const char* reply);
+int   paragon_perturb_weights(ParagonAPI* api, ParagonHandle h, const char* args_json);  /* 1 = ok */
+
+/* Capabilities, probed once by paragon_load: export bits from the resolved symbols,
+   method bits from a throwaway network's expose_methods_json reply. */
+enum {
+  PARAGON_CAP_PROBED            = 1ull<<0,   /* method list was readable */
+  PARAGON_CAP_RAW_IO            = 1ull<<1,
+  PARAGON_CAP_BATCH             = 1ull<<2,
+  PARAGON_CAP_STAGING           = 1ull<<3,
+  PARAGON_CAP_METHOD_ID         = 1ull<<4,
+  PARAGON_CAP_FREE_RESULT       = 1ull<<5,
+  PARAGON_CAP_GPU_CACHE         = 1ull<<6,
+  PARAGON_CAP_MODEL             = 1ull<<7,
+  PARAGON_CAP_ADAPTERS          = 1ull<<8,
+  PARAGON_CAP_QUANT             = 1ull<<9,
+  PARAGON_CAP_GROUP             = 1ull<<10,
+  PARAGON_CAP_TRAIN             = 1ull<<11,
+  PARAGON_CAP_DETERMINISM       = 1ull<<12,  /* SetDeterministic export or method */
+  PARAGON_CAP_MEMINFO           = 1ull<<13,
+  PARAGON_CAP_FREE_NET          = 1ull<<14,
+  PARAGON_CAP_INFERENCE         = 1ull<<15,  /* SetInferenceOnly export or method */
+  PARAGON_CAP_INIT_GPU          = 1ull<<16,
+  PARAGON_CAP_TOGGLE_GPU        = 1ull<<17,
+  PARAGON_CAP_SET_WEBGPU_NATIVE = 1ull<<18,  /* GPU knobs, tried in this order */
+  PARAGON_CAP_WEBGPU_NATIVE_ON  = 1ull<<19,
+  PARAGON_CAP_CONFIGURE         = 1ull<<20,
+  PARAGON_CAP_SET_OPTIONS       = 1ull<<21,
+  PARAGON_CAP_SET_FIELD         = 1ull<<22,
+  PARAGON_CAP_CALL              = 1ull<<23
+};
+void        paragon_probe(ParagonAPI* api);
+/* One call: the GPU knob that worked before, else the first advertised one that does
+   not answer with an error. 1 = a knob took it. */
+int         paragon_enable_gpu(ParagonAPI* api, ParagonHandle h);
+const char* paragon_gpu_enable_method(const ParagonAPI* api);   /* "none"/"pending" too */
+int         paragon_caps_string(const ParagonAPI* api, char* out, size_t n);
+
+/* Adapters: count is 1 when the library cannot enumerate (the default adapter).
+   info is the library's JSON for adapter k (free it), NULL when unknown.
+   init_gpu_on binds h to adapter k; k<0 or no InitializeOptimizedGPUOn export
+   falls back to paragon_init_gpu on the default adapter. */
+int   paragon_adapter_count(ParagonAPI* api);
+char* paragon_adapter_info(ParagonAPI* api, int k);
+char* paragon_init_gpu_on(ParagonAPI* api, ParagonHandle h, int k);
+
+/* GPU pipeline cache across restarts. Entries live in dir as <key>.pgc, key = hash of
+   library version + adapter + layers JSON; paragon_init_gpu imports a matching entry
+   before InitializeOptimizedGPU and exports one after a miss. Needs the library's
+   ExportGPUCache/ImportGPUCache; otherwise it stays a no-op. */
+int  paragon_gpu_cache_open(ParagonAPI* api, const char* dir);            /* 1 = ok */
+int  paragon_gpu_cache_path(ParagonAPI* api, ParagonHandle h, char* out, size_t n); /* 1 = enabled */
+int  paragon_gpu_cache_import(ParagonAPI* api, ParagonHandle h);          /* 1 = library took it */
+void paragon_gpu_cache_export(ParagonAPI* api, ParagonHandle h, const char* adapter);
+unsigned long long paragon_hash64(const void* p, size_t n, unsigned long long seed);  /* FNV-1a */
+
+/* Binary model files (paragon_model.c): a page-aligned header, then one 64-byte aligned
+   float32 block per weight matrix (out×in, row-major) and bias vector. Opened files are
+   mmap'd read-only and shared, so processes on a host share the same page cache. */
+#define PARAGON_MODEL_MAX_LAYERS 16
+enum { PARAGON_ACT_LINEAR, PARAGON_ACT_RELU, PARAGON_ACT_SOFTMAX,
+       PARAGON_ACT_SIGMOID, PARAGON_ACT_TANH, PARAGON_ACT_COUNT };
+
+typedef struct {
+  const void*  base;          /* the whole mapping */
+  size_t       len;
+  int          nlayers;       /* layers incl. input; nlayers-1 weight blocks */
+  int          width[PARAGON_MODEL_MAX_LAYERS], height[PARAGON_MODEL_MAX_LAYERS];
+  int          dims[PARAGON_MODEL_MAX_LAYERS];      /* width×height */
+  int          act[PARAGON_MODEL_MAX_LAYERS];       /* PARAGON_ACT_* */
+  const float* W[PARAGON_MODEL_MAX_LAYERS-1];       /* dims[l+1] × dims[l] */
+  const float* B[PARAGON_MODEL_MAX_LAYERS-1];       /* dims[l+1] */
+} ParagonModel;
+
+/* How paragon_new_from_model got the weights into the handle */
+enum { PARAGON_MODEL_SHAPE_ONLY, PARAGON_MODEL_COPIED, PARAGON_MODEL_ZERO_COPY,
+       PARAGON_MODEL_QUANTIZED, PARAGON_MODEL_DEQUANT };   /* last two: paragon_new_quantized */
+
+int  paragon_model_open(ParagonModel* m, const char* path);   /* 1 = ok, stderr on error */
+void paragon_model_close(ParagonModel* m);
+/* W[l]/B[l] as in ParagonModel; NULL W or B writes zeros. 1 = ok. */
+int  paragon_model_write(const char* path, int nlayers, const int* width, const int* height,
+                         const int* act, const float* const* W, const float* const* B);
+const char* paragon_act_name(int act);
+int         paragon_act_code(const char* name);             /* -1 unknown */
+/* NewNetworkFloat32 arguments for m's shape, built in a */
+void        paragon_model_json(ParagonArena* a, const ParagonModel* m,
+                               char** layers, char** activs, char** trainable);
+/* Keep m open while the handle lives: a zero-copy library reads weights from the mapping. */
+ParagonHandle paragon_new_from_model(ParagonAPI* api, const ParagonModel* m,
+                                     bool prefer_gpu, int* how);   /* -1 on failure */
+
+/* Reference forward over model weights (paragon_ref.c): independent of the library,
+   vectorized for the host (AVX-512F, AVX2+FMA, NEON or scalar, picked at runtime).
+   X is n×dims[0], Y gets n×out. Returns the output width, -1 on failure. */
+int         paragon_ref_forward(const ParagonModel* m, const float* X, int n, float* Y, int out_cap);
+const char* paragon_ref_isa(void);
+void        paragon_ref_activate(float* y, int n, int dim, int act);   /* in place, n rows */
+
+/* Images for serving paths (paragon_image.c), without zlib or libpng. PNG: every colour
+   type at bit depths 1-16, not interlaced, decoded to 8-bit luma (Rec. 709 weights, alpha
+   premultiplied, tRNS and CRCs ignored) with scratch and pixels in a. IDX: the MNIST
+   unsigned-byte image files (magic 2051), read in place. */
+typedef struct {
+  int                  w, h;
+  const unsigned char* px;     /* w×h luma, row-major */
+} ParagonImage;
+int  paragon_png_decode(ParagonArena* a, const void* buf, size_t len, ParagonImage* img);  /* 1 = ok */
+/* count images of rows×cols; image i is data + i·rows·cols. 1 = ok. */
+int  paragon_idx_images(const void* buf, size_t len, int* count, int* rows, int* cols,
+                        const unsigned char** data);
+/* w×h network input from img: nearest neighbour, then /255 (what the Go MNIST service does) */
+void paragon_image_input(const ParagonImage* img, float* x, int w, int h);
+
+/* Quantized models (paragon_quant.c), converted from a ParagonModel into one 64-byte
+   aligned block that owns the weights, scales and biases (bytes = all of it). */
+enum { PARAGON_Q_F32, PARAGON_Q_F16, PARAGON_Q_INT8 };
+enum { PARAGON_QACC_NATIVE,   /* int8: inputs quantized per row, int32 accumulate */
+       PARAGON_QACC_F32 };    /* weights widened in registers, fp32 accumulate (fp16 always) */
+
+typedef struct {
+  void*        block;
+  size_t       bytes;
+  int          dtype, acc;    /* PARAGON_Q_*, PARAGON_QACC_* */
+  int          nlayers;
+  int          dims[PARAGON_MODEL_MAX_LAYERS];
+  int          act[PARAGON_MODEL_MAX_LAYERS];
+  const void*  W[PARAGON_MODEL_MAX_LAYERS-1];       /* dims[l+1] × dims[l] halves or int8 */
+  const float* S[PARAGON_MODEL_MAX_LAYERS-1];       /* per output row; 1 for fp16 */
+  const float* B[PARAGON_MODEL_MAX_LAYERS-1];
+} ParagonQModel;
+
+int         paragon_quantize(ParagonQModel* q, const ParagonModel* m, int dtype, int acc);  /* 1 = ok */
+void        paragon_qmodel_free(ParagonQModel* q);
+int         paragon_qmodel_dequant(const ParagonQModel* q, int l, float* W);   /* 1 = ok */
+const char* paragon_qtype_name(int dtype, int acc);
+/* Same contract as paragon_ref_forward, on the quantized weights */
+int         paragon_qref_forward(const ParagonQModel* q, const float* X, int n, float* Y, int out_cap);
+/* Library handle for q: native quantized weights via SetLayerWeights_Q (how = QUANTIZED),
+   else fp32 copies of the rounded weights via SetLayerWeights_F32 (how = DEQUANT). */
+ParagonHandle paragon_new_quantized(ParagonAPI* api, const ParagonModel* m,
+                                    const ParagonQModel* q, bool prefer_gpu, int* how);
+
+/* Async submission (paragon_async.c): a worker thread per queue runs forwards in
+   ticket order with up to `depth` in flight. x is copied at submit; y must stay valid
+   until the ticket completes. cb (optional) runs on the worker thread.
+   wait returns the output count (-1 on failure, or once depth newer tickets reused the slot). */
+typedef struct ParagonAsync ParagonAsync;
+typedef long long ParagonTicket;
+typedef void (*paragon_done_fn)(ParagonTicket t, int status, float* y, void* user);
+
+ParagonAsync* paragon_async_new(ParagonAPI* api, ParagonHandle h, int depth, int in_cap);
+ParagonTicket paragon_async_submit(ParagonAsync* q, const float* x, int rows, int cols,
+                                   float* y, int out_cap,
+                                   paragon_done_fn cb, void* user);   /* -1 on failure */
+int  paragon_async_poll(ParagonAsync* q, ParagonTicket t);  /* 1 done, 0 pending, -1 unknown */
+int  paragon_async_wait(ParagonAsync* q, ParagonTicket t);
+void paragon_async_free(ParagonAsync* q);                   /* drains in-flight work */
+
+/* Micro-batching (paragon_batcher.c): any number of threads submit single samples; one
+   worker issues a paragon_forward_batch once max_batch are queued or the oldest has
+   waited max_wait_us, then copies each row into its caller's y. cap bounds the queue
+   (submit blocks when full; < max_batch means 2×max_batch). infer = submit + wait. */
+typedef struct ParagonBatcher ParagonBatcher;
+typedef struct {
+  long long requests, batches;
+  long long full, timed_out;    /* batches closed by size / by max_wait_us */
+  double    mean_batch;
+} ParagonBatcherStats;
+
+ParagonBatcher* paragon_batcher_new(ParagonAPI* api, ParagonHandle h, int in_dim, int out_dim,
+                                    int max_batch, int max_wait_us, int cap);
+ParagonTicket   paragon_batcher_submit(ParagonBatcher* b, const float* x, float* y, int out_cap,
+                                       paragon_done_fn cb, void* user);   /* -1 on failure */
+/* wait: output count, -1 on failure, also -1 once cap newer tickets have reused t's slot
+   (infer has no such window) */
+int  paragon_batcher_wait(ParagonBatcher* b, ParagonTicket t);
+int  paragon_batcher_infer(ParagonBatcher* b, const float* x, float* y, int out_cap);
+void paragon_batcher_stats(ParagonBatcher* b, ParagonBatcherStats* st);
+void paragon_batcher_free(ParagonBatcher* b);                   /* drains queued requests */
+
+/* Lock-free concurrency (paragon_pool.c).
+   ParagonMPMC: bounded multi-producer/multi-consumer ring of long long, capacity rounded
+   up to a power of two; push/pop never block (0 = full/empty).
+   ParagonPool: n warmed handles of one model; acquire spins briefly, then sleeps until a
+   release, so callers share handles without a mutex around Call. adopt takes handles
+   made elsewhere (e.g. paragon_new_from_model) and warms them with one forward.
+   ParagonDispatch: workers each own a job ring and steal from the others when theirs is
+   empty; every job checks a handle out of the pool for one forward/extract. The caller
+   owns the ParagonJob and must keep it (and x, y) alive until paragon_job_wait returns. */
+struct ParagonMPMCCell;
+typedef struct {
+  struct ParagonMPMCCell* cells;
+  size_t                  mask;
+  _Alignas(64) size_t     head;     /* consumers */
+  _Alignas(64) size_t     tail;     /* producers */
+} ParagonMPMC;
+
+int  paragon_mpmc_init(ParagonMPMC* q, size_t cap);          /* 1 = ok */
+int  paragon_mpmc_push(ParagonMPMC* q, long long v);         /* 1 = ok, 0 = full */
+int  paragon_mpmc_pop(ParagonMPMC* q, long long* v);         /* 1 = ok, 0 = empty */
+void paragon_mpmc_free(ParagonMPMC* q);
+
+enum { PARAGON_POOL_GPU       = 1,   /* InitializeOptimizedGPU + enable + toggle each handle */
+       PARAGON_POOL_INFERENCE = 2 }; /* paragon_pool_new builds PARAGON_NEW_INFERENCE handles */
+typedef struct ParagonPool ParagonPool;
+ParagonPool*  paragon_pool_new(ParagonAPI* api, const char* layers_json, const char* activs_json,
+                               const char* trainable_json, int n, int flags);
+ParagonPool*  paragon_pool_adopt(ParagonAPI* api, const ParagonHandle* hs, int n, int flags);
+ParagonHandle paragon_pool_acquire(ParagonPool* p);          /* blocks while all are out */
+ParagonHandle paragon_pool_try_acquire(ParagonPool* p);      /* -1 when all are out */
+void          paragon_pool_release(ParagonPool* p, ParagonHandle h);
+int           paragon_pool_size(const ParagonPool* p);
+void          paragon_pool_free(ParagonPool* p);             /* handles stay with the library */
+
+typedef struct ParagonJob {
+  const float* x;                   /* one sample of the pool's input width */
+  float*       y;
+  int          out_cap;
+  int          status;              /* output count, -1 on failure; set when done */
+  void       (*cb)(struct ParagonJob* j, void* user);   /* optional, on the worker */
+  void*        user;
+  int          state;               /* internal */
+} ParagonJob;
+
+typedef struct ParagonDispatch ParagonDispatch;
+ParagonDispatch* paragon_dispatch_new(ParagonPool* pool, int workers, int queue_cap); /* cap 0 = 1024 */
+int  paragon_dispatch_submit(ParagonDispatch* d, ParagonJob* j);   /* 1 = queued */
+int  paragon_job_wait(ParagonJob* j);                              /* j->status */
+void paragon_dispatch_stats(const ParagonDispatch* d, long long* ran, long long* stolen);
+void paragon_dispatch_free(ParagonDispatch* d);                    /* drains queued jobs */
+
+/* NUMA placement (paragon_numa.c). Topology comes from sysfs and memory policy from
+   set_mempolicy, without libnuma. ParagonReplicas builds per_node handles per node
+   (replicate), or per_node × nodes in one pool whose weights are first-touched on the
+   caller or interleaved over the nodes. paragon_replicas_forward serves from the pool
+   of the node the calling thread runs on, so workers pinned with paragon_numa_pin
+   only read local weights. */
+enum { PARAGON_PLACE_FIRST_TOUCH, PARAGON_PLACE_INTERLEAVE, PARAGON_PLACE_REPLICATE };
+typedef struct ParagonReplicas ParagonReplicas;
+int  paragon_numa_nodes(void);                 /* online nodes, 1 when unknown */
+int  paragon_numa_pin(int node);               /* calling thread onto the node's CPUs, 1 = ok */
+int  paragon_numa_current_node(void);
+const char* paragon_place_name(int placement);
+ParagonReplicas* paragon_replicas_new(ParagonAPI* api, const char* layers_json,
+                                      const char* activs_json, const char* trainable_json,
+                                      int per_node, int placement);
+ParagonPool* paragon_replicas_pool(ParagonReplicas* r, int node);   /* node's pool, or the shared one */
+int  paragon_replicas_nodes(const ParagonReplicas* r);
+int  paragon_replicas_forward(ParagonReplicas* r, const float* x, int dim,
+                              float* y, int out_cap);                /* count written, -1 on failure */
+void paragon_replicas_free(ParagonReplicas* r);
+
+/* CPU/GPU router (paragon_router.c) over two handles of one model (gpu may be -1).
+   calibrate times both at batch 1, 2, 4 … max_batch (iters each, median) and must run
+   before requests are served; forward then sends each batch to the backend with the
+   lower queued + predicted time and adapts the curves to what it observes. Each handle
+   is called by one thread at a time. */
+#define PARAGON_ROUTE_MAX_SIZES 12
+enum { PARAGON_ROUTE_CPU, PARAGON_ROUTE_GPU };
+typedef struct ParagonRouter ParagonRouter;
+typedef struct {
+  int       nsizes;
+  int       sizes[PARAGON_ROUTE_MAX_SIZES];
+  double    cpu_ms[PARAGON_ROUTE_MAX_SIZES], gpu_ms[PARAGON_ROUTE_MAX_SIZES];   /* INFINITY = unusable */
+  long long routed[2];                      /* by PARAGON_ROUTE_* */
+  double    scale[2];                       /* observed/calibrated, EWMA */
+  int       crossover;                      /* batch from which GPU wins every larger size, -1 never */
+} ParagonRouterStats;
+
+ParagonRouter* paragon_router_new(ParagonAPI* api, ParagonHandle cpu, ParagonHandle gpu,
+                                  int in_dim, int out_dim);
+int    paragon_router_calibrate(ParagonRouter* r, int max_batch, int iters);   /* 1 = a backend works */
+double paragon_router_predict(const ParagonRouter* r, int backend, int n);     /* ms, no queueing */
+int    paragon_router_pick(const ParagonRouter* r, int n, double* cost_ms);    /* PARAGON_ROUTE_* */
+/* paragon_forward_batch on the picked backend; *used (nullable) says which */
+int    paragon_router_forward(ParagonRouter* r, const float* X, int n, int dim,
+                              float* Y, int out_dim, int* used);
+int    paragon_router_crossover(const ParagonRouter* r);
+void   paragon_router_stats(const ParagonRouter* r, ParagonRouterStats* st);
+void   paragon_router_free(ParagonRouter* r);                 /* handles stay with the caller */
+
+/* Training (paragon_train.c): opts.epochs passes over n rows, opts.step rows per library
+   call (0 = all n), rows reshuffled each epoch when opts.shuffle. Train_F32 when exported,
+   Call("Train") with JSON otherwise. gpu moves the handle to the GPU first. on_step
+   (nullable) runs after every step. Return steps done, -1 if none could run. */
+typedef struct {
+  int      epochs, step;
+  float    lr, clip_min, clip_max;
+  int      gpu, shuffle;
+  unsigned seed;
+  void   (*on_step)(int epoch, int steps_done, void* user);
+  void*    user;
+} ParagonTrainOpts;
+
+void paragon_train_defaults(ParagonTrainOpts* o);   /* 1 epoch, lr 0.05, clip ±2, one step */
+int  paragon_train(ParagonAPI* api, ParagonHandle h, const float* X, int n, int dim,
+                   const float* Y, int ydim, const ParagonTrainOpts* opts);   /* opts nullable */
+/* class indices instead of targets: one-hot over `classes` outputs */
+int  paragon_train_labels(ParagonAPI* api, ParagonHandle h, const float* X, int n, int dim,
+                          const int* labels, int classes, const ParagonTrainOpts* opts);
+
+/* Reproducibility (paragon_parity.c). ULP distance orders floats by their bit patterns,
+   so 1 is the adjacent float; +0/-0 are 0 apart, a NaN is UINT_MAX from anything but a
+   bit-identical NaN. A ParagonParity accumulates element-wise comparisons of a against
+   b; paragon_parity_add can be called once per sample and the totals read at the end. */
+#define PARAGON_ULP_BUCKETS 6    /* 0, 1, 2-3, 4-15, 16-255, 256+ */
+typedef struct {
+  long long n;                       /* elements compared */
+  long long exact;                   /* bit-identical */
+  long long within;                  /* ≤ tol ulp (tol given to paragon_parity_add) */
+  unsigned  max_ulp;
+  double    mae, max_abs;            /* mae is the mean once n>0 */
+  long long hist[PARAGON_ULP_BUCKETS];
+} ParagonParity;
+
+unsigned paragon_ulp(float a, float b);
+void     paragon_parity_reset(ParagonParity* p);
+void     paragon_parity_add(ParagonParity* p, const float* a, const float* b, long long n, unsigned tol);
+/* 1 = the library took it, 0 = no such knob (the handle keeps its default kernels),
+   -1 = it refused. A switch bumps the handle's model version: outputs may change. */
+int      paragon_set_deterministic(ParagonAPI* api, ParagonHandle h, int on);
+
+/* Memory accounting and budget (paragon_mem.c). Every handle made through the bridge is
+   charged: host bytes are the library's MemoryInfo when exported, else the larger of the
+   process RSS growth over NewNetwork and the shape estimate (weights, gradients and
+   activations);
+   device bytes are MemoryInfo, else the shape estimate once the GPU is initialized;
+   bridge staging buffers are added to host. RSS growth is process-wide, so handles made
+   concurrently blur each other's measurement.
+   With a limit set, paragon_new_handle and paragon_init_gpu first make room for the
+   estimate and reserve it until the real charge replaces it, so concurrent creators
+   cannot overshoot together. REFUSE fails them (-1 / NULL, stderr); EVICT frees least recently used
+   handles through the library's FreeNetwork until the new one fits, calling on_evict
+   (outside the lock) for each. Only handles created after paragon_mem_budget are
+   eviction candidates, and a request that would not fit even with all of them gone is
+   refused before anything is freed. Under EVICT
+   every bridge call on a handle (forward, extract, call, train) stamps it and holds it
+   in flight for the call, at one locked lookup on each side; a handle in flight is never
+   chosen for eviction, and a call on a released one fails. */
+typedef struct {
+  long long host_bytes, device_bytes;   /* measured: library, else RSS growth (-1 = unknown) */
+  long long est_host, est_device;
+  long long charged_host, charged_device;
+  int       from_library;
+  int       released;
+} ParagonMemInfo;
+
+typedef struct {
+  long long host_bytes, device_bytes, host_limit, device_limit;
+  int       handles;                    /* live, charged */
+  long long refused, evicted;
+} ParagonMemUsage;
+
+long long paragon_rss_bytes(void);                            /* -1 unknown */
+void paragon_mem_estimate(const char* layers_json, long long* host, long long* device);
+/* the same without gradients and with two widest-layer activation buffers */
+void paragon_mem_estimate_inference(const char* layers_json, long long* host, long long* device);
+int  paragon_mem_budget(ParagonAPI* api, long long host_limit, long long device_limit, int policy);  /* 1 = ok */
+void paragon_mem_on_evict(ParagonAPI* api, void (*fn)(ParagonHandle h, void* user), void* user);
+int  paragon_handle_memory(ParagonAPI* api, ParagonHandle h, ParagonMemInfo* out);   /* 1 = found */
+void paragon_mem_usage(ParagonAPI* api, ParagonMemUsage* out);
+/* FreeNetwork + uncharge. 0 (nothing changes) when the library cannot free, the handle
+   was already released, or a bridge call on another thread holds it in flight (tracked
+   under EVICT; otherwise the caller keeps frees and calls on one handle apart) */
+int  paragon_free_handle(ParagonAPI* api, ParagonHandle h);
+/* hooks for the creating/forwarding paths */
+/* admit reserves the bytes (1 = fits); created / gpu_ready settle the reservation against
+   the real charge, paragon_mem_unreserve hands it back when creation fails */
+int  paragon_mem_admit(ParagonAPI* api, long long host, long long device, ParagonHandle keep);
+void paragon_mem_unreserve(ParagonAPI* api, long long host, long long device);
+void paragon_mem_created(ParagonAPI* api, ParagonHandle h, const char* layers_json, long long rss0,
+                         long long reserved_host);
+void paragon_mem_gpu_ready(ParagonAPI* api, ParagonHandle h, long long rss0, long long reserved_device);
+void paragon_mem_add_host(ParagonAPI* api, ParagonHandle h, long long bytes);   /* staging, ± */
+/* -1 = released; 1 = held in flight until paragon_mem_untouch(.., 1); 0 = not tracked */
+int  paragon_mem_touch(ParagonAPI* api, ParagonHandle h);
+void paragon_mem_untouch(ParagonAPI* api, ParagonHandle h, int touched);
+
+/* Forward-result cache (paragon_cache.c): single-sample forwards keyed by (handle, hash of
+   the input floats), checked against paragon_handle_version so nothing computed before a
+   weight change is served after it. LRU past `capacity` entries; inputs longer than
+   in_cap or outputs longer than out_cap pass through uncached. A miss runs
+   paragon_forward_f32 + paragon_extract_f32, with the same one-thread-per-handle rule. */
+typedef struct ParagonCache ParagonCache;
+typedef struct {
+  long long hits, misses, evictions;
+  long long invalidated;                 /* entries dropped for a stale model version */
+  int       entries, capacity;
+  double    hit_rate;
+} ParagonCacheStats;
+
+ParagonCache* paragon_cache_new(ParagonAPI* api, int capacity, int in_cap, int out_cap);
+int  paragon_cache_forward(ParagonCache* c, ParagonHandle h, const float* x, int dim,
+                           float* y, int out_cap);                 /* count written, -1 on failure */
+int  paragon_cache_invalidate(ParagonCache* c, ParagonHandle h);  /* entries dropped */
+void paragon_cache_clear(ParagonCache* c);                         /* counters are kept */
+void paragon_cache_stats(ParagonCache* c, ParagonCacheStats* st);
+void paragon_cache_free(ParagonCache* c);
+
+/* Tracing (paragon_trace.c). While on, every outermost bridge call (forward, extract,
+   batch, staged, call0/call_id, new_net_any) records name, handle, thread, argument and
+   result bytes, and how long it spent marshalling, in the library and unmarshalling,
+   into a lock-free ring of the last `cap` spans (0 = PARAGON_TRACE_DEFAULT_CAP).
+   Off costs one load per call. PARAGON_TRACE=file.json turns it on in paragon_load and
+   exports at paragon_unload. */
+#define PARAGON_TRACE_DEFAULT_CAP 65536
+typedef struct {
+  char               name[24];
+  ParagonHandle      h;
+  int                tid;
+  unsigned long long t0;                        /* ns since paragon_trace_start */
+  unsigned long long ser_ns, lib_ns, deser_ns;
+  long long          arg_bytes, result_bytes;
+} ParagonSpanRec;
+
+typedef struct {
+  long long calls, arg_bytes, result_bytes;
+  long long dropped;                            /* spans overwritten in the ring */
+  double    ser_ms, lib_ms, deser_ms;           /* totals over all calls */
+  double    elapsed_ms, calls_per_s;            /* since paragon_trace_start */
+} ParagonTraceStats;
+
+int  paragon_trace_start(ParagonAPI* api, int cap);     /* 1 = ok; the ring is kept once made */
+void paragon_trace_stop(ParagonAPI* api);
+void paragon_trace_env(ParagonAPI* api);                /* called by paragon_load */
+void paragon_trace_free(ParagonAPI* api);               /* called by paragon_unload */
+void paragon_trace_stats(const ParagonAPI* api, ParagonTraceStats* st);
+int  paragon_trace_spans(const ParagonAPI* api, ParagonSpanRec* out, int cap);  /* oldest first */
+int  paragon_trace_export(const ParagonAPI* api, const char* path);  /* Chrome/Perfetto JSON, 1 = ok */
+
+/* Instrumenting a call: begin, lib right before the library is entered, ret right after
+   it returns, end with the byte counts. All four are no-ops when tracing is off or the
+   thread is already inside a span. */
+typedef struct {
+  ParagonTrace*      t;
+  const char*        name;
+  ParagonHandle      h;
+  unsigned long long t0, t1, t2;
+} ParagonSpan;
+void paragon_span_begin(ParagonAPI* api, ParagonSpan* s, const char* name, ParagonHandle h);
+void paragon_span_lib(ParagonSpan* s);
+void paragon_span_ret(ParagonSpan* s);
+void paragon_span_end(ParagonSpan* s, long long arg_bytes, long long result_bytes);
+
 /* High-level helpers matching your C# flow */
 char* paragon_new_net_any(ParagonAPI* api,
                           const char* layers_json,
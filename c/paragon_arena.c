@@ -0,0 +1,109 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paragon.h"
+
+/* Bump allocator over a chain of blocks. Reset keeps one block sized to the
+   high-water mark, so a steady workload settles into zero malloc calls. */
+
+struct ParagonArenaBlock {
+  struct ParagonArenaBlock* next;
+  size_t cap, used;
+  /* data follows, 16-byte aligned */
+};
+
+#define HDR ((sizeof(struct ParagonArenaBlock) + 15) & ~(size_t)15)
+
+static struct ParagonArenaBlock* block_new(size_t cap){
+  struct ParagonArenaBlock* b = (struct ParagonArenaBlock*)malloc(HDR + cap);
+  if(!b) return NULL;
+  b->next = NULL; b->cap = cap; b->used = 0;
+  return b;
+}
+
+void paragon_arena_init(ParagonArena* a, size_t cap){
+  memset(a, 0, sizeof(*a));
+  a->min_block = cap ? cap : 4096;
+}
+
+void* paragon_arena_alloc(ParagonArena* a, size_t n){
+  n = (n + 15) & ~(size_t)15;
+  struct ParagonArenaBlock* b = a->head;
+  if(!b || b->cap - b->used < n){
+    size_t cap = a->min_block;
+    while(cap < n) cap *= 2;
+    struct ParagonArenaBlock* nb = block_new(cap);
+    if(!nb) return NULL;
+    nb->next = b; a->head = nb; b = nb;
+    a->reserved += cap;
+  }
+  void* p = (char*)b + HDR + b->used;
+  b->used += n;
+  a->in_use += n;
+  if(a->in_use > a->high_water) a->high_water = a->in_use;
+  return p;
+}
+
+char* paragon_arena_printf(ParagonArena* a, const char* fmt, ...){
+  va_list ap; va_start(ap, fmt);
+  va_list ap2; va_copy(ap2, ap);
+  int w = vsnprintf(NULL, 0, fmt, ap);
+  va_end(ap);
+  char* s = w<0 ? NULL : (char*)paragon_arena_alloc(a, (size_t)w + 1);
+  if(s) vsnprintf(s, (size_t)w + 1, fmt, ap2);
+  va_end(ap2);
+  return s;
+}
+
+void paragon_arena_reset(ParagonArena* a){
+  struct ParagonArenaBlock* b = a->head;
+  if(b && b->next){
+    /* collapse to a single block that fits the whole previous run */
+    while(b){ struct ParagonArenaBlock* n = b->next; free(b); b = n; }
+    size_t cap = a->min_block;
+    while(cap < a->high_water) cap *= 2;
+    a->head = block_new(cap);
+    a->reserved = a->head ? cap : 0;
+  } else if(b){
+    b->used = 0;
+  }
+  a->in_use = 0;
+}
+
+void paragon_arena_free(ParagonArena* a){
+  struct ParagonArenaBlock* b = a->head;
+  while(b){ struct ParagonArenaBlock* n = b->next; free(b); b = n; }
+  memset(a, 0, sizeof(*a));
+}
+
+/* ---- per-thread scratch for the bridge's own request/response buffers ---- */
+
+static pthread_key_t  g_scratch_key;
+static pthread_once_t g_scratch_once = PTHREAD_ONCE_INIT;
+
+static void scratch_destroy(void* p){
+  ParagonArena* a = (ParagonArena*)p;
+  paragon_arena_free(a);
+  free(a);
+}
+
+static void scratch_key_init(void){
+  (void)pthread_key_create(&g_scratch_key, scratch_destroy);
+}
+
+ParagonArena* paragon_scratch(void){
+  pthread_once(&g_scratch_once, scratch_key_init);
+  ParagonArena* a = (ParagonArena*)pthread_getspecific(g_scratch_key);
+  if(!a){
+    a = (ParagonArena*)malloc(sizeof(*a));
+    if(!a) return NULL;
+    paragon_arena_init(a, 64*1024);
+    if(pthread_setspecific(g_scratch_key, a)){ free(a); return NULL; }
+  }
+  return a;
+}
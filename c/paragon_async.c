@@ -0,0 +1,148 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paragon.h"
+
+/* One worker thread per queue drains a ring of `depth` slots in submission order.
+   Inputs are copied into the slot at submit, so the caller may reuse its buffer
+   (and prepare request N+1) while request N runs. Ticket t lives in slot t % depth. */
+
+typedef struct {
+  ParagonTicket    t;
+  float*           x;
+  int              rows, cols;
+  float*           y;
+  int              out_cap;
+  int              status;      /* output count, -1 on failure */
+  paragon_done_fn  cb;
+  void*            user;
+} Slot;
+
+struct ParagonAsync {
+  ParagonAPI*     api;
+  ParagonHandle   h;
+  int             depth, in_cap;
+  Slot*           slots;
+  long long       next;         /* next ticket to hand out */
+  long long       done;         /* tickets < done have completed */
+  int             closing;
+  pthread_mutex_t mu;
+  pthread_cond_t  has_work, has_room, has_done;
+  pthread_t       worker;
+};
+
+static void* async_main(void* arg){
+  ParagonAsync* q = (ParagonAsync*)arg;
+  pthread_mutex_lock(&q->mu);
+  for(;;){
+    while(q->done==q->next && !q->closing) pthread_cond_wait(&q->has_work, &q->mu);
+    if(q->done==q->next) break;                 /* closing and drained */
+    Slot* s = &q->slots[q->done % q->depth];
+    pthread_mutex_unlock(&q->mu);
+
+    int st = -1;
+    if(paragon_forward_f32(q->api, q->h, s->x, s->rows, s->cols))
+      st = paragon_extract_f32(q->api, q->h, s->y, s->out_cap);
+    s->status = st;
+    if(s->cb) s->cb(s->t, st, s->y, s->user);
+
+    pthread_mutex_lock(&q->mu);
+    ++q->done;
+    pthread_cond_broadcast(&q->has_done);
+    pthread_cond_signal(&q->has_room);
+  }
+  pthread_mutex_unlock(&q->mu);
+  return NULL;
+}
+
+ParagonAsync* paragon_async_new(ParagonAPI* api, ParagonHandle h, int depth, int in_cap){
+  if(!api || depth<=0 || in_cap<=0) return NULL;
+  ParagonAsync* q = (ParagonAsync*)calloc(1, sizeof(*q));
+  if(!q) return NULL;
+  q->api = api; q->h = h; q->depth = depth; q->in_cap = in_cap;
+  q->slots = (Slot*)calloc((size_t)depth, sizeof(Slot));
+  if(!q->slots){ free(q); return NULL; }
+  for(int i=0; i<depth; ++i){
+    q->slots[i].t = -1;
+    q->slots[i].x = (float*)malloc(sizeof(float)*(size_t)in_cap);
+    if(!q->slots[i].x){
+      for(int j=0; j<i; ++j) free(q->slots[j].x);
+      free(q->slots); free(q);
+      return NULL;
+    }
+  }
+  pthread_mutex_init(&q->mu, NULL);
+  pthread_cond_init(&q->has_work, NULL);
+  pthread_cond_init(&q->has_room, NULL);
+  pthread_cond_init(&q->has_done, NULL);
+  if(pthread_create(&q->worker, NULL, async_main, q)){
+    fprintf(stderr, "paragon_async_new: pthread_create failed\n");
+    pthread_mutex_destroy(&q->mu);
+    pthread_cond_destroy(&q->has_work); pthread_cond_destroy(&q->has_room); pthread_cond_destroy(&q->has_done);
+    for(int i=0; i<depth; ++i) free(q->slots[i].x);
+    free(q->slots); free(q);
+    return NULL;
+  }
+  return q;
+}
+
+ParagonTicket paragon_async_submit(ParagonAsync* q, const float* x, int rows, int cols,
+                                   float* y, int out_cap, paragon_done_fn cb, void* user){
+  if(!q || !x || !y || rows<=0 || cols<=0 || out_cap<=0) return -1;
+  if((long long)rows*cols > q->in_cap) return -1;
+  pthread_mutex_lock(&q->mu);
+  while(q->next - q->done >= q->depth && !q->closing) pthread_cond_wait(&q->has_room, &q->mu);
+  if(q->closing){ pthread_mutex_unlock(&q->mu); return -1; }
+  /* the worker never touches slots at or past `next`, so filling under the lock
+     keeps concurrent submitters in ticket order */
+  ParagonTicket t = q->next;
+  Slot* s = &q->slots[t % q->depth];
+  memcpy(s->x, x, sizeof(float)*(size_t)rows*cols);
+  s->t = t; s->rows = rows; s->cols = cols;
+  s->y = y; s->out_cap = out_cap; s->status = -1;
+  s->cb = cb; s->user = user;
+  ++q->next;
+  pthread_cond_signal(&q->has_work);
+  pthread_mutex_unlock(&q->mu);
+  return t;
+}
+
+int paragon_async_poll(ParagonAsync* q, ParagonTicket t){
+  if(!q || t<0) return -1;
+  pthread_mutex_lock(&q->mu);
+  int r = t>=q->next ? -1 : (t<q->done ? 1 : 0);
+  pthread_mutex_unlock(&q->mu);
+  return r;
+}
+
+int paragon_async_wait(ParagonAsync* q, ParagonTicket t){
+  if(!q || t<0) return -1;
+  pthread_mutex_lock(&q->mu);
+  if(t>=q->next){ pthread_mutex_unlock(&q->mu); return -1; }
+  while(t>=q->done) pthread_cond_wait(&q->has_done, &q->mu);
+  Slot* s = &q->slots[t % q->depth];
+  int r = s->t==t ? s->status : -1;   /* slot already reused by a newer ticket */
+  pthread_mutex_unlock(&q->mu);
+  return r;
+}
+
+void paragon_async_free(ParagonAsync* q){
+  if(!q) return;
+  pthread_mutex_lock(&q->mu);
+  q->closing = 1;
+  pthread_cond_broadcast(&q->has_work);
+  pthread_cond_broadcast(&q->has_room);
+  pthread_mutex_unlock(&q->mu);
+  pthread_join(q->worker, NULL);
+  pthread_mutex_destroy(&q->mu);
+  pthread_cond_destroy(&q->has_work);
+  pthread_cond_destroy(&q->has_room);
+  pthread_cond_destroy(&q->has_done);
+  for(int i=0; i<q->depth; ++i) free(q->slots[i].x);
+  free(q->slots);
+  free(q);
+}
@@ -0,0 +1,213 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "paragon.h"
+
+/* Dynamic micro-batching. Callers from any thread submit one sample; a worker waits
+   until max_batch samples are queued or the oldest has waited max_wait_us, gathers
+   them into one matrix, runs a single paragon_forward_batch and scatters the rows back.
+   Samples queued while a batch runs form the next one, so under load the batch size
+   tracks the arrival rate. Requests live in a ring of `cap` slots; batches complete
+   in ticket order, so one `done` counter answers wait like ParagonAsync. */
+
+/* where infer waits: filled by the worker under the lock, so it survives the slot
+   being reused by a later ticket before the waiter wakes up */
+typedef struct {
+  int status, finished;
+} Sync;
+
+typedef struct {
+  ParagonTicket    t;
+  float*           x;          /* in_dim floats, copied at submit */
+  float*           y;
+  int              out_cap;
+  int              status;     /* output count, -1 on failure */
+  double           arrived;    /* ms, monotonic */
+  paragon_done_fn  cb;
+  void*            user;
+  Sync*            sync;       /* infer's, NULL for submit */
+  pthread_cond_t   cv;         /* its waiter; only the finished batch is woken */
+} Req;
+
+struct ParagonBatcher {
+  ParagonAPI*     api;
+  ParagonHandle   h;
+  int             in_dim, out_dim, max_batch, max_wait_us, cap;
+  Req*            ring;
+  float*          X;           /* max_batch × in_dim gather buffer */
+  float*          Y;           /* max_batch × out_dim */
+  long long       next, done;
+  long long       batches, full, timed_out;
+  int             closing;
+  pthread_mutex_t mu;
+  pthread_cond_t  has_work, has_room;
+  pthread_t       worker;
+};
+
+static double mono_ms(void){
+  struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec*1000.0 + ts.tv_nsec/1e6;
+}
+
+static void deadline_ts(double ms, struct timespec* ts){
+  ts->tv_sec  = (time_t)(ms/1000.0);
+  ts->tv_nsec = (long)((ms - ts->tv_sec*1000.0)*1e6);
+  if(ts->tv_nsec>=1000000000L){ ts->tv_sec++; ts->tv_nsec -= 1000000000L; }
+}
+
+static void* batcher_main(void* arg){
+  ParagonBatcher* b = (ParagonBatcher*)arg;
+  pthread_mutex_lock(&b->mu);
+  for(;;){
+    while(b->done==b->next && !b->closing) pthread_cond_wait(&b->has_work, &b->mu);
+    if(b->done==b->next) break;                 /* closing and drained */
+    /* hold the batch open until it is full or its oldest request is due */
+    double due = b->ring[b->done % b->cap].arrived + b->max_wait_us/1000.0;
+    while(b->next - b->done < b->max_batch && !b->closing){
+      struct timespec ts; deadline_ts(due, &ts);
+      if(pthread_cond_timedwait(&b->has_work, &b->mu, &ts)) break;
+    }
+    long long first = b->done;
+    int n = (int)(b->next - first < b->max_batch ? b->next - first : b->max_batch);
+    if(n==b->max_batch) ++b->full; else ++b->timed_out;
+    ++b->batches;
+    pthread_mutex_unlock(&b->mu);
+
+    /* slots in [first, first+n) stay ours until done moves past them */
+    for(int k=0;k<n;k++)
+      memcpy(b->X + (size_t)k*b->in_dim, b->ring[(first+k) % b->cap].x, sizeof(float)*(size_t)b->in_dim);
+    int got = paragon_forward_batch(b->api, b->h, b->X, n, b->in_dim, b->Y, b->out_dim);
+    for(int k=0;k<n;k++){
+      Req* r = &b->ring[(first+k) % b->cap];
+      int m = b->out_dim < r->out_cap ? b->out_dim : r->out_cap;
+      if(got==n){ memcpy(r->y, b->Y + (size_t)k*b->out_dim, sizeof(float)*(size_t)m); r->status = m; }
+      else r->status = -1;
+      if(r->cb) r->cb(r->t, r->status, r->y, r->user);
+    }
+
+    pthread_mutex_lock(&b->mu);
+    for(int k=0;k<n;k++){
+      Req* r = &b->ring[(first+k) % b->cap];
+      if(r->sync){ r->sync->status = r->status; r->sync->finished = 1; }
+    }
+    b->done += n;
+    for(int k=0;k<n;k++) pthread_cond_broadcast(&b->ring[(first+k) % b->cap].cv);
+    pthread_cond_broadcast(&b->has_room);
+  }
+  pthread_mutex_unlock(&b->mu);
+  return NULL;
+}
+
+static void batcher_release(ParagonBatcher* b){
+  if(b->ring) for(int i=0;i<b->cap;i++){ free(b->ring[i].x); pthread_cond_destroy(&b->ring[i].cv); }
+  free(b->ring); free(b->X); free(b->Y); free(b);
+}
+
+ParagonBatcher* paragon_batcher_new(ParagonAPI* api, ParagonHandle h, int in_dim, int out_dim,
+                                    int max_batch, int max_wait_us, int cap){
+  if(!api || in_dim<=0 || out_dim<=0 || max_batch<=0 || max_wait_us<0) return NULL;
+  if(cap<max_batch) cap = 2*max_batch;   /* room to fill the next batch while one runs */
+  ParagonBatcher* b = (ParagonBatcher*)calloc(1, sizeof(*b));
+  if(!b) return NULL;
+  b->api = api; b->h = h; b->in_dim = in_dim; b->out_dim = out_dim;
+  b->max_batch = max_batch; b->max_wait_us = max_wait_us; b->cap = cap;
+  b->ring = (Req*)calloc((size_t)cap, sizeof(Req));
+  b->X = (float*)malloc(sizeof(float)*(size_t)max_batch*in_dim);
+  b->Y = (float*)malloc(sizeof(float)*(size_t)max_batch*out_dim);
+  if(!b->ring || !b->X || !b->Y){ batcher_release(b); return NULL; }
+  for(int i=0;i<cap;i++){
+    b->ring[i].t = -1;
+    pthread_cond_init(&b->ring[i].cv, NULL);
+    b->ring[i].x = (float*)malloc(sizeof(float)*(size_t)in_dim);
+    if(!b->ring[i].x){ batcher_release(b); return NULL; }
+  }
+  pthread_condattr_t ca;
+  pthread_condattr_init(&ca);
+  pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+  pthread_mutex_init(&b->mu, NULL);
+  pthread_cond_init(&b->has_work, &ca);
+  pthread_cond_init(&b->has_room, NULL);
+  pthread_condattr_destroy(&ca);
+  if(pthread_create(&b->worker, NULL, batcher_main, b)){
+    fprintf(stderr, "paragon_batcher_new: pthread_create failed\n");
+    pthread_mutex_destroy(&b->mu);
+    pthread_cond_destroy(&b->has_work); pthread_cond_destroy(&b->has_room);
+    batcher_release(b);
+    return NULL;
+  }
+  return b;
+}
+
+static ParagonTicket submit(ParagonBatcher* b, const float* x, float* y, int out_cap,
+                            paragon_done_fn cb, void* user, Sync* sync){
+  if(!b || !x || !y || out_cap<=0) return -1;
+  pthread_mutex_lock(&b->mu);
+  while(b->next - b->done >= b->cap && !b->closing) pthread_cond_wait(&b->has_room, &b->mu);
+  if(b->closing){ pthread_mutex_unlock(&b->mu); return -1; }
+  ParagonTicket t = b->next;
+  Req* r = &b->ring[t % b->cap];
+  memcpy(r->x, x, sizeof(float)*(size_t)b->in_dim);
+  r->t = t; r->y = y; r->out_cap = out_cap; r->status = -1;
+  r->arrived = mono_ms(); r->cb = cb; r->user = user; r->sync = sync;
+  ++b->next;
+  /* the worker only cares when the batch opens or fills */
+  if(b->next - b->done == 1 || b->next - b->done >= b->max_batch) pthread_cond_signal(&b->has_work);
+  pthread_mutex_unlock(&b->mu);
+  return t;
+}
+
+ParagonTicket paragon_batcher_submit(ParagonBatcher* b, const float* x, float* y, int out_cap,
+                                     paragon_done_fn cb, void* user){
+  return submit(b, x, y, out_cap, cb, user, NULL);
+}
+
+int paragon_batcher_wait(ParagonBatcher* b, ParagonTicket t){
+  if(!b || t<0) return -1;
+  pthread_mutex_lock(&b->mu);
+  if(t>=b->next){ pthread_mutex_unlock(&b->mu); return -1; }
+  Req* r = &b->ring[t % b->cap];
+  while(t>=b->done) pthread_cond_wait(&r->cv, &b->mu);
+  int s = r->t==t ? r->status : -1;
+  pthread_mutex_unlock(&b->mu);
+  return s;
+}
+
+int paragon_batcher_infer(ParagonBatcher* b, const float* x, float* y, int out_cap){
+  Sync s = { -1, 0 };
+  ParagonTicket t = submit(b, x, y, out_cap, NULL, NULL, &s);
+  if(t<0) return -1;
+  pthread_mutex_lock(&b->mu);
+  Req* r = &b->ring[t % b->cap];
+  while(!s.finished) pthread_cond_wait(&r->cv, &b->mu);
+  pthread_mutex_unlock(&b->mu);
+  return s.status;
+}
+
+void paragon_batcher_stats(ParagonBatcher* b, ParagonBatcherStats* st){
+  memset(st, 0, sizeof(*st));
+  if(!b) return;
+  pthread_mutex_lock(&b->mu);
+  st->requests = b->done; st->batches = b->batches;
+  st->full = b->full; st->timed_out = b->timed_out;
+  pthread_mutex_unlock(&b->mu);
+  st->mean_batch = st->batches ? (double)st->requests/st->batches : 0.0;
+}
+
+void paragon_batcher_free(ParagonBatcher* b){
+  if(!b) return;
+  pthread_mutex_lock(&b->mu);
+  b->closing = 1;
+  pthread_cond_broadcast(&b->has_work);
+  pthread_cond_broadcast(&b->has_room);
+  pthread_mutex_unlock(&b->mu);
+  pthread_join(b->worker, NULL);
+  pthread_mutex_destroy(&b->mu);
+  pthread_cond_destroy(&b->has_work);
+  pthread_cond_destroy(&b->has_room);
+  batcher_release(b);
+}
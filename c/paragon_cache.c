@@ -0,0 +1,206 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paragon.h"
+
+/* Forward-result cache. Entries live in one slab (input copy + output per slot), are
+   chained from a power-of-two bucket table on hash(input) and threaded on an LRU list by
+   index. Each entry remembers the handle's model version at the time its forward
+   started; a lookup that finds an older version drops the entry instead of serving it.
+   The stored input is compared in full, so a hash collision costs a miss, never a wrong
+   answer. The forward itself runs outside the lock. */
+
+#define NIL (-1)
+
+typedef struct {
+  ParagonHandle      h;
+  unsigned long long key, version;
+  int                dim, out_n;
+  int                chain;            /* next in bucket */
+  int                prev, next;       /* LRU, head = most recent */
+} Entry;
+
+struct ParagonCache {
+  ParagonAPI*     api;
+  pthread_mutex_t mu;
+  int             cap, in_cap, out_cap, n;
+  Entry*          e;
+  float*          slab;                /* cap × (in_cap + out_cap) */
+  int*            bucket;
+  unsigned        bmask;
+  int             head, tail, free_list;
+  long long       hits, misses, evictions, invalidated;
+};
+
+/* 8 bytes at a time, four independent multiply-xorshift lanes */
+static unsigned long long hash_floats(const float* x, int n){
+  const unsigned char* p = (const unsigned char*)x;
+  size_t len = (size_t)n*sizeof(float), i = 0;
+  unsigned long long a = 0x9E3779B97F4A7C15ull ^ len, b = 0xC2B2AE3D27D4EB4Full;
+  unsigned long long c = 0x165667B19E3779F9ull, d = 0xD6E8FEB86659FD93ull;
+  for(; i+32<=len; i+=32){
+    unsigned long long w[4]; memcpy(w, p+i, 32);
+    a = (a ^ w[0]) * 0xFF51AFD7ED558CCDull; a ^= a>>29;
+    b = (b ^ w[1]) * 0xFF51AFD7ED558CCDull; b ^= b>>29;
+    c = (c ^ w[2]) * 0xFF51AFD7ED558CCDull; c ^= c>>29;
+    d = (d ^ w[3]) * 0xFF51AFD7ED558CCDull; d ^= d>>29;
+  }
+  for(; i+8<=len; i+=8){
+    unsigned long long w; memcpy(&w, p+i, 8);
+    a = (a ^ w) * 0xFF51AFD7ED558CCDull; a ^= a>>29;
+  }
+  if(i<len){
+    unsigned long long w = 0; memcpy(&w, p+i, len-i);
+    b = (b ^ w) * 0xFF51AFD7ED558CCDull; b ^= b>>29;
+  }
+  unsigned long long h = a ^ (b<<17 | b>>47) ^ (c<<31 | c>>33) ^ (d<<47 | d>>17);
+  h ^= h>>33; h *= 0xC4CEB9FE1A85EC53ull; h ^= h>>33;
+  return h;
+}
+
+static float* in_of(ParagonCache* c, int i){ return c->slab + (size_t)i*(c->in_cap + c->out_cap); }
+static float* out_of(ParagonCache* c, int i){ return in_of(c, i) + c->in_cap; }
+
+ParagonCache* paragon_cache_new(ParagonAPI* api, int capacity, int in_cap, int out_cap){
+  if(!api || capacity<=0 || in_cap<=0 || out_cap<=0) return NULL;
+  ParagonCache* c = (ParagonCache*)calloc(1, sizeof(*c));
+  if(!c) return NULL;
+  unsigned nb = 1;
+  while(nb < 2u*(unsigned)capacity) nb <<= 1;
+  c->api = api; c->cap = capacity; c->in_cap = in_cap; c->out_cap = out_cap;
+  c->e      = (Entry*)calloc((size_t)capacity, sizeof(Entry));
+  c->slab   = (float*)malloc(sizeof(float)*(size_t)capacity*(size_t)(in_cap + out_cap));
+  c->bucket = (int*)malloc(sizeof(int)*nb);
+  if(!c->e || !c->slab || !c->bucket){
+    fprintf(stderr, "paragon_cache_new: out of memory for %d entries\n", capacity);
+    free(c->e); free(c->slab); free(c->bucket); free(c);
+    return NULL;
+  }
+  c->bmask = nb-1;
+  for(unsigned i=0;i<nb;i++) c->bucket[i] = NIL;
+  for(int i=0;i<capacity;i++) c->e[i].chain = i+1<capacity ? i+1 : NIL;
+  c->free_list = 0;
+  c->head = c->tail = NIL;
+  pthread_mutex_init(&c->mu, NULL);
+  return c;
+}
+
+static void lru_unlink(ParagonCache* c, int i){
+  Entry* e = &c->e[i];
+  if(e->prev!=NIL) c->e[e->prev].next = e->next; else c->head = e->next;
+  if(e->next!=NIL) c->e[e->next].prev = e->prev; else c->tail = e->prev;
+}
+
+static void lru_push(ParagonCache* c, int i){
+  Entry* e = &c->e[i];
+  e->prev = NIL; e->next = c->head;
+  if(c->head!=NIL) c->e[c->head].prev = i; else c->tail = i;
+  c->head = i;
+}
+
+/* unchain + unlink + back on the free list */
+static void drop_locked(ParagonCache* c, int i){
+  int* pp = &c->bucket[c->e[i].key & c->bmask];
+  while(*pp!=i) pp = &c->e[*pp].chain;
+  *pp = c->e[i].chain;
+  lru_unlink(c, i);
+  c->e[i].chain = c->free_list; c->free_list = i;
+  --c->n;
+}
+
+static int find_locked(ParagonCache* c, ParagonHandle h, unsigned long long key, int dim){
+  for(int i = c->bucket[key & c->bmask]; i!=NIL; i = c->e[i].chain)
+    if(c->e[i].key==key && c->e[i].h==h && c->e[i].dim==dim) return i;
+  return NIL;
+}
+
+int paragon_cache_forward(ParagonCache* c, ParagonHandle h, const float* x, int dim,
+                          float* y, int out_cap){
+  if(!c || !x || !y || dim<=0) return -1;
+  ParagonAPI* api = c->api;
+  unsigned long long key = hash_floats(x, dim);
+  unsigned long long ver = paragon_handle_version(api, h);   /* before the forward */
+
+  pthread_mutex_lock(&c->mu);
+  if(dim<=c->in_cap){
+    int i = find_locked(c, h, key, dim);
+    if(i!=NIL && c->e[i].version!=ver){
+      drop_locked(c, i); ++c->invalidated; i = NIL;
+    }
+    if(i!=NIL && !memcmp(in_of(c, i), x, sizeof(float)*(size_t)dim) && c->e[i].out_n<=out_cap){
+      int n = c->e[i].out_n;
+      memcpy(y, out_of(c, i), sizeof(float)*(size_t)n);
+      lru_unlink(c, i); lru_push(c, i);
+      ++c->hits;
+      pthread_mutex_unlock(&c->mu);
+      return n;
+    }
+  }
+  ++c->misses;
+  pthread_mutex_unlock(&c->mu);
+
+  if(!paragon_forward_f32(api, h, x, 1, dim)) return -1;
+  int n = paragon_extract_f32(api, h, y, out_cap);
+  if(n<=0 || n>c->out_cap || dim>c->in_cap) return n;
+
+  pthread_mutex_lock(&c->mu);
+  int i = find_locked(c, h, key, dim);        /* same hash: a collision, or a racing miss */
+  if(i!=NIL) lru_unlink(c, i);
+  else {
+    if(c->free_list==NIL){ drop_locked(c, c->tail); ++c->evictions; }
+    i = c->free_list; c->free_list = c->e[i].chain;
+    c->e[i].h = h; c->e[i].key = key; c->e[i].dim = dim;
+    c->e[i].chain = c->bucket[key & c->bmask]; c->bucket[key & c->bmask] = i;
+    ++c->n;
+  }
+  c->e[i].version = ver; c->e[i].out_n = n;
+  memcpy(in_of(c, i), x, sizeof(float)*(size_t)dim);
+  memcpy(out_of(c, i), y, sizeof(float)*(size_t)n);
+  lru_push(c, i);
+  pthread_mutex_unlock(&c->mu);
+  return n;
+}
+
+int paragon_cache_invalidate(ParagonCache* c, ParagonHandle h){
+  if(!c) return 0;
+  int k = 0;
+  pthread_mutex_lock(&c->mu);
+  for(int i=c->head; i!=NIL; ){
+    int nx = c->e[i].next;
+    if(c->e[i].h==h){ drop_locked(c, i); ++k; }
+    i = nx;
+  }
+  c->invalidated += k;
+  pthread_mutex_unlock(&c->mu);
+  return k;
+}
+
+void paragon_cache_clear(ParagonCache* c){
+  if(!c) return;
+  pthread_mutex_lock(&c->mu);
+  while(c->head!=NIL) drop_locked(c, c->head);
+  pthread_mutex_unlock(&c->mu);
+}
+
+void paragon_cache_stats(ParagonCache* c, ParagonCacheStats* st){
+  memset(st, 0, sizeof(*st));
+  if(!c) return;
+  pthread_mutex_lock(&c->mu);
+  st->hits = c->hits; st->misses = c->misses;
+  st->evictions = c->evictions; st->invalidated = c->invalidated;
+  st->entries = c->n; st->capacity = c->cap;
+  pthread_mutex_unlock(&c->mu);
+  long long q = st->hits + st->misses;
+  st->hit_rate = q ? (double)st->hits/q : 0.0;
+}
+
+void paragon_cache_free(ParagonCache* c){
+  if(!c) return;
+  pthread_mutex_destroy(&c->mu);
+  free(c->e); free(c->slab); free(c->bucket);
+  free(c);
+}
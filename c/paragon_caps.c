@@ -0,0 +1,136 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paragon.h"
+
+/* Capability negotiation. paragon_load probes once: the resolved exports give the
+   PARAGON_CAP_* export bits, and a throwaway 1→1 network built with expose_methods_json
+   lists the methods the library dispatches (and is freed again when the library exports
+   FreeNetwork). paragon_enable_gpu then makes one call,
+   the first advertised GPU knob. If that knob answers with an error, or the library
+   could not be probed, the next candidate is tried and the winner is remembered, so
+   every later handle makes exactly one call. */
+
+static const struct { const char* method; const char* args; unsigned long long cap; } ENABLE[] = {
+  { "SetWebGPUNative", "[true]",                      PARAGON_CAP_SET_WEBGPU_NATIVE },
+  { "WebGPUNativeOn",  "[]",                          PARAGON_CAP_WEBGPU_NATIVE_ON },
+  { "Configure",       "[{\"WebGPUNative\":true}]",   PARAGON_CAP_CONFIGURE },
+  { "SetOptions",      "[{\"WebGPUNative\":true}]",   PARAGON_CAP_SET_OPTIONS },
+  { "SetField",        "[\"WebGPUNative\",true]",     PARAGON_CAP_SET_FIELD },
+  { "Call",            "[\"SetWebGPUNative\",[true]]", PARAGON_CAP_CALL },
+};
+#define NENABLE ((int)(sizeof(ENABLE)/sizeof(ENABLE[0])))
+
+static const struct { unsigned long long cap; const char* name; } NAMES[] = {
+  { PARAGON_CAP_PROBED,        "probed" },
+  { PARAGON_CAP_RAW_IO,        "raw-io" },
+  { PARAGON_CAP_BATCH,         "batch" },
+  { PARAGON_CAP_STAGING,       "staging" },
+  { PARAGON_CAP_METHOD_ID,     "method-id" },
+  { PARAGON_CAP_FREE_RESULT,   "free-result" },
+  { PARAGON_CAP_GPU_CACHE,     "gpu-cache" },
+  { PARAGON_CAP_MODEL,         "model" },
+  { PARAGON_CAP_ADAPTERS,      "adapters" },
+  { PARAGON_CAP_QUANT,         "quant" },
+  { PARAGON_CAP_GROUP,         "group" },
+  { PARAGON_CAP_TRAIN,         "train" },
+  { PARAGON_CAP_DETERMINISM,   "deterministic" },
+  { PARAGON_CAP_MEMINFO,       "meminfo" },
+  { PARAGON_CAP_FREE_NET,      "free-network" },
+  { PARAGON_CAP_INFERENCE,     "inference-only" },
+  { PARAGON_CAP_INIT_GPU,      "InitializeOptimizedGPU" },
+  { PARAGON_CAP_TOGGLE_GPU,    "ToggleGPU" },
+};
+
+/* an error reply is any object carrying an "error" key */
+static int reply_ok(const char* r){
+  return r && !strstr(r, "\"error\"");
+}
+
+void paragon_probe(ParagonAPI* api){
+  unsigned long long c = 0;
+  if(api->Forward_F32 && api->ExtractOutput_F32) c |= PARAGON_CAP_RAW_IO;
+  if(api->ForwardBatch_F32)                      c |= PARAGON_CAP_BATCH;
+  if(api->ForwardGroup_F32)                      c |= PARAGON_CAP_GROUP;
+  if(api->Train_F32)                             c |= PARAGON_CAP_TRAIN;
+  if(api->SetDeterministic)                      c |= PARAGON_CAP_DETERMINISM;
+  if(api->MemoryInfo)                            c |= PARAGON_CAP_MEMINFO;
+  if(api->FreeNetwork)                           c |= PARAGON_CAP_FREE_NET;
+  if(api->SetInferenceOnly)                      c |= PARAGON_CAP_INFERENCE;
+  if(api->RegisterStaging && api->ForwardStaged) c |= PARAGON_CAP_STAGING;
+  if(api->MethodID && api->CallID)               c |= PARAGON_CAP_METHOD_ID;
+  if(api->FreeResult)                            c |= PARAGON_CAP_FREE_RESULT;
+  if(api->ExportGPUCache && api->ImportGPUCache) c |= PARAGON_CAP_GPU_CACHE;
+  if(api->NewFromModel || api->SetLayerWeights)  c |= PARAGON_CAP_MODEL;
+  if(api->AdapterCount && api->InitGPUOn)        c |= PARAGON_CAP_ADAPTERS;
+  if(api->SetLayerWeightsQ)                      c |= PARAGON_CAP_QUANT;
+
+  if(api->New5){
+    char* r = api->New5("[{\"Width\":1,\"Height\":1},{\"Width\":1,\"Height\":1}]",
+                        "[\"linear\",\"linear\"]", "[false,false]", false, true);
+    const char* m = r ? strstr(r, "\"methods\"") : NULL;
+    if(m){
+      char pat[64];
+      c |= PARAGON_CAP_PROBED;
+      for(int i=0; i<NENABLE; ++i){
+        snprintf(pat, sizeof(pat), "\"%s\"", ENABLE[i].method);
+        if(strstr(m, pat)) c |= ENABLE[i].cap;
+      }
+      if(strstr(m, "\"InitializeOptimizedGPU\"")) c |= PARAGON_CAP_INIT_GPU;
+      if(strstr(m, "\"ToggleGPU\""))              c |= PARAGON_CAP_TOGGLE_GPU;
+      if(strstr(m, "\"SetDeterministic\""))       c |= PARAGON_CAP_DETERMINISM;
+      if(strstr(m, "\"SetInferenceOnly\""))       c |= PARAGON_CAP_INFERENCE;
+    }
+    ParagonHandle h = paragon_parse_handle(r);
+    if(h>0 && api->FreeNetwork) api->FreeNetwork(h);
+    paragon_free_result(api, r);
+  }
+  api->caps = c;
+}
+
+static int next_candidate(const ParagonAPI* api, int from){
+  for(int i=from; i<NENABLE; ++i)
+    if(!(api->caps & PARAGON_CAP_PROBED) || (api->caps & ENABLE[i].cap)) return i;
+  return -2;
+}
+
+int paragon_enable_gpu(ParagonAPI* api, ParagonHandle h){
+  if(!api || !api->Call || h<=0) return 0;
+  int i = __atomic_load_n(&api->gpu_enable, __ATOMIC_ACQUIRE);
+  if(i==-1) i = next_candidate(api, 0);
+  while(i>=0){
+    ParagonMethod m = paragon_method_id(api, h, ENABLE[i].method);
+    char* r = m>=0 ? paragon_call_id(api, h, m, ENABLE[i].args)
+                   : api->Call(h, ENABLE[i].method, ENABLE[i].args);
+    int ok = reply_ok(r);
+    paragon_free_result(api, r);
+    if(ok){ __atomic_store_n(&api->gpu_enable, i, __ATOMIC_RELEASE); return 1; }
+    i = next_candidate(api, i+1);
+  }
+  __atomic_store_n(&api->gpu_enable, -2, __ATOMIC_RELEASE);   /* nothing works: stop trying */
+  return 0;
+}
+
+const char* paragon_gpu_enable_method(const ParagonAPI* api){
+  int i = __atomic_load_n(&api->gpu_enable, __ATOMIC_ACQUIRE);
+  return i>=0 ? ENABLE[i].method : (i==-2 ? "none" : "pending");
+}
+
+int paragon_caps_string(const ParagonAPI* api, char* out, size_t n){
+  size_t w = 0;
+  if(n) out[0] = 0;
+  for(size_t i=0; i<sizeof(NAMES)/sizeof(NAMES[0]); ++i){
+    if(!(api->caps & NAMES[i].cap)) continue;
+    int k = snprintf(out+w, n>w ? n-w : 0, "%s%s", w ? " " : "", NAMES[i].name);
+    if(k>0) w += (size_t)k;
+  }
+  for(int i=0; i<NENABLE; ++i){
+    if(!(api->caps & ENABLE[i].cap)) continue;
+    int k = snprintf(out+w, n>w ? n-w : 0, "%s%s", w ? " " : "", ENABLE[i].method);
+    if(k>0) w += (size_t)k;
+  }
+  return (int)w;
+}
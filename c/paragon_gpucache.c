@@ -0,0 +1,127 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "paragon.h"
+
+/* On-disk GPU pipeline cache. The bridge only stores and returns what the library's
+   ExportGPUCache produced; the blob format is the library's business. Each entry is
+   written to a temp file and renamed, so a crashed or concurrent writer never leaves
+   a torn entry behind. The adapter file remembers the last adapter so a fresh process
+   can compute the key before InitializeOptimizedGPU tells it. */
+
+#define PGC_MAGIC   0x31434750u   /* "PGC1" */
+#define PGC_MAX     (256ll<<20)   /* refuse absurd blobs */
+
+typedef struct {
+  uint32_t magic, pad;
+  uint64_t key;
+  uint64_t len;
+} PgcHeader;
+
+unsigned long long paragon_hash64(const void* p, size_t n, unsigned long long seed){
+  const unsigned char* b = (const unsigned char*)p;
+  unsigned long long x = 0xcbf29ce484222325ull ^ seed;
+  for(size_t i=0;i<n;i++){ x ^= b[i]; x *= 0x100000001b3ull; }
+  return x;
+}
+
+static void adapter_path(const ParagonAPI* api, char* out, size_t n){
+  snprintf(out, n, "%s/adapter", api->gpu_cache_dir);
+}
+
+int paragon_gpu_cache_open(ParagonAPI* api, const char* dir){
+  if(!api || !dir || !*dir) return 0;
+  if(mkdir(dir, 0755) && errno!=EEXIST){
+    fprintf(stderr, "gpu cache: cannot create %s: %s\n", dir, strerror(errno));
+    return 0;
+  }
+  snprintf(api->gpu_cache_dir, sizeof(api->gpu_cache_dir), "%s", dir);
+  char p[600]; adapter_path(api, p, sizeof(p));
+  FILE* f = fopen(p, "r");
+  if(f){
+    if(fgets(api->adapter, sizeof(api->adapter), f)) api->adapter[strcspn(api->adapter, "\n")] = 0;
+    fclose(f);
+  }
+  return 1;
+}
+
+static unsigned long long entry_key(ParagonAPI* api, ParagonHandle h){
+  ParagonHandleInfo hi;
+  if(!paragon_handle_info(api, h, &hi)) return 0;
+  unsigned long long k = paragon_hash64(api->lib_version, strlen(api->lib_version), hi.shape_key);
+  /* a bound handle is keyed by adapter index; the default adapter by its last reply */
+  if(hi.adapter>=0) return paragon_hash64(&hi.adapter, sizeof(hi.adapter), k);
+  return paragon_hash64(api->adapter, strlen(api->adapter), k);
+}
+
+int paragon_gpu_cache_path(ParagonAPI* api, ParagonHandle h, char* out, size_t n){
+  if(!api || !api->gpu_cache_dir[0]) return 0;
+  unsigned long long k = entry_key(api, h);
+  if(!k) return 0;
+  snprintf(out, n, "%s/%016llx.pgc", api->gpu_cache_dir, k);
+  return 1;
+}
+
+int paragon_gpu_cache_import(ParagonAPI* api, ParagonHandle h){
+  if(!api || !api->ImportGPUCache) return 0;
+  char p[600];
+  if(!paragon_gpu_cache_path(api, h, p, sizeof(p))) return 0;
+  FILE* f = fopen(p, "rb");
+  if(!f) return 0;
+  PgcHeader hd;
+  void* blob = NULL;
+  int ok = fread(&hd, sizeof(hd), 1, f)==1 && hd.magic==PGC_MAGIC &&
+           hd.key==entry_key(api, h) && hd.len>0 && (long long)hd.len<=PGC_MAX;
+  if(ok){
+    blob = malloc((size_t)hd.len);
+    ok = blob && fread(blob, 1, (size_t)hd.len, f)==(size_t)hd.len;
+  }
+  fclose(f);
+  if(ok) ok = api->ImportGPUCache(h, blob, (long long)hd.len)==0;
+  free(blob);
+  if(!ok) (void)unlink(p);   /* stale or rejected: let the next init rewrite it */
+  return ok;
+}
+
+static int write_atomic(const char* path, const void* a, size_t na, const void* b, size_t nb){
+  char tmp[640];
+  snprintf(tmp, sizeof(tmp), "%s.tmp.%ld", path, (long)getpid());
+  FILE* f = fopen(tmp, "wb");
+  if(!f) return 0;
+  int ok = fwrite(a, 1, na, f)==na && (!nb || fwrite(b, 1, nb, f)==nb);
+  ok = fclose(f)==0 && ok;
+  if(ok) ok = rename(tmp, path)==0;
+  if(!ok) (void)unlink(tmp);
+  return ok;
+}
+
+void paragon_gpu_cache_export(ParagonAPI* api, ParagonHandle h, const char* adapter){
+  if(!api || !api->gpu_cache_dir[0] || !api->ExportGPUCache) return;
+  /* key on the adapter that actually answered, and remember it for the next process */
+  ParagonHandleInfo hi;
+  int bound = paragon_handle_info(api, h, &hi) && hi.adapter>=0;
+  if(!bound && adapter && *adapter && strncmp(api->adapter, adapter, sizeof(api->adapter)-1)){
+    snprintf(api->adapter, sizeof(api->adapter), "%.*s", (int)strcspn(adapter, "\n"), adapter);
+    char ap[600]; adapter_path(api, ap, sizeof(ap));
+    (void)write_atomic(ap, api->adapter, strlen(api->adapter), "\n", 1);
+  }
+  long long n = api->ExportGPUCache(h, NULL, 0);
+  if(n<=0 || n>PGC_MAX) return;
+  void* blob = malloc((size_t)n);
+  if(!blob) return;
+  long long got = api->ExportGPUCache(h, blob, n);
+  char p[600];
+  if(got==n && paragon_gpu_cache_path(api, h, p, sizeof(p))){
+    PgcHeader hd = { PGC_MAGIC, 0, entry_key(api, h), (uint64_t)n };
+    if(!write_atomic(p, &hd, sizeof(hd), blob, (size_t)n))
+      fprintf(stderr, "gpu cache: cannot write %s\n", p);
+  }
+  free(blob);
+}
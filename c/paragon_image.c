@@ -0,0 +1,307 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "paragon.h"
+
+/* Just enough image decoding to put MNIST-style files in front of a handle.
+
+   inflate follows RFC 1951 the canonical way: a Huffman code is kept as the count of
+   codes per length plus the symbols in code order, and decoded a bit at a time (codes
+   are short and the images small, so a lookup table would not pay for itself). The
+   zlib wrapper's Adler-32 and PNG CRCs are not checked. */
+
+#define MAXBITS 15
+#define MAXLCODES 286
+#define MAXDCODES 30
+#define FIXLCODES 288
+
+typedef struct {
+  const unsigned char* in;
+  size_t               inlen, inpos;
+  unsigned             bitbuf;
+  int                  bitcnt, err;
+  unsigned char*       out;
+  size_t               outlen, outpos;
+} Inflate;
+
+typedef struct {
+  short count[MAXBITS+1];   /* codes of each length */
+  short symbol[FIXLCODES];  /* symbols ordered by code */
+} Huffman;
+
+static int bits(Inflate* s, int need){
+  unsigned val = s->bitbuf;
+  while(s->bitcnt<need){
+    if(s->inpos>=s->inlen){ s->err = 1; return 0; }
+    val |= (unsigned)s->in[s->inpos++] << s->bitcnt;
+    s->bitcnt += 8;
+  }
+  s->bitbuf = val >> need;
+  s->bitcnt -= need;
+  return (int)(val & ((1u<<need) - 1));
+}
+
+static int stored(Inflate* s){
+  s->bitbuf = 0; s->bitcnt = 0;      /* to the byte boundary */
+  if(s->inlen - s->inpos < 4) return 0;
+  const unsigned char* p = s->in + s->inpos;
+  size_t len = (size_t)p[0] | (size_t)p[1]<<8, nlen = (size_t)p[2] | (size_t)p[3]<<8;
+  s->inpos += 4;
+  if(len!=(~nlen & 0xffff) || s->inlen - s->inpos < len || s->outlen - s->outpos < len) return 0;
+  memcpy(s->out + s->outpos, s->in + s->inpos, len);
+  s->inpos += len; s->outpos += len;
+  return 1;
+}
+
+static int decode(Inflate* s, const Huffman* h){
+  int code = 0, first = 0, index = 0;
+  for(int len=1; len<=MAXBITS; ++len){
+    code |= bits(s, 1);
+    if(s->err) return -1;
+    int count = h->count[len];
+    if(code - count < first) return h->symbol[index + (code - first)];
+    index += count; first += count;
+    first <<= 1; code <<= 1;
+  }
+  return -1;
+}
+
+/* 0 = complete code, >0 = incomplete, <0 = oversubscribed */
+static int build(Huffman* h, const short* length, int n){
+  memset(h->count, 0, sizeof(h->count));
+  for(int i=0;i<n;i++) h->count[length[i]]++;
+  if(h->count[0]==n) return 0;
+  int left = 1;
+  for(int len=1; len<=MAXBITS; ++len){
+    left <<= 1;
+    left -= h->count[len];
+    if(left<0) return left;
+  }
+  short offs[MAXBITS+1];
+  offs[1] = 0;
+  for(int len=1; len<MAXBITS; ++len) offs[len+1] = (short)(offs[len] + h->count[len]);
+  for(int i=0;i<n;i++) if(length[i]) h->symbol[offs[length[i]]++] = (short)i;
+  return left;
+}
+
+static int codes(Inflate* s, const Huffman* lencode, const Huffman* distcode){
+  static const short LBASE[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,
+                                   35,43,51,59,67,83,99,115,131,163,195,227,258 };
+  static const short LEXT[29]  = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+  static const short DBASE[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,
+                                   1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+  static const short DEXT[30]  = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+  for(;;){
+    int sym = decode(s, lencode);
+    if(sym<0) return 0;
+    if(sym<256){
+      if(s->outpos>=s->outlen) return 0;
+      s->out[s->outpos++] = (unsigned char)sym;
+    } else if(sym==256){
+      return 1;
+    } else {
+      sym -= 257;
+      if(sym>=29) return 0;
+      size_t len = (size_t)LBASE[sym] + (size_t)bits(s, LEXT[sym]);
+      int ds = decode(s, distcode);
+      if(ds<0 || ds>=30) return 0;
+      size_t dist = (size_t)DBASE[ds] + (size_t)bits(s, DEXT[ds]);
+      if(s->err || dist>s->outpos || s->outlen - s->outpos < len) return 0;
+      for(size_t i=0;i<len;i++, s->outpos++) s->out[s->outpos] = s->out[s->outpos - dist];
+    }
+  }
+}
+
+static Huffman g_fixlen, g_fixdist;
+static pthread_once_t g_fixed_once = PTHREAD_ONCE_INIT;
+
+static void build_fixed(void){
+  short lengths[FIXLCODES];
+  int i = 0;
+  for(; i<144; ++i) lengths[i] = 8;
+  for(; i<256; ++i) lengths[i] = 9;
+  for(; i<280; ++i) lengths[i] = 7;
+  for(; i<FIXLCODES; ++i) lengths[i] = 8;
+  (void)build(&g_fixlen, lengths, FIXLCODES);
+  for(i=0; i<MAXDCODES; ++i) lengths[i] = 5;
+  (void)build(&g_fixdist, lengths, MAXDCODES);
+}
+
+static int fixed(Inflate* s){
+  pthread_once(&g_fixed_once, build_fixed);
+  return codes(s, &g_fixlen, &g_fixdist);
+}
+
+static int dynamic(Inflate* s){
+  static const short ORDER[19] = { 16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15 };
+  short lengths[MAXLCODES+MAXDCODES];
+  int nlen = bits(s, 5) + 257, ndist = bits(s, 5) + 1, ncode = bits(s, 4) + 4;
+  if(s->err || nlen>MAXLCODES || ndist>MAXDCODES) return 0;
+  int i = 0;
+  for(; i<ncode; ++i) lengths[ORDER[i]] = (short)bits(s, 3);
+  for(; i<19; ++i) lengths[ORDER[i]] = 0;
+  Huffman lencode, distcode;
+  if(s->err || build(&lencode, lengths, 19)!=0) return 0;   /* must be complete */
+
+  for(i=0; i<nlen+ndist; ){
+    int sym = decode(s, &lencode);
+    if(sym<0) return 0;
+    if(sym<16){ lengths[i++] = (short)sym; continue; }
+    short len = 0;
+    int rep;
+    if(sym==16){
+      if(!i) return 0;
+      len = lengths[i-1];
+      rep = 3 + bits(s, 2);
+    } else rep = sym==17 ? 3 + bits(s, 3) : 11 + bits(s, 7);
+    if(s->err || i + rep > nlen + ndist) return 0;
+    while(rep--) lengths[i++] = len;
+  }
+  if(!lengths[256]) return 0;    /* no end-of-block code */
+  int left = build(&lencode, lengths, nlen);
+  if(left<0 || (left>0 && nlen - lencode.count[0] != 1)) return 0;
+  left = build(&distcode, lengths + nlen, ndist);
+  if(left<0 || (left>0 && ndist - distcode.count[0] != 1)) return 0;
+  return codes(s, &lencode, &distcode);
+}
+
+/* zlib stream → out; 1 = it filled exactly outlen bytes */
+static int inflate_zlib(const unsigned char* in, size_t inlen, unsigned char* out, size_t outlen){
+  if(inlen<2 || (in[0] & 0x0f)!=8 || ((in[0]<<8) | in[1]) % 31 || (in[1] & 0x20)) return 0;
+  Inflate s = { .in = in, .inlen = inlen, .inpos = 2, .out = out, .outlen = outlen };
+  int last;
+  do {
+    last = bits(&s, 1);
+    int type = bits(&s, 2);
+    if(s.err) return 0;
+    int ok = type==0 ? stored(&s) : type==1 ? fixed(&s) : type==2 ? dynamic(&s) : 0;
+    if(!ok || s.err) return 0;
+  } while(!last);
+  return s.outpos==outlen;
+}
+
+static unsigned be32(const unsigned char* p){
+  return (unsigned)p[0]<<24 | (unsigned)p[1]<<16 | (unsigned)p[2]<<8 | (unsigned)p[3];
+}
+
+static int paeth(int a, int b, int c){
+  int p = a + b - c, pa = p>a ? p-a : a-p, pb = p>b ? p-b : b-p, pc = p>c ? p-c : c-p;
+  return pa<=pb && pa<=pc ? a : pb<=pc ? b : c;
+}
+
+static int unfilter(unsigned char* raw, size_t stride, unsigned h, size_t bpp){
+  for(unsigned y=0; y<h; ++y){
+    unsigned char* cur = raw + (size_t)y*(stride+1);
+    const unsigned char* up = y ? cur - (stride+1) + 1 : NULL;
+    int f = *cur++;
+    if(f>4) return 0;
+    for(size_t i=0;i<stride && f;i++){
+      int a = i>=bpp ? cur[i-bpp] : 0, b = up ? up[i] : 0, c = up && i>=bpp ? up[i-bpp] : 0;
+      cur[i] = (unsigned char)(cur[i] + (f==1 ? a : f==2 ? b : f==3 ? (a + b) / 2 : paeth(a, b, c)));
+    }
+  }
+  return 1;
+}
+
+/* sample k (channel) of pixel x in an unfiltered row, scaled to 0..255 */
+static int sample(const unsigned char* row, unsigned x, int k, int ch, int depth, int index){
+  if(depth==8)  return row[(size_t)x*ch + k];
+  if(depth==16) return row[((size_t)x*ch + k)*2];
+  size_t bit = (size_t)x*depth;
+  int v = (row[bit/8] >> (8 - depth - (int)(bit%8))) & ((1<<depth) - 1);
+  return index ? v : v*255 / ((1<<depth) - 1);
+}
+
+static int luma(int r, int g, int b){ return (2126*r + 7152*g + 722*b + 5000) / 10000; }
+
+int paragon_png_decode(ParagonArena* a, const void* buf, size_t len, ParagonImage* img){
+  static const unsigned char SIG[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+  const unsigned char* p = (const unsigned char*)buf;
+  if(!a || !p || !img || len<8 || memcmp(p, SIG, 8)) return 0;
+  memset(img, 0, sizeof(*img));
+
+  unsigned w = 0, h = 0;
+  int depth = 0, type = -1, npal = 0, nidat = 0;
+  const unsigned char* pal = NULL;
+  const unsigned char* z = NULL;
+  size_t zlen = 0;
+  for(size_t off = 8; off + 12 <= len; ){
+    size_t n = be32(p + off);
+    const unsigned char* t = p + off + 4;
+    const unsigned char* d = p + off + 8;
+    if(n > len - off - 12) return 0;
+    if(!memcmp(t, "IHDR", 4)){
+      if(n<13 || d[10] || d[11] || d[12]) return 0;    /* deflate, adaptive filters, no interlace */
+      w = be32(d); h = be32(d+4); depth = d[8]; type = d[9];
+    } else if(!memcmp(t, "PLTE", 4)){
+      pal = d; npal = (int)(n/3 > 256 ? 256 : n/3);
+    } else if(!memcmp(t, "IDAT", 4)){
+      if(!nidat++) z = d;
+      zlen += n;
+    } else if(!memcmp(t, "IEND", 4)) break;
+    off += 12 + n;
+  }
+  int ch = type==0 ? 1 : type==2 ? 3 : type==3 ? 1 : type==4 ? 2 : type==6 ? 4 : 0;
+  int ok_depth = depth==8 || (depth==16 && type!=3) || ((depth==1 || depth==2 || depth==4) && ch==1);
+  if(!ch || !ok_depth || !w || !h || w>16384 || h>16384 || !zlen || (type==3 && !pal)) return 0;
+
+  if(nidat>1){      /* split image data: join it */
+    unsigned char* joined = (unsigned char*)paragon_arena_alloc(a, zlen);
+    if(!joined) return 0;
+    size_t at = 0;
+    for(size_t off = 8; off + 12 <= len; ){
+      size_t n = be32(p + off);
+      if(!memcmp(p + off + 4, "IDAT", 4)){ memcpy(joined + at, p + off + 8, n); at += n; }
+      else if(!memcmp(p + off + 4, "IEND", 4)) break;
+      off += 12 + n;
+    }
+    z = joined;
+  }
+  size_t stride = ((size_t)w*ch*depth + 7) / 8, bpp = (size_t)ch*depth/8 ? (size_t)ch*depth/8 : 1;
+  unsigned char* raw = (unsigned char*)paragon_arena_alloc(a, (stride+1)*h);
+  unsigned char* px = (unsigned char*)paragon_arena_alloc(a, (size_t)w*h);
+  if(!raw || !px) return 0;
+  if(!inflate_zlib(z, zlen, raw, (stride+1)*h) || !unfilter(raw, stride, h, bpp)) return 0;
+
+  for(unsigned y=0; y<h; ++y){
+    const unsigned char* row = raw + (size_t)y*(stride+1) + 1;
+    unsigned char* o = px + (size_t)y*w;
+    for(unsigned x=0; x<w; ++x){
+      int v;
+      if(type==3){
+        int i = sample(row, x, 0, 1, depth, 1);
+        v = i<npal ? luma(pal[3*i], pal[3*i+1], pal[3*i+2]) : 0;
+      } else if(ch>=3){
+        v = luma(sample(row, x, 0, ch, depth, 0), sample(row, x, 1, ch, depth, 0), sample(row, x, 2, ch, depth, 0));
+      } else v = sample(row, x, 0, ch, depth, 0);
+      if(ch==2 || ch==4) v = v * sample(row, x, ch-1, ch, depth, 0) / 255;
+      o[x] = (unsigned char)v;
+    }
+  }
+  img->w = (int)w; img->h = (int)h; img->px = px;
+  return 1;
+}
+
+int paragon_idx_images(const void* buf, size_t len, int* count, int* rows, int* cols,
+                       const unsigned char** data){
+  const unsigned char* p = (const unsigned char*)buf;
+  if(!p || len<16 || be32(p)!=2051) return 0;
+  unsigned n = be32(p+4), r = be32(p+8), c = be32(p+12);
+  if(!r || !c || r>4096 || c>4096 || (len - 16) / ((size_t)r*c) < n) return 0;
+  if(count) *count = (int)n;
+  if(rows) *rows = (int)r;
+  if(cols) *cols = (int)c;
+  if(data) *data = p + 16;
+  return 1;
+}
+
+void paragon_image_input(const ParagonImage* img, float* x, int w, int h){
+  if(!img || !img->px || !x || w<=0 || h<=0) return;
+  for(int r=0; r<h; ++r){
+    const unsigned char* row = img->px + (size_t)((long long)r*img->h/h)*img->w;
+    for(int c=0; c<w; ++c) x[(size_t)r*w + c] = row[(long long)c*img->w/w] / 255.0f;
+  }
+}
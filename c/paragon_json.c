@@ -0,0 +1,178 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paragon.h"
+
+/* Streaming float-array decoder. Chunks are fed as they arrive; numbers inside arrays
+   (and outside strings) go straight into the caller's buffer, nothing is allocated.
+   A number split across two chunks is carried in r->tok. Digits are consumed eight at
+   a time with SWAR arithmetic; values that are exactly representable via one double
+   multiply/divide skip strtof, everything else (long mantissas, big exponents, the rare
+   float rounding midpoint) takes strtof so results match it bit for bit. */
+
+static int is_num_ch(char c){
+  return (c>='0' && c<='9') || c=='-' || c=='+' || c=='.' || c=='e' || c=='E';
+}
+
+/* eight ASCII digits at p? (little-endian load) */
+static int eight_digits(const char* p, uint64_t* v){
+  memcpy(v, p, 8);
+  return (((*v & 0xF0F0F0F0F0F0F0F0ull) |
+           (((*v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);
+}
+
+static uint32_t parse_eight(uint64_t v){
+  v -= 0x3030303030303030ull;
+  v = (v * 10) + (v >> 8);
+  v = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+       (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+  return (uint32_t)v;
+}
+
+static const double POW10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static int digits(const char** pp, const char* end, uint64_t* w, int* nd){
+  const char* p = *pp;
+  while(end - p >= 8 && *nd <= 11){
+    uint64_t v;
+    if(!eight_digits(p, &v)) break;
+    *w = *w * 100000000ull + parse_eight(v);
+    *nd += 8; p += 8;
+  }
+  const char* s = p;
+  for(; p<end && *p>='0' && *p<='9'; ++p){
+    if(*nd < 19) *w = *w * 10 + (uint64_t)(*p - '0');
+    ++*nd;
+  }
+  int any = p > s || p > *pp;
+  *pp = p;
+  return any;
+}
+
+/* Parses one number from [p, end). Returns the end of the number, or p if there is none. */
+static const char* parse_number(const char* p, const char* end, float* out){
+  const char* s = p;
+  int neg = 0;
+  if(p<end && (*p=='-' || *p=='+')){ neg = *p=='-'; ++p; }
+  uint64_t w = 0; int nd = 0, frac = 0;
+  int any = digits(&p, end, &w, &nd);
+  if(p<end && *p=='.'){
+    ++p;
+    int before = nd;
+    any |= digits(&p, end, &w, &nd);
+    frac = nd - before;
+  }
+  if(!any) return s;
+  int e10 = 0, eneg = 0;
+  if(p<end && (*p=='e' || *p=='E')){
+    const char* q = p + 1;
+    if(q<end && (*q=='-' || *q=='+')){ eneg = *q=='-'; ++q; }
+    if(q<end && *q>='0' && *q<='9'){
+      for(; q<end && *q>='0' && *q<='9'; ++q) if(e10 < 10000) e10 = e10*10 + (*q - '0');
+      p = q;
+    }
+  }
+  int e = (eneg ? -e10 : e10) - frac;
+  if(nd <= 19 && w < (1ull<<53) && e >= -22 && e <= 22){
+    double d = e < 0 ? (double)w / POW10[-e] : (double)w * POW10[e];
+    uint64_t bits; memcpy(&bits, &d, 8);
+    double a = fabs(d);
+    /* a double that sits on a float rounding midpoint could round the wrong way */
+    if(d==0.0 || (a >= 1.17549435e-38 && a <= 3.40282346e38 && (bits & 0x1FFFFFFFull) != 0x10000000ull)){
+      *out = (float)(neg ? -d : d);
+      return p;
+    }
+  }
+  char tmp[64];
+  size_t n = (size_t)(p - s) < sizeof(tmp)-1 ? (size_t)(p - s) : sizeof(tmp)-1;
+  memcpy(tmp, s, n); tmp[n] = 0;
+  *out = strtof(tmp, NULL);
+  return p;
+}
+
+void paragon_floats_begin(ParagonFloatReader* r, float* out, int cap){
+  memset(r, 0, sizeof(*r));
+  r->out = out; r->cap = out ? cap : 0;
+}
+
+static void emit(ParagonFloatReader* r, float v){
+  if(r->depth<1) return;   /* only values inside an array count */
+  if(r->n < r->cap) r->out[r->n++] = v;
+  ++r->total; ++r->row_vals;
+}
+
+static void finish_tok(ParagonFloatReader* r){
+  float v;
+  if(parse_number(r->tok, r->tok + r->ntok, &v) != r->tok) emit(r, v);
+  r->ntok = 0;
+}
+
+void paragon_floats_feed(ParagonFloatReader* r, const char* p, size_t len){
+  const char* end = p + len;
+  if(r->ntok){
+    /* finish the number the previous chunk ended in */
+    while(p<end && is_num_ch(*p)){
+      if(r->ntok < (int)sizeof(r->tok)-1) r->tok[r->ntok++] = *p;
+      else r->err = 1;
+      ++p;
+    }
+    if(p==end) return;
+    finish_tok(r);
+  }
+  while(p<end){
+    char c = *p;
+    if(r->in_str){
+      if(r->esc) r->esc = 0;
+      else if(c=='\\') r->esc = 1;
+      else if(c=='"') r->in_str = 0;
+      ++p; continue;
+    }
+    if(is_num_ch(c)){
+      const char* q = p + 1;
+      while(q<end && is_num_ch(*q)) ++q;
+      if(q==end){
+        /* may continue in the next chunk */
+        size_t n = (size_t)(end - p);
+        if(n > sizeof(r->tok)-1){ n = sizeof(r->tok)-1; r->err = 1; }
+        memcpy(r->tok, p, n); r->ntok = (int)n;
+        return;
+      }
+      float v;
+      if(parse_number(p, q, &v) != p) emit(r, v);   /* else a stray sign/dot/letter */
+      p = q; continue;
+    }
+    switch(c){
+      case '[': ++r->depth; r->row_vals = 0; break;
+      case ']':
+        if(r->depth<=0){ r->err = 1; break; }
+        if(r->row_vals){ if(!r->rows) r->cols = r->row_vals; ++r->rows; r->row_vals = 0; }
+        --r->depth;
+        break;
+      case '"': r->in_str = 1; break;
+      default: break;
+    }
+    ++p;
+  }
+}
+
+int paragon_floats_end(ParagonFloatReader* r){
+  if(r->ntok) finish_tok(r);
+  if(r->err || r->depth || r->in_str) return -1;
+  return r->n;
+}
+
+int paragon_parse_floats(const char* txt, float* out, int cap){
+  if(!txt || !out) return 0;
+  ParagonFloatReader r;
+  paragon_floats_begin(&r, out, cap);
+  paragon_floats_feed(&r, txt, strlen(txt));
+  int n = paragon_floats_end(&r);
+  return n<0 ? r.n : n;   /* tolerant: keep what decoded from a truncated reply */
+}
@@ -0,0 +1,286 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "paragon.h"
+
+/* Per-handle memory accounting and the process-wide budget. Charges live in the handle
+   table next to the other per-handle facts, so everything here runs under api->lock;
+   the library is only ever called (MemoryInfo, FreeNetwork, on_evict) with it released. */
+
+#define MB (1024.0*1024.0)
+
+long long paragon_rss_bytes(void){
+  FILE* f = fopen("/proc/self/statm", "r");
+  if(!f) return -1;
+  long long size = 0, resident = -1;
+  if(fscanf(f, "%lld %lld", &size, &resident)!=2) resident = -1;
+  fclose(f);
+  return resident<0 ? -1 : resident * (long long)sysconf(_SC_PAGESIZE);
+}
+
+/* float32 weights + biases, then either a gradient of each and one activation vector
+   per layer (training layout) or a ping-pong pair of the widest layer (inference, never
+   more than one per layer) */
+static void estimate(const char* layers_json, int inference, long long* host, long long* device){
+  long long prev = 0, params = 0, acts = 0, widest = 0;
+  for(const char* p = layers_json; p && (p = strstr(p, "\"Width\"")); ){
+    const char* w = strchr(p, ':');
+    if(!w) break;
+    long long width = atoll(w+1), height = 1;
+    const char* hh = strstr(p, "\"Height\"");
+    const char* close = strchr(p, '}');
+    if(hh && (!close || hh<close)){ const char* c = strchr(hh, ':'); if(c) height = atoll(c+1); }
+    long long d = width * (height>0 ? height : 1);
+    if(prev) params += prev*d + d;
+    acts += d;
+    if(d>widest) widest = d;
+    prev = d;
+    p = w;
+  }
+  long long pair = 2*widest<acts ? 2*widest : acts;
+  long long bytes = (inference ? params + pair : 2*params + acts) * (long long)sizeof(float);
+  if(host)   *host = bytes;
+  if(device) *device = bytes;
+}
+
+void paragon_mem_estimate(const char* layers_json, long long* host, long long* device){
+  estimate(layers_json, 0, host, device);
+}
+
+void paragon_mem_estimate_inference(const char* layers_json, long long* host, long long* device){
+  estimate(layers_json, 1, host, device);
+}
+
+static void charge_locked(ParagonAPI* api, ParagonHandleInfo* e, long long host, long long device){
+  api->mem.host_bytes   += host - e->host_bytes;
+  api->mem.device_bytes += device - e->device_bytes;
+  e->host_bytes = host; e->device_bytes = device;
+}
+
+static void release_locked(ParagonAPI* api, ParagonHandleInfo* e){
+  charge_locked(api, e, 0, 0);
+  e->flags |= PARAGON_HF_RELEASED;
+}
+
+int paragon_mem_admit(ParagonAPI* api, long long host, long long device, ParagonHandle keep){
+  if(!api) return 0;
+  for(;;){
+    pthread_mutex_lock(&api->lock);
+    ParagonMemBudget* b = &api->mem;
+    /* reservations count as used, so concurrent creators cannot all pass one check */
+    long long used_h = b->host_bytes + b->host_reserved, used_d = b->device_bytes + b->device_reserved;
+    int over_h = b->host_limit>0 && host>0 && used_h + host > b->host_limit;
+    int over_d = b->device_limit>0 && device>0 && used_d + device > b->device_limit;
+    if(!over_h && !over_d){
+      if(host>0)   b->host_reserved += host;
+      if(device>0) b->device_reserved += device;
+      pthread_mutex_unlock(&api->lock);
+      return 1;
+    }
+
+    /* handles that predate the budget are not ours to free; if evicting every later
+       one still leaves no room, refuse now rather than free them for nothing */
+    ParagonHandle victim = 0;
+    if(b->policy==PARAGON_BUDGET_EVICT && api->FreeNetwork){
+      unsigned long long oldest = ULLONG_MAX;
+      long long spare = 0;
+      for(int i=0; i<api->caphandles; ++i){
+        ParagonHandleInfo* e = &api->handles[i];
+        if(!e->h || e->h==keep || (e->flags & PARAGON_HF_RELEASED) || e->born<=b->epoch) continue;
+        if(e->inflight>0) continue;               /* another thread is inside the library with it */
+        long long bytes = over_h ? e->host_bytes : e->device_bytes;
+        if(bytes<=0) continue;
+        spare += bytes;
+        if(e->last_use<oldest){ oldest = e->last_use; victim = e->h; }
+      }
+      if(over_h ? used_h - spare + host > b->host_limit
+                : used_d - spare + device > b->device_limit) victim = 0;
+    }
+    if(!victim){
+      ++b->refused;
+      double used = (double)(over_h ? used_h : used_d) / MB;
+      double lim  = (double)(over_h ? b->host_limit : b->device_limit) / MB;
+      pthread_mutex_unlock(&api->lock);
+      fprintf(stderr, "paragon: %s budget exceeded (%.1f MB used + %.1f MB needed > %.1f MB)\n",
+        over_h ? "host" : "device", used, (double)(over_h ? host : device) / MB, lim);
+      return 0;
+    }
+    release_locked(api, paragon_handle_locked(api, victim, 0));
+    ++b->evicted;
+    void (*cb)(ParagonHandle, void*) = b->on_evict;
+    void* user = b->evict_user;
+    pthread_mutex_unlock(&api->lock);
+    api->FreeNetwork(victim);
+    if(cb) cb(victim, user);
+  }
+}
+
+static void unreserve_locked(ParagonMemBudget* b, long long host, long long device){
+  if(host>0)   b->host_reserved   = b->host_reserved>host ? b->host_reserved - host : 0;
+  if(device>0) b->device_reserved = b->device_reserved>device ? b->device_reserved - device : 0;
+}
+
+void paragon_mem_unreserve(ParagonAPI* api, long long host, long long device){
+  if(!api) return;
+  pthread_mutex_lock(&api->lock);
+  unreserve_locked(&api->mem, host, device);
+  pthread_mutex_unlock(&api->lock);
+}
+
+static int query_lib(ParagonAPI* api, ParagonHandle h, long long* host, long long* device){
+  *host = *device = -1;
+  return api->MemoryInfo && api->MemoryInfo(h, host, device)==0;
+}
+
+static long long growth(long long rss0){
+  long long rss1 = rss0>=0 ? paragon_rss_bytes() : -1;
+  return rss1>rss0 ? rss1 - rss0 : 0;
+}
+
+void paragon_mem_created(ParagonAPI* api, ParagonHandle h, const char* layers_json, long long rss0,
+                         long long reserved_host){
+  if(!api) return;
+  if(h<=0){ paragon_mem_unreserve(api, reserved_host, 0); return; }
+  long long grew = growth(rss0), est_host, est_device, lh, ld;
+  int lib = query_lib(api, h, &lh, &ld);
+  pthread_mutex_lock(&api->lock);
+  unreserve_locked(&api->mem, reserved_host, 0);      /* the real charge replaces it below */
+  ParagonHandleInfo* e = paragon_handle_locked(api, h, 1);
+  if(e){
+    estimate(layers_json, (e->flags & PARAGON_HF_INFERENCE)!=0, &est_host, &est_device);
+    e->est_host = est_host; e->est_device = est_device;
+    e->rss_bytes = grew;
+    if(lib) e->flags |= PARAGON_HF_MEM_LIB;
+    charge_locked(api, e, lib ? lh : (grew>est_host ? grew : est_host), lib && ld>0 ? ld : 0);
+    e->last_use = e->born = ++api->mem.clock;
+  }
+  pthread_mutex_unlock(&api->lock);
+}
+
+void paragon_mem_gpu_ready(ParagonAPI* api, ParagonHandle h, long long rss0, long long reserved_device){
+  if(!api) return;
+  if(h<=0){ paragon_mem_unreserve(api, 0, reserved_device); return; }
+  long long grew = growth(rss0), lh, ld;
+  int lib = query_lib(api, h, &lh, &ld);
+  pthread_mutex_lock(&api->lock);
+  unreserve_locked(&api->mem, 0, reserved_device);
+  ParagonHandleInfo* e = paragon_handle_locked(api, h, 0);
+  if(e && !(e->flags & PARAGON_HF_RELEASED)){
+    e->rss_bytes += grew;
+    if(lib) charge_locked(api, e, lh, ld);
+    else    charge_locked(api, e, e->host_bytes + grew, e->est_device);
+    e->last_use = ++api->mem.clock;
+  }
+  pthread_mutex_unlock(&api->lock);
+}
+
+void paragon_mem_add_host(ParagonAPI* api, ParagonHandle h, long long bytes){
+  if(!api || h<=0) return;
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = paragon_handle_locked(api, h, 0);
+  if(e && !(e->flags & PARAGON_HF_RELEASED)){
+    long long v = e->host_bytes + bytes;
+    charge_locked(api, e, v>0 ? v : 0, e->device_bytes);
+  }
+  pthread_mutex_unlock(&api->lock);
+}
+
+int paragon_mem_touch(ParagonAPI* api, ParagonHandle h){
+  if(!api || h<=0 || !__atomic_load_n(&api->mem.touch, __ATOMIC_RELAXED)) return 0;
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = paragon_handle_locked(api, h, 0);
+  int live = !e || !(e->flags & PARAGON_HF_RELEASED);
+  if(e && live){ e->last_use = ++api->mem.clock; ++e->inflight; }
+  pthread_mutex_unlock(&api->lock);
+  if(!live){ fprintf(stderr, "paragon: handle %lld was released by the memory budget\n", (long long)h); return -1; }
+  return e!=NULL;
+}
+
+void paragon_mem_untouch(ParagonAPI* api, ParagonHandle h, int touched){
+  if(touched<=0) return;
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = paragon_handle_locked(api, h, 0);
+  if(e && e->inflight>0) --e->inflight;
+  pthread_mutex_unlock(&api->lock);
+}
+
+int paragon_mem_budget(ParagonAPI* api, long long host_limit, long long device_limit, int policy){
+  if(!api || host_limit<0 || device_limit<0) return 0;
+  if(policy==PARAGON_BUDGET_EVICT && !api->FreeNetwork)
+    fprintf(stderr, "paragon_mem_budget: library cannot free networks, over-budget handles are refused\n");
+  pthread_mutex_lock(&api->lock);
+  api->mem.host_limit = host_limit;
+  api->mem.device_limit = device_limit;
+  api->mem.policy = policy;
+  api->mem.epoch = api->mem.clock;
+  __atomic_store_n(&api->mem.touch, policy==PARAGON_BUDGET_EVICT && api->FreeNetwork &&
+                   (host_limit>0 || device_limit>0), __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&api->lock);
+  return 1;
+}
+
+void paragon_mem_on_evict(ParagonAPI* api, void (*fn)(ParagonHandle h, void* user), void* user){
+  if(!api) return;
+  pthread_mutex_lock(&api->lock);
+  api->mem.on_evict = fn; api->mem.evict_user = user;
+  pthread_mutex_unlock(&api->lock);
+}
+
+int paragon_handle_memory(ParagonAPI* api, ParagonHandle h, ParagonMemInfo* out){
+  if(!api || h<=0) return 0;
+  long long lh, ld;
+  int lib = query_lib(api, h, &lh, &ld);     /* refresh: activations and state grow with use */
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = paragon_handle_locked(api, h, 0);
+  if(e){
+    int released = (e->flags & PARAGON_HF_RELEASED)!=0;
+    if(lib && !released) charge_locked(api, e, lh, ld>=0 ? ld : e->device_bytes);
+    if(out){
+      out->from_library = lib;
+      out->host_bytes = lib ? lh : e->rss_bytes;
+      out->device_bytes = lib ? ld : -1;
+      out->est_host = e->est_host;
+      out->est_device = (e->flags & PARAGON_HF_GPU_INIT) ? e->est_device : 0;
+      out->charged_host = e->host_bytes; out->charged_device = e->device_bytes;
+      out->released = released;
+    }
+  }
+  pthread_mutex_unlock(&api->lock);
+  return e!=NULL;
+}
+
+void paragon_mem_usage(ParagonAPI* api, ParagonMemUsage* out){
+  if(!out) return;
+  memset(out, 0, sizeof(*out));
+  if(!api) return;
+  pthread_mutex_lock(&api->lock);
+  out->host_bytes = api->mem.host_bytes; out->device_bytes = api->mem.device_bytes;
+  out->host_limit = api->mem.host_limit; out->device_limit = api->mem.device_limit;
+  out->refused = api->mem.refused; out->evicted = api->mem.evicted;
+  for(int i=0; i<api->caphandles; ++i){
+    const ParagonHandleInfo* e = &api->handles[i];
+    if(e->h && !(e->flags & PARAGON_HF_RELEASED) && (e->host_bytes>0 || e->device_bytes>0)) ++out->handles;
+  }
+  pthread_mutex_unlock(&api->lock);
+}
+
+int paragon_free_handle(ParagonAPI* api, ParagonHandle h){
+  if(!api || h<=0 || !api->FreeNetwork) return 0;
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = paragon_handle_locked(api, h, 0);
+  int was = e && (e->flags & PARAGON_HF_RELEASED);
+  int busy = e && !was && e->inflight>0;     /* same rule as eviction: never under a caller */
+  if(e && !was && !busy) release_locked(api, e);
+  pthread_mutex_unlock(&api->lock);
+  if(was || busy){
+    if(busy) fprintf(stderr, "paragon_free_handle: handle %lld is in use on another thread\n", (long long)h);
+    return 0;
+  }
+  api->FreeNetwork(h);
+  return 1;
+}
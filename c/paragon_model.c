@@ -0,0 +1,231 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "paragon.h"
+
+/* Binary model file, little-endian:
+
+     0     header (PmdlHeader), zero-padded to PMDL_DATA_ALIGN
+     data  for each layer l in 0..nlayers-2:
+             W[l]  dims[l+1]×dims[l] float32, row-major (one row per output neuron)
+             B[l]  dims[l+1] float32
+           every block starts on a 64-byte boundary, offsets are from the file start
+
+   The data section is page aligned so a mapping can be handed straight to a library
+   (or a GPU upload) without copying or realigning. */
+
+#define PMDL_MAGIC       0x4C444D50u   /* "PMDL" */
+#define PMDL_VERSION     1u
+#define PMDL_DATA_ALIGN  4096u
+#define PMDL_BLOCK_ALIGN 64u
+
+typedef struct {
+  uint32_t magic, version;
+  uint32_t nlayers, reserved;
+  uint64_t file_bytes;
+  int32_t  width[PARAGON_MODEL_MAX_LAYERS], height[PARAGON_MODEL_MAX_LAYERS];
+  int32_t  act[PARAGON_MODEL_MAX_LAYERS];
+  uint64_t w_off[PARAGON_MODEL_MAX_LAYERS-1], b_off[PARAGON_MODEL_MAX_LAYERS-1];
+} PmdlHeader;
+
+static const char* const ACT_NAMES[PARAGON_ACT_COUNT] = {
+  [PARAGON_ACT_LINEAR]  = "linear",
+  [PARAGON_ACT_RELU]    = "relu",
+  [PARAGON_ACT_SOFTMAX] = "softmax",
+  [PARAGON_ACT_SIGMOID] = "sigmoid",
+  [PARAGON_ACT_TANH]    = "tanh",
+};
+
+const char* paragon_act_name(int act){
+  return act>=0 && act<PARAGON_ACT_COUNT ? ACT_NAMES[act] : "linear";
+}
+
+int paragon_act_code(const char* name){
+  for(int i=0; name && i<PARAGON_ACT_COUNT; ++i) if(!strcmp(name, ACT_NAMES[i])) return i;
+  return -1;
+}
+
+static uint64_t align_up(uint64_t x, uint64_t a){ return (x + a - 1) & ~(a - 1); }
+
+/* fills offsets and total size; 0 if the shape is unusable */
+static int layout(PmdlHeader* hd){
+  for(uint32_t l=0; l<hd->nlayers; ++l)   /* negative sizes would wrap the products below */
+    if(hd->width[l]<=0 || hd->height[l]<=0 || (int64_t)hd->width[l]*hd->height[l] > INT32_MAX) return 0;
+  uint64_t off = align_up(sizeof(*hd), PMDL_DATA_ALIGN);
+  for(uint32_t l=0; l+1<hd->nlayers; ++l){
+    uint64_t in  = (uint64_t)hd->width[l]*(uint64_t)hd->height[l];
+    uint64_t out = (uint64_t)hd->width[l+1]*(uint64_t)hd->height[l+1];
+    if(!in || !out) return 0;
+    hd->w_off[l] = off; off = align_up(off + in*out*sizeof(float), PMDL_BLOCK_ALIGN);
+    hd->b_off[l] = off; off = align_up(off + out*sizeof(float), PMDL_BLOCK_ALIGN);
+  }
+  hd->file_bytes = off;
+  return 1;
+}
+
+int paragon_model_write(const char* path, int nlayers, const int* width, const int* height,
+                        const int* act, const float* const* W, const float* const* B){
+  if(!path || nlayers<2 || nlayers>PARAGON_MODEL_MAX_LAYERS || !width) return 0;
+  PmdlHeader hd; memset(&hd, 0, sizeof(hd));
+  hd.magic = PMDL_MAGIC; hd.version = PMDL_VERSION; hd.nlayers = (uint32_t)nlayers;
+  for(int l=0; l<nlayers; ++l){
+    hd.width[l]  = width[l];
+    hd.height[l] = height && height[l]>0 ? height[l] : 1;
+    hd.act[l]    = act ? act[l] : (l==0 ? PARAGON_ACT_LINEAR :
+                                   l==nlayers-1 ? PARAGON_ACT_SOFTMAX : PARAGON_ACT_RELU);
+    if(width[l]<=0 || hd.act[l]<0 || hd.act[l]>=PARAGON_ACT_COUNT) return 0;
+  }
+  if(!layout(&hd)) return 0;
+
+  char tmp[1024];
+  snprintf(tmp, sizeof(tmp), "%s.tmp.%ld", path, (long)getpid());
+  FILE* f = fopen(tmp, "wb");
+  if(!f){ fprintf(stderr, "model: cannot write %s\n", tmp); return 0; }
+  static const char zeros[PMDL_DATA_ALIGN];
+  uint64_t pos = 0;
+  int ok = fwrite(&hd, sizeof(hd), 1, f)==1;
+  pos = sizeof(hd);
+  for(int l=0; ok && l+1<nlayers; ++l){
+    size_t in  = (size_t)hd.width[l]*hd.height[l];
+    size_t out = (size_t)hd.width[l+1]*hd.height[l+1];
+    for(int k=0; ok && k<2; ++k){
+      uint64_t off = k ? hd.b_off[l] : hd.w_off[l];
+      size_t   n   = k ? out : in*out;
+      const float* src = k ? (B ? B[l] : NULL) : (W ? W[l] : NULL);
+      ok = fwrite(zeros, 1, (size_t)(off-pos), f)==(size_t)(off-pos);
+      pos = off;
+      /* missing blocks are written as zeros, a chunk at a time */
+      for(size_t i=0; ok && i<n; ){
+        size_t c = n-i < PMDL_DATA_ALIGN/sizeof(float) ? n-i : PMDL_DATA_ALIGN/sizeof(float);
+        ok = fwrite(src ? (const void*)(src+i) : (const void*)zeros, sizeof(float), c, f)==c;
+        i += c;
+      }
+      pos += n*sizeof(float);
+    }
+  }
+  if(ok) ok = fwrite(zeros, 1, (size_t)(hd.file_bytes-pos), f)==(size_t)(hd.file_bytes-pos);
+  ok = fclose(f)==0 && ok;
+  if(ok) ok = rename(tmp, path)==0;
+  if(!ok){ (void)unlink(tmp); fprintf(stderr, "model: write failed for %s\n", path); }
+  return ok;
+}
+
+int paragon_model_open(ParagonModel* m, const char* path){
+  memset(m, 0, sizeof(*m));
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if(fd<0){ fprintf(stderr, "model: cannot open %s\n", path); return 0; }
+  struct stat sb;
+  if(fstat(fd, &sb) || (size_t)sb.st_size < sizeof(PmdlHeader)){
+    fprintf(stderr, "model: %s is too small\n", path); close(fd); return 0;
+  }
+  void* base = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);   /* the mapping keeps the file alive */
+  if(base==MAP_FAILED){ fprintf(stderr, "model: mmap failed for %s\n", path); return 0; }
+
+  const PmdlHeader* hd = (const PmdlHeader*)base;
+  PmdlHeader chk = *hd;
+  if(hd->magic!=PMDL_MAGIC || hd->version!=PMDL_VERSION ||
+     hd->nlayers<2 || hd->nlayers>PARAGON_MODEL_MAX_LAYERS ||
+     !layout(&chk) || chk.file_bytes!=hd->file_bytes || hd->file_bytes>(uint64_t)sb.st_size ||
+     memcmp(chk.w_off, hd->w_off, sizeof(chk.w_off)) || memcmp(chk.b_off, hd->b_off, sizeof(chk.b_off))){
+    fprintf(stderr, "model: %s is not a v%u paragon model\n", path, PMDL_VERSION);
+    munmap(base, (size_t)sb.st_size);
+    return 0;
+  }
+  for(uint32_t l=0; l<hd->nlayers; ++l){
+    if(hd->act[l]<0 || hd->act[l]>=PARAGON_ACT_COUNT){
+      fprintf(stderr, "model: %s has unknown activation code %d at layer %u\n", path, (int)hd->act[l], l);
+      munmap(base, (size_t)sb.st_size);
+      return 0;
+    }
+  }
+  m->base = base; m->len = (size_t)sb.st_size;
+  m->nlayers = (int)hd->nlayers;
+  for(int l=0; l<m->nlayers; ++l){
+    m->width[l] = hd->width[l]; m->height[l] = hd->height[l];
+    m->dims[l]  = hd->width[l]*hd->height[l];
+    m->act[l]   = hd->act[l];
+  }
+  for(int l=0; l+1<m->nlayers; ++l){
+    m->W[l] = (const float*)((const char*)base + hd->w_off[l]);
+    m->B[l] = (const float*)((const char*)base + hd->b_off[l]);
+  }
+  /* weights are read front to back once by a loader, then randomly by kernels */
+  (void)madvise(base, m->len, MADV_WILLNEED);
+  return 1;
+}
+
+void paragon_model_close(ParagonModel* m){
+  if(m && m->base) munmap((void*)m->base, m->len);
+  if(m) memset(m, 0, sizeof(*m));
+}
+
+/* The JSON spec of the model, for the copy route and for handle-table keys */
+void paragon_model_json(ParagonArena* a, const ParagonModel* m,
+                        char** layers, char** activs, char** trainable){
+  size_t n = (size_t)m->nlayers;
+  *layers = paragon_arena_alloc(a, n*40 + 4);
+  *activs = paragon_arena_alloc(a, n*12 + 4);
+  *trainable = paragon_arena_alloc(a, n*5 + 4);
+  if(!*layers || !*activs || !*trainable){ *layers = NULL; return; }
+  size_t p = 0, q = 0, t = 0;
+  (*layers)[p++] = '['; (*activs)[q++] = '['; (*trainable)[t++] = '[';
+  for(int l=0; l<m->nlayers; ++l){
+    p += (size_t)sprintf(*layers+p, "%s{\"Width\":%d,\"Height\":%d}", l?",":"", m->width[l], m->height[l]);
+    q += (size_t)sprintf(*activs+q, "%s\"%s\"", l?",":"", paragon_act_name(m->act[l]));
+    t += (size_t)sprintf(*trainable+t, l?",true":"true");
+  }
+  strcpy(*layers+p, "]"); strcpy(*activs+q, "]"); strcpy(*trainable+t, "]");
+}
+
+ParagonHandle paragon_new_from_model(ParagonAPI* api, const ParagonModel* m,
+                                     bool prefer_gpu, int* how){
+  if(how) *how = PARAGON_MODEL_SHAPE_ONLY;
+  if(!api || !m || !m->base) return -1;
+  ParagonArena ar; paragon_arena_init(&ar, 1024);
+  char *layers, *activs, *trainable;
+  paragon_model_json(&ar, m, &layers, &activs, &trainable);
+  ParagonHandle h = -1;
+  if(!layers) goto out;
+
+  if(api->NewFromModel){
+    char* r = api->NewFromModel(m->base, (long long)m->len, prefer_gpu);
+    h = paragon_parse_handle(r);
+    if(h>0){
+      (void)paragon_register_handle(api, h, layers, NULL);
+      if(how) *how = PARAGON_MODEL_ZERO_COPY;
+    } else {
+      fprintf(stderr, "NewNetworkFromModel failed. r=%s\n", r?r:"<null>");
+    }
+    paragon_free_result(api, r);
+    goto out;
+  }
+
+  h = paragon_new_handle(api, layers, activs, trainable, prefer_gpu, false);
+  if(h<=0) goto out;
+  if(!api->SetLayerWeights){
+    static int warned;
+    if(!warned++) fprintf(stderr, "model: library exports no SetLayerWeights_F32; shape only\n");
+    goto out;
+  }
+  for(int l=0; l+1<m->nlayers; ++l){
+    long long nw = (long long)m->dims[l]*m->dims[l+1], nb = m->dims[l+1];
+    if(api->SetLayerWeights(h, l, m->W[l], nw, m->B[l], nb)){
+      fprintf(stderr, "model: SetLayerWeights_F32 failed at layer %d\n", l);
+      goto out;
+    }
+  }
+  paragon_weights_changed(api, h);
+  if(how) *how = PARAGON_MODEL_COPIED;
+out:
+  paragon_arena_free(&ar);
+  return h;
+}
@@ -0,0 +1,190 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "paragon.h"
+
+/* NUMA placement without libnuma: topology from /sys/devices/system/node, affinity with
+   sched_setaffinity, memory policy with the raw set_mempolicy syscall. The library
+   allocates a network's weights while it is being created and warmed, so a policy set
+   on the creating thread decides where they land (as far as the library's allocator
+   hands out fresh pages):
+   first-touch  handles built on the caller, pages wherever it runs
+   interleave   built under MPOL_INTERLEAVE, pages spread round-robin over all nodes
+   replicate    per_node handles per node, each built by a thread pinned to that node
+                under MPOL_PREFERRED, so a worker there only reads local memory
+   On a single-node machine (or without the syscall) all three amount to first touch. */
+
+#define MPOL_DEFAULT_    0
+#define MPOL_PREFERRED_  1
+#define MPOL_INTERLEAVE_ 3
+#define MAX_NODES        64
+
+struct ParagonReplicas {
+  ParagonAPI*  api;
+  int          placement, nodes, per_node, npools;
+  ParagonPool* pool[MAX_NODES];           /* by node; shared placements use pool[0] */
+};
+
+int paragon_numa_nodes(void){
+  static int n;
+  int v = __atomic_load_n(&n, __ATOMIC_RELAXED);
+  if(v) return v;
+  v = 1;
+  FILE* f = fopen("/sys/devices/system/node/online", "r");
+  if(f){
+    char buf[256];
+    if(fgets(buf, sizeof(buf), f)){
+      /* "0", "0-1", "0-3,5": highest id + 1 */
+      for(char* p = buf; *p; ){
+        char* e; long k = strtol(p, &e, 10);
+        if(e==p){ ++p; continue; }
+        if(k+1 > v) v = (int)(k+1);
+        p = e;
+      }
+    }
+    fclose(f);
+  }
+  if(v>MAX_NODES) v = MAX_NODES;
+  __atomic_store_n(&n, v, __ATOMIC_RELAXED);
+  return v;
+}
+
+/* node's cpulist ("0-7,16-23") into set; 0 when unknown */
+static int node_cpus(int node, cpu_set_t* set){
+  char path[96], buf[1024];
+  CPU_ZERO(set);
+  snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+  FILE* f = fopen(path, "r");
+  if(!f) return 0;
+  int n = 0;
+  if(fgets(buf, sizeof(buf), f)){
+    for(char* p = buf; *p; ){
+      char* e; long lo = strtol(p, &e, 10);
+      if(e==p){ ++p; continue; }
+      long hi = lo;
+      if(*e=='-') hi = strtol(e+1, &e, 10);
+      for(long c=lo; c<=hi && c<CPU_SETSIZE; c++){ CPU_SET((int)c, set); ++n; }
+      p = e;
+    }
+  }
+  fclose(f);
+  return n;
+}
+
+int paragon_numa_pin(int node){
+  cpu_set_t set;
+  if(node<0 || node>=paragon_numa_nodes() || !node_cpus(node, &set)) return 0;
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set)==0;
+}
+
+int paragon_numa_current_node(void){
+  unsigned cpu = 0, node = 0;
+  if(syscall(SYS_getcpu, &cpu, &node, NULL)!=0) return 0;
+  return (int)node < paragon_numa_nodes() ? (int)node : 0;
+}
+
+static int set_policy(int mode, const unsigned long* mask, unsigned long maxnode){
+#ifdef SYS_set_mempolicy
+  return syscall(SYS_set_mempolicy, mode, mask, maxnode)==0;
+#else
+  (void)mode; (void)mask; (void)maxnode;
+  return 0;
+#endif
+}
+
+const char* paragon_place_name(int placement){
+  switch(placement){
+    case PARAGON_PLACE_INTERLEAVE: return "interleave";
+    case PARAGON_PLACE_REPLICATE:  return "replicated";
+    default:                       return "first-touch";
+  }
+}
+
+typedef struct {
+  ParagonReplicas* r;
+  int              node;
+  const char      *layers, *activs, *trainable;
+  ParagonPool*     pool;
+} Build;
+
+static void* build_main(void* arg){
+  Build* b = (Build*)arg;
+  ParagonReplicas* r = b->r;
+  int policy = 0;
+  if(r->placement==PARAGON_PLACE_REPLICATE){
+    (void)paragon_numa_pin(b->node);
+    unsigned long mask = 1ul << b->node;
+    policy = r->nodes>1 && set_policy(MPOL_PREFERRED_, &mask, sizeof(mask)*8);
+  } else if(r->placement==PARAGON_PLACE_INTERLEAVE && r->nodes>1){
+    unsigned long mask = r->nodes>=64 ? ~0ul : (1ul << r->nodes) - 1;
+    policy = set_policy(MPOL_INTERLEAVE_, &mask, sizeof(mask)*8);
+  }
+  int n = r->placement==PARAGON_PLACE_REPLICATE ? r->per_node : r->per_node*r->nodes;
+  b->pool = paragon_pool_new(r->api, b->layers, b->activs, b->trainable, n, 0);   /* warms too */
+  if(policy) (void)set_policy(MPOL_DEFAULT_, NULL, 0);
+  return NULL;
+}
+
+ParagonReplicas* paragon_replicas_new(ParagonAPI* api, const char* layers_json,
+                                      const char* activs_json, const char* trainable_json,
+                                      int per_node, int placement){
+  if(!api || per_node<=0) return NULL;
+  ParagonReplicas* r = (ParagonReplicas*)calloc(1, sizeof(*r));
+  if(!r) return NULL;
+  r->api = api; r->placement = placement; r->per_node = per_node;
+  r->nodes = paragon_numa_nodes();
+  r->npools = placement==PARAGON_PLACE_REPLICATE ? r->nodes : 1;
+
+  Build b[MAX_NODES];
+  pthread_t th[MAX_NODES];
+  int ok = 1;
+  for(int k=0;k<r->npools;k++){
+    b[k].r = r; b[k].node = k; b[k].pool = NULL;
+    b[k].layers = layers_json; b[k].activs = activs_json; b[k].trainable = trainable_json;
+  }
+  if(placement==PARAGON_PLACE_FIRST_TOUCH) build_main(&b[0]);
+  else {
+    /* a thread per build so affinity and policy never leak into the caller */
+    int started = 0;
+    for(int k=0;k<r->npools;k++, started++)
+      if(pthread_create(&th[k], NULL, build_main, &b[k])) break;
+    for(int k=0;k<started;k++) pthread_join(th[k], NULL);
+    if(started<r->npools){ fprintf(stderr, "paragon_replicas_new: pthread_create failed\n"); ok = 0; }
+  }
+  for(int k=0;k<r->npools;k++){
+    r->pool[k] = b[k].pool;
+    if(!b[k].pool) ok = 0;
+  }
+  if(!ok){ paragon_replicas_free(r); return NULL; }
+  return r;
+}
+
+ParagonPool* paragon_replicas_pool(ParagonReplicas* r, int node){
+  if(!r) return NULL;
+  return r->npools>1 && node>=0 && node<r->npools ? r->pool[node] : r->pool[0];
+}
+
+int paragon_replicas_nodes(const ParagonReplicas* r){ return r ? r->nodes : 0; }
+
+int paragon_replicas_forward(ParagonReplicas* r, const float* x, int dim, float* y, int out_cap){
+  if(!r || !x || !y) return -1;
+  ParagonPool* p = paragon_replicas_pool(r, r->npools>1 ? paragon_numa_current_node() : 0);
+  ParagonHandle h = paragon_pool_acquire(p);
+  if(h<=0) return -1;
+  int n = paragon_forward_f32(r->api, h, x, 1, dim) ? paragon_extract_f32(r->api, h, y, out_cap) : -1;
+  paragon_pool_release(p, h);
+  return n;
+}
+
+void paragon_replicas_free(ParagonReplicas* r){
+  if(!r) return;
+  for(int k=0;k<r->npools;k++) paragon_pool_free(r->pool[k]);
+  free(r);
+}
@@ -0,0 +1,64 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "paragon.h"
+
+/* Element-wise parity in ULPs and the library's determinism knob. A float's bits, read
+   as sign-magnitude, map onto a line of integers where neighbouring floats are one
+   apart; the distance between two mapped values is the ULP count. */
+
+static long long ordered(float f){
+  int i; memcpy(&i, &f, sizeof(i));
+  return i<0 ? (long long)INT_MIN - i : (long long)i;
+}
+
+unsigned paragon_ulp(float a, float b){
+  if(isnan(a) || isnan(b)) return memcmp(&a, &b, sizeof(a)) ? UINT_MAX : 0u;
+  long long d = ordered(a) - ordered(b);
+  if(d<0) d = -d;
+  return d>(long long)UINT_MAX ? UINT_MAX : (unsigned)d;
+}
+
+void paragon_parity_reset(ParagonParity* p){ memset(p, 0, sizeof(*p)); }
+
+static int bucket(unsigned u){
+  return u==0 ? 0 : u==1 ? 1 : u<4 ? 2 : u<16 ? 3 : u<256 ? 4 : 5;
+}
+
+void paragon_parity_add(ParagonParity* p, const float* a, const float* b, long long n, unsigned tol){
+  if(!p || !a || !b || n<=0) return;
+  double sum = p->mae * (double)p->n;
+  for(long long i=0;i<n;i++){
+    unsigned u = paragon_ulp(a[i], b[i]);
+    double d = fabs((double)a[i] - (double)b[i]);
+    if(isnan(d)) d = u ? INFINITY : 0.0;
+    if(!memcmp(&a[i], &b[i], sizeof(float))) ++p->exact;
+    if(u<=tol) ++p->within;
+    if(u>p->max_ulp) p->max_ulp = u;
+    if(d>p->max_abs) p->max_abs = d;
+    sum += d;
+    ++p->hist[bucket(u)];
+  }
+  p->n += n;
+  p->mae = sum / (double)p->n;
+}
+
+int paragon_set_deterministic(ParagonAPI* api, ParagonHandle h, int on){
+  if(!api || h<=0) return -1;
+  if(api->SetDeterministic){
+    int rc = api->SetDeterministic(h, on ? 1 : 0);
+    paragon_weights_changed(api, h);
+    return rc==0 ? 1 : -1;
+  }
+  if(!(api->caps & PARAGON_CAP_DETERMINISM)) return 0;
+  ParagonMethod m = paragon_method_id(api, h, "SetDeterministic");
+  if(m<0) return 0;
+  char* r = paragon_call_id(api, h, m, on ? "[true]" : "[false]");   /* bumps the version */
+  int ok = r && !strstr(r, "\"error\"");
+  paragon_free_result(api, r);
+  return ok ? 1 : -1;
+}
@@ -0,0 +1,336 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <limits.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "paragon.h"
+
+/* Concurrency without a lock on the request path.
+   - ParagonMPMC is a bounded multi-producer/multi-consumer ring (Vyukov): each cell
+     carries a sequence number, so producers and consumers claim cells with one CAS on
+     head/tail and never wait on each other unless the ring is full/empty.
+   - ParagonPool keeps N warmed handles in an MPMC; acquire pops one, release pushes it.
+   - ParagonDispatch runs W workers, each owning an MPMC of jobs. Submit spreads jobs
+     round-robin; a worker drains its own queue first, then steals from the others.
+     Idle workers and waiting callers sleep on futexes, so the kernel is only entered
+     when someone actually has to block. */
+
+#define SPINS 256
+
+struct ParagonMPMCCell {
+  size_t    seq;
+  long long v;
+};
+
+static long futex(int* addr, int op, int val){
+  return syscall(SYS_futex, addr, op, val, NULL, NULL, 0);
+}
+
+int paragon_mpmc_init(ParagonMPMC* q, size_t cap){
+  size_t n = 2;
+  while(n<cap) n <<= 1;
+  memset(q, 0, sizeof(*q));
+  q->cells = (struct ParagonMPMCCell*)aligned_alloc(64, ((n*sizeof(struct ParagonMPMCCell)) + 63) & ~(size_t)63);
+  if(!q->cells) return 0;
+  for(size_t i=0;i<n;i++) q->cells[i].seq = i;
+  q->mask = n-1;
+  return 1;
+}
+
+void paragon_mpmc_free(ParagonMPMC* q){
+  if(!q) return;
+  free(q->cells);
+  q->cells = NULL;
+}
+
+int paragon_mpmc_push(ParagonMPMC* q, long long v){
+  size_t pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+  for(;;){
+    struct ParagonMPMCCell* c = &q->cells[pos & q->mask];
+    size_t seq = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+    intptr_t d = (intptr_t)seq - (intptr_t)pos;
+    if(d==0){
+      if(__atomic_compare_exchange_n(&q->tail, &pos, pos+1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+        c->v = v;
+        __atomic_store_n(&c->seq, pos+1, __ATOMIC_RELEASE);
+        return 1;
+      }
+    } else if(d<0) return 0;                    /* full */
+    else pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+  }
+}
+
+int paragon_mpmc_pop(ParagonMPMC* q, long long* v){
+  size_t pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+  for(;;){
+    struct ParagonMPMCCell* c = &q->cells[pos & q->mask];
+    size_t seq = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+    intptr_t d = (intptr_t)seq - (intptr_t)(pos+1);
+    if(d==0){
+      if(__atomic_compare_exchange_n(&q->head, &pos, pos+1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+        *v = c->v;
+        __atomic_store_n(&c->seq, pos + q->mask + 1, __ATOMIC_RELEASE);
+        return 1;
+      }
+    } else if(d<0) return 0;                    /* empty */
+    else pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+  }
+}
+
+/* ---- handle pool ---- */
+
+struct ParagonPool {
+  ParagonAPI*    api;
+  ParagonMPMC    free_q;
+  ParagonHandle* hs;
+  int            n, in_dim, out_dim;
+  _Alignas(64) int avail;       /* futex word: handles in free_q, approximately */
+  int            sleepers;
+};
+
+static void warm(ParagonAPI* api, ParagonHandle h, int in_dim, int out_dim, int flags){
+  if(flags & PARAGON_POOL_GPU){
+    paragon_free_result(api, paragon_init_gpu(api, h));
+    (void)paragon_enable_gpu(api, h);
+    paragon_free_result(api, paragon_call_id(api, h, PARAGON_M_TOGGLE_GPU, "[]"));
+  }
+  if(in_dim<=0 || out_dim<=0) return;
+  float* x = calloc((size_t)in_dim, sizeof(float));
+  float* y = malloc(sizeof(float)*(size_t)out_dim);
+  int t = paragon_mem_touch(api, h);      /* one flight over forward + extract */
+  if(t>=0 && x && y && paragon_forward_f32(api, h, x, 1, in_dim)) (void)paragon_extract_f32(api, h, y, out_dim);
+  paragon_mem_untouch(api, h, t);
+  free(x); free(y);
+}
+
+ParagonPool* paragon_pool_adopt(ParagonAPI* api, const ParagonHandle* hs, int n, int flags){
+  if(!api || !hs || n<=0) return NULL;
+  ParagonPool* p = (ParagonPool*)aligned_alloc(64, (sizeof(*p) + 63) & ~(size_t)63);
+  if(!p) return NULL;
+  memset(p, 0, sizeof(*p));
+  p->api = api; p->n = n;
+  p->hs = (ParagonHandle*)malloc(sizeof(ParagonHandle)*(size_t)n);
+  if(!p->hs || !paragon_mpmc_init(&p->free_q, (size_t)n)){ free(p->hs); free(p); return NULL; }
+  ParagonHandleInfo hi;
+  if(paragon_handle_info(api, hs[0], &hi)){ p->in_dim = hi.in_dim; p->out_dim = hi.out_dim; }
+  for(int i=0;i<n;i++){
+    p->hs[i] = hs[i];
+    warm(api, hs[i], p->in_dim, p->out_dim, flags);
+    (void)paragon_mpmc_push(&p->free_q, hs[i]);
+  }
+  p->avail = n;
+  return p;
+}
+
+ParagonPool* paragon_pool_new(ParagonAPI* api, const char* layers_json, const char* activs_json,
+                              const char* trainable_json, int n, int flags){
+  if(!api || n<=0) return NULL;
+  ParagonHandle* hs = (ParagonHandle*)malloc(sizeof(ParagonHandle)*(size_t)n);
+  if(!hs) return NULL;
+  for(int i=0;i<n;i++){
+    hs[i] = paragon_new_handle_ex(api, layers_json, activs_json, trainable_json,
+                                  (flags & PARAGON_POOL_GPU)!=0, false,
+                                  (flags & PARAGON_POOL_INFERENCE) ? PARAGON_NEW_INFERENCE : 0u);
+    if(hs[i]<=0){ fprintf(stderr, "pool: NewNetwork failed for handle %d\n", i); free(hs); return NULL; }
+  }
+  ParagonPool* p = paragon_pool_adopt(api, hs, n, flags);
+  free(hs);
+  return p;
+}
+
+ParagonHandle paragon_pool_try_acquire(ParagonPool* p){
+  long long h;
+  if(!p || !paragon_mpmc_pop(&p->free_q, &h)) return -1;
+  __atomic_sub_fetch(&p->avail, 1, __ATOMIC_SEQ_CST);
+  return h;
+}
+
+ParagonHandle paragon_pool_acquire(ParagonPool* p){
+  if(!p) return -1;
+  for(int i=0;;++i){
+    ParagonHandle h = paragon_pool_try_acquire(p);
+    if(h>0) return h;
+    if(i<SPINS) continue;
+    /* all checked out: sleep until a release bumps avail */
+    int a = __atomic_load_n(&p->avail, __ATOMIC_SEQ_CST);
+    if(a>0) continue;
+    __atomic_add_fetch(&p->sleepers, 1, __ATOMIC_SEQ_CST);
+    (void)futex(&p->avail, FUTEX_WAIT_PRIVATE, a);
+    __atomic_sub_fetch(&p->sleepers, 1, __ATOMIC_SEQ_CST);
+  }
+}
+
+void paragon_pool_release(ParagonPool* p, ParagonHandle h){
+  if(!p || h<=0) return;
+  while(!paragon_mpmc_push(&p->free_q, h)) sched_yield();   /* only if h was never ours */
+  __atomic_add_fetch(&p->avail, 1, __ATOMIC_SEQ_CST);
+  if(__atomic_load_n(&p->sleepers, __ATOMIC_SEQ_CST)) (void)futex(&p->avail, FUTEX_WAKE_PRIVATE, 1);
+}
+
+int paragon_pool_size(const ParagonPool* p){ return p ? p->n : 0; }
+
+void paragon_pool_free(ParagonPool* p){
+  if(!p) return;
+  paragon_mpmc_free(&p->free_q);
+  free(p->hs);
+  free(p);
+}
+
+/* ---- work-stealing dispatcher ---- */
+
+typedef struct {
+  ParagonDispatch* d;
+  int              id;
+  ParagonMPMC      q;
+  long long        ran, stolen;
+} Worker;
+
+struct ParagonDispatch {
+  ParagonPool*     pool;
+  Worker*          ws;
+  pthread_t*       th;
+  int              nw;
+  _Alignas(64) unsigned rr;     /* round-robin submit cursor */
+  _Alignas(64) int gen;         /* futex word: bumped on every submit */
+  int              sleepers;
+  int              closing;
+};
+
+static void job_finish(ParagonJob* j, int status){
+  j->status = status;
+  if(j->cb) j->cb(j, j->user);
+  if(__atomic_exchange_n(&j->state, 1, __ATOMIC_ACQ_REL)==2)
+    (void)futex(&j->state, FUTEX_WAKE_PRIVATE, INT_MAX);
+}
+
+static void run_job(ParagonDispatch* d, ParagonJob* j){
+  ParagonPool* p = d->pool;
+  ParagonHandle h = paragon_pool_acquire(p);
+  int st = -1, t = paragon_mem_touch(p->api, h);
+  if(t>=0 && paragon_forward_f32(p->api, h, j->x, 1, p->in_dim))
+    st = paragon_extract_f32(p->api, h, j->y, j->out_cap);
+  paragon_mem_untouch(p->api, h, t);
+  paragon_pool_release(p, h);
+  job_finish(j, st);
+}
+
+static int take(Worker* w, ParagonJob** j){
+  long long v;
+  if(paragon_mpmc_pop(&w->q, &v)){ *j = (ParagonJob*)(intptr_t)v; return 1; }
+  ParagonDispatch* d = w->d;
+  for(int k=1;k<d->nw;k++){
+    Worker* o = &d->ws[(w->id + k) % d->nw];
+    if(paragon_mpmc_pop(&o->q, &v)){
+      *j = (ParagonJob*)(intptr_t)v;
+      __atomic_add_fetch(&w->stolen, 1, __ATOMIC_RELAXED);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void* dispatch_main(void* arg){
+  Worker* w = (Worker*)arg;
+  ParagonDispatch* d = w->d;
+  for(int idle=0;;){
+    int g = __atomic_load_n(&d->gen, __ATOMIC_SEQ_CST);
+    ParagonJob* j;
+    if(take(w, &j)){ run_job(d, j); __atomic_add_fetch(&w->ran, 1, __ATOMIC_RELAXED); idle = 0; continue; }
+    if(__atomic_load_n(&d->closing, __ATOMIC_ACQUIRE)) break;
+    if(++idle<SPINS){ sched_yield(); continue; }
+    __atomic_add_fetch(&d->sleepers, 1, __ATOMIC_SEQ_CST);
+    (void)futex(&d->gen, FUTEX_WAIT_PRIVATE, g);   /* returns at once if a submit raced in */
+    __atomic_sub_fetch(&d->sleepers, 1, __ATOMIC_SEQ_CST);
+  }
+  return NULL;
+}
+
+ParagonDispatch* paragon_dispatch_new(ParagonPool* pool, int workers, int queue_cap){
+  if(!pool || workers<=0) return NULL;
+  if(queue_cap<=0) queue_cap = 1024;
+  ParagonDispatch* d = (ParagonDispatch*)aligned_alloc(64, (sizeof(*d) + 63) & ~(size_t)63);
+  if(!d) return NULL;
+  memset(d, 0, sizeof(*d));
+  d->pool = pool; d->nw = workers;
+  d->ws = (Worker*)aligned_alloc(64, sizeof(Worker)*(size_t)workers);   /* keeps each ring's head/tail on its own line */
+  d->th = (pthread_t*)calloc((size_t)workers, sizeof(pthread_t));
+  if(!d->ws || !d->th){ free(d->ws); free(d->th); free(d); return NULL; }
+  memset(d->ws, 0, sizeof(Worker)*(size_t)workers);
+  /* every ring exists before any worker starts, since workers steal from all of them */
+  for(int i=0;i<workers;i++){
+    d->ws[i].d = d; d->ws[i].id = i;
+    if(!paragon_mpmc_init(&d->ws[i].q, (size_t)queue_cap)){
+      for(int k=0;k<i;k++) paragon_mpmc_free(&d->ws[k].q);
+      free(d->ws); free(d->th); free(d);
+      return NULL;
+    }
+  }
+  for(int i=0;i<workers;i++){
+    if(pthread_create(&d->th[i], NULL, dispatch_main, &d->ws[i])){
+      fprintf(stderr, "paragon_dispatch_new: pthread_create failed for worker %d\n", i);
+      __atomic_store_n(&d->closing, 1, __ATOMIC_RELEASE);
+      __atomic_add_fetch(&d->gen, 1, __ATOMIC_SEQ_CST);
+      (void)futex(&d->gen, FUTEX_WAKE_PRIVATE, INT_MAX);
+      for(int k=0;k<i;k++) pthread_join(d->th[k], NULL);
+      for(int k=0;k<workers;k++) paragon_mpmc_free(&d->ws[k].q);
+      free(d->ws); free(d->th); free(d);
+      return NULL;
+    }
+  }
+  return d;
+}
+
+int paragon_dispatch_submit(ParagonDispatch* d, ParagonJob* j){
+  if(!d || !j || !j->x || !j->y || j->out_cap<=0) return 0;
+  j->state = 0; j->status = -1;
+  unsigned k = __atomic_fetch_add(&d->rr, 1u, __ATOMIC_RELAXED);
+  for(int spin=0;;++spin){
+    int pushed = 0;
+    for(int i=0;i<d->nw && !pushed;i++) pushed = paragon_mpmc_push(&d->ws[(k+i) % d->nw].q, (long long)(intptr_t)j);
+    if(pushed) break;
+    sched_yield();   /* every queue full: back-pressure */
+  }
+  __atomic_add_fetch(&d->gen, 1, __ATOMIC_SEQ_CST);
+  if(__atomic_load_n(&d->sleepers, __ATOMIC_SEQ_CST)) (void)futex(&d->gen, FUTEX_WAKE_PRIVATE, 1);
+  return 1;
+}
+
+int paragon_job_wait(ParagonJob* j){
+  if(!j) return -1;
+  for(int i=0;i<SPINS;i++){
+    if(__atomic_load_n(&j->state, __ATOMIC_ACQUIRE)==1) return j->status;
+    sched_yield();
+  }
+  int s = 0;
+  if(__atomic_compare_exchange_n(&j->state, &s, 2, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) || s==2)
+    while(__atomic_load_n(&j->state, __ATOMIC_ACQUIRE)==2) (void)futex(&j->state, FUTEX_WAIT_PRIVATE, 2);
+  return j->status;
+}
+
+void paragon_dispatch_stats(const ParagonDispatch* d, long long* ran, long long* stolen){
+  long long r = 0, s = 0;
+  if(d) for(int i=0;i<d->nw;i++){
+    r += __atomic_load_n(&d->ws[i].ran, __ATOMIC_RELAXED);
+    s += __atomic_load_n(&d->ws[i].stolen, __ATOMIC_RELAXED);
+  }
+  if(ran) *ran = r;
+  if(stolen) *stolen = s;
+}
+
+void paragon_dispatch_free(ParagonDispatch* d){
+  if(!d) return;
+  __atomic_store_n(&d->closing, 1, __ATOMIC_RELEASE);
+  __atomic_add_fetch(&d->gen, 1, __ATOMIC_SEQ_CST);
+  (void)futex(&d->gen, FUTEX_WAKE_PRIVATE, INT_MAX);
+  for(int i=0;i<d->nw;i++) pthread_join(d->th[i], NULL);   /* drains: workers exit when empty */
+  for(int i=0;i<d->nw;i++) paragon_mpmc_free(&d->ws[i].q);
+  free(d->ws); free(d->th); free(d);
+}
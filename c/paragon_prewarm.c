@@ -0,0 +1,75 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "paragon.h"
+
+/* Background load for short-lived workers: dlopen (the Go runtime starts in the library's
+   constructors), symbol resolution, the capability probe and optionally a first GPU
+   init all run on a helper thread, so they overlap whatever the caller does before its
+   first request. The GPU init uses a 1→1 throwaway handle, like the probe, released
+   again with paragon_free_handle (a no-op when the library cannot free networks). */
+
+struct ParagonPrewarm {
+  ParagonAPI* api;
+  unsigned    flags;
+  char        path[1024];
+  char        cache[512];
+  int         rc, threaded;
+  pthread_t   th;
+};
+
+static double mono_ms(void){
+  struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec*1000.0 + ts.tv_nsec/1e6;
+}
+
+static void* prewarm_main(void* arg){
+  ParagonPrewarm* p = (ParagonPrewarm*)arg;
+  ParagonAPI* api = p->api;
+  p->rc = paragon_load_ex(api, p->path[0] ? p->path : NULL, p->flags & ~(unsigned)PARAGON_LOAD_GPU);
+  if(p->cache[0] && !paragon_gpu_cache_open(api, p->cache)) p->cache[0] = 0;
+  if((p->flags & PARAGON_LOAD_GPU) && api->so){
+    double t0 = mono_ms();
+    ParagonHandle h = paragon_new_handle(api, "[{\"Width\":1,\"Height\":1},{\"Width\":1,\"Height\":1}]",
+                                         "[\"linear\",\"linear\"]", "[false,false]", true, false);
+    if(h>0){
+      paragon_free_result(api, paragon_init_gpu(api, h));
+      (void)paragon_enable_gpu(api, h);
+      (void)paragon_free_handle(api, h);
+    }
+    api->load.gpu_ms = mono_ms() - t0;
+    api->load.total_ms += api->load.gpu_ms;
+  }
+  return NULL;
+}
+
+ParagonPrewarm* paragon_prewarm_start(ParagonAPI* api, const char* so_path, unsigned flags,
+                                      const char* gpu_cache_dir){
+  if(!api) return NULL;
+  ParagonPrewarm* p = (ParagonPrewarm*)calloc(1, sizeof(*p));
+  if(!p) return NULL;
+  p->api = api; p->flags = flags;
+  if(so_path) snprintf(p->path, sizeof(p->path), "%s", so_path);
+  if(gpu_cache_dir) snprintf(p->cache, sizeof(p->cache), "%s", gpu_cache_dir);
+  p->threaded = pthread_create(&p->th, NULL, prewarm_main, p)==0;
+  if(!p->threaded){
+    fprintf(stderr, "paragon_prewarm_start: pthread_create failed, loading inline\n");
+    prewarm_main(p);
+  }
+  return p;
+}
+
+int paragon_prewarm_wait(ParagonPrewarm* p, double* blocked_ms){
+  if(!p) return 0;
+  double t0 = mono_ms();
+  if(p->threaded) pthread_join(p->th, NULL);
+  if(blocked_ms) *blocked_ms = mono_ms() - t0;
+  int rc = p->rc;
+  free(p);
+  return rc;
+}
@@ -0,0 +1,500 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paragon.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define Q_X86 1
+#endif
+
+/* Quantized weights for ParagonModel shapes. fp16 keeps IEEE half weights; int8 keeps
+   one symmetric scale per output channel (max|w|/127). Both run against fp32 inputs:
+   fp16 and int8-f32acc widen weights in registers and accumulate in fp32, while int8
+   also quantizes each input row (one scale per row) and accumulates int8×int8 in int32.
+   Kernels are dot products picked once at runtime, honouring PARAGON_REF_ISA like the
+   fp32 reference; the layer loop runs four input rows per weight row so the weights
+   stream from memory once per block. */
+
+#define QROWS 4
+
+typedef float (*dot_h_fn)(const uint16_t* w, const float* x, int in);
+typedef float (*dot_b_fn)(const int8_t* w, const float* x, int in);
+typedef int   (*dot_q_fn)(const int8_t* w, const int8_t* x, int in);
+/* four input rows x, x+ld, x+2ld, x+3ld against one weight row */
+typedef void  (*dot4_h_fn)(const uint16_t* w, const float* x, size_t ld, int in, float* s);
+typedef void  (*dot4_b_fn)(const int8_t* w, const float* x, size_t ld, int in, float* s);
+typedef void  (*dot4_q_fn)(const int8_t* w, const int8_t* x, size_t ld, int in, int* s);
+
+/* IEEE binary16 <-> binary32, round to nearest even */
+static uint16_t f2h(float f){
+  uint32_t x; memcpy(&x, &f, 4);
+  uint32_t sign = (x>>16) & 0x8000u;
+  x &= 0x7fffffffu;
+  if(x>=0x7f800000u) return (uint16_t)(sign | 0x7c00u | (x>0x7f800000u ? 0x200u : 0u));
+  if(x>=0x477ff000u) return (uint16_t)(sign | 0x7c00u);      /* rounds past 65504 */
+  if(x<0x38800000u){                                         /* half subnormal or zero */
+    if(x<=0x33000000u) return (uint16_t)sign;
+    uint32_t e = x>>23, m = (x & 0x7fffffu) | 0x800000u;
+    int sh = (int)(126 - e);
+    uint32_t r = m >> sh, rem = m & ((1u<<sh)-1), half = 1u<<(sh-1);
+    if(rem>half || (rem==half && (r&1u))) ++r;
+    return (uint16_t)(sign | r);
+  }
+  uint32_t r = (x - 0x38000000u) >> 13, rem = x & 0x1fffu;
+  if(rem>0x1000u || (rem==0x1000u && (r&1u))) ++r;
+  return (uint16_t)(sign | r);
+}
+
+static float h2f(uint16_t h){
+  uint32_t s = (uint32_t)(h & 0x8000u) << 16, e = (h>>10) & 0x1fu, m = h & 0x3ffu, x;
+  if(!e){
+    float f = (float)m * (1.f/16777216.f);
+    memcpy(&x, &f, 4); x |= s;
+  }
+  else if(e==31) x = s | 0x7f800000u | (m<<13);
+  else           x = s | ((e+112u)<<23) | (m<<13);
+  float f; memcpy(&f, &x, 4);
+  return f;
+}
+
+static float dot_h_scalar(const uint16_t* w, const float* x, int in){
+  float s = 0.f;
+  for(int i=0;i<in;i++) s += h2f(w[i])*x[i];
+  return s;
+}
+static float dot_b_scalar(const int8_t* w, const float* x, int in){
+  float s = 0.f;
+  for(int i=0;i<in;i++) s += (float)w[i]*x[i];
+  return s;
+}
+static int dot_q_scalar(const int8_t* w, const int8_t* x, int in){
+  int s = 0;
+  for(int i=0;i<in;i++) s += (int)w[i]*(int)x[i];
+  return s;
+}
+
+static void dot4_h_scalar(const uint16_t* w, const float* x, size_t ld, int in, float* s){
+  for(int k=0;k<4;k++) s[k] = dot_h_scalar(w, x + k*ld, in);
+}
+static void dot4_b_scalar(const int8_t* w, const float* x, size_t ld, int in, float* s){
+  for(int k=0;k<4;k++) s[k] = dot_b_scalar(w, x + k*ld, in);
+}
+static void dot4_q_scalar(const int8_t* w, const int8_t* x, size_t ld, int in, int* s){
+  for(int k=0;k<4;k++) s[k] = dot_q_scalar(w, x + k*ld, in);
+}
+
+#ifdef Q_X86
+__attribute__((target("avx2,fma")))
+static inline float hsum8(__m256 v){
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+  return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2,fma,f16c")))
+static float dot_h_avx2(const uint16_t* w, const float* x, int in){
+  __m256 a0 = _mm256_setzero_ps(), a1 = a0;
+  int i = 0;
+  for(; i+16<=in; i+=16){
+    a0 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(w+i))),   _mm256_loadu_ps(x+i),   a0);
+    a1 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(w+i+8))), _mm256_loadu_ps(x+i+8), a1);
+  }
+  for(; i+8<=in; i+=8)
+    a0 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(w+i))), _mm256_loadu_ps(x+i), a0);
+  float s = hsum8(_mm256_add_ps(a0, a1));
+  for(; i<in; ++i) s += h2f(w[i])*x[i];
+  return s;
+}
+
+__attribute__((target("avx2,fma")))
+static float dot_b_avx2(const int8_t* w, const float* x, int in){
+  __m256 a0 = _mm256_setzero_ps(), a1 = a0;
+  int i = 0;
+  for(; i+16<=in; i+=16){
+    __m128i b = _mm_loadu_si128((const __m128i*)(w+i));
+    a0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(b)),                     _mm256_loadu_ps(x+i),   a0);
+    a1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(b, 8))), _mm256_loadu_ps(x+i+8), a1);
+  }
+  float s = hsum8(_mm256_add_ps(a0, a1));
+  for(; i<in; ++i) s += (float)w[i]*x[i];
+  return s;
+}
+
+__attribute__((target("avx2")))
+static inline int hsum8i(__m256i v){
+  __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+  return _mm_cvtsi128_si32(s);
+}
+
+__attribute__((target("avx2")))
+static int dot_q_avx2(const int8_t* w, const int8_t* x, int in){
+  __m256i acc = _mm256_setzero_si256();
+  int i = 0;
+  for(; i+16<=in; i+=16){
+    __m256i a = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(w+i)));
+    __m256i b = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(x+i)));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));   /* |pair| ≤ 2·127² fits */
+  }
+  int r = hsum8i(acc);
+  for(; i<in; ++i) r += (int)w[i]*(int)x[i];
+  return r;
+}
+
+__attribute__((target("avx2,fma,f16c")))
+static void dot4_h_avx2(const uint16_t* w, const float* x, size_t ld, int in, float* s){
+  const float *x0 = x, *x1 = x+ld, *x2 = x+2*ld, *x3 = x+3*ld;
+  __m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+  int i = 0;
+  for(; i+8<=in; i+=8){
+    __m256 wv = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(w+i)));
+    a0 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x0+i), a0);
+    a1 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x1+i), a1);
+    a2 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x2+i), a2);
+    a3 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x3+i), a3);
+  }
+  s[0] = hsum8(a0); s[1] = hsum8(a1); s[2] = hsum8(a2); s[3] = hsum8(a3);
+  for(; i<in; ++i){ float v = h2f(w[i]); s[0] += v*x0[i]; s[1] += v*x1[i]; s[2] += v*x2[i]; s[3] += v*x3[i]; }
+}
+
+__attribute__((target("avx2,fma")))
+static void dot4_b_avx2(const int8_t* w, const float* x, size_t ld, int in, float* s){
+  const float *x0 = x, *x1 = x+ld, *x2 = x+2*ld, *x3 = x+3*ld;
+  __m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+  int i = 0;
+  for(; i+8<=in; i+=8){
+    __m256 wv = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(w+i))));
+    a0 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x0+i), a0);
+    a1 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x1+i), a1);
+    a2 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x2+i), a2);
+    a3 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x3+i), a3);
+  }
+  s[0] = hsum8(a0); s[1] = hsum8(a1); s[2] = hsum8(a2); s[3] = hsum8(a3);
+  for(; i<in; ++i){ float v = (float)w[i]; s[0] += v*x0[i]; s[1] += v*x1[i]; s[2] += v*x2[i]; s[3] += v*x3[i]; }
+}
+
+__attribute__((target("avx2")))
+static void dot4_q_avx2(const int8_t* w, const int8_t* x, size_t ld, int in, int* s){
+  const int8_t *x0 = x, *x1 = x+ld, *x2 = x+2*ld, *x3 = x+3*ld;
+  __m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+  int i = 0;
+  for(; i+16<=in; i+=16){
+    __m256i wv = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(w+i)));
+    a0 = _mm256_add_epi32(a0, _mm256_madd_epi16(wv, _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(x0+i)))));
+    a1 = _mm256_add_epi32(a1, _mm256_madd_epi16(wv, _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(x1+i)))));
+    a2 = _mm256_add_epi32(a2, _mm256_madd_epi16(wv, _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(x2+i)))));
+    a3 = _mm256_add_epi32(a3, _mm256_madd_epi16(wv, _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(x3+i)))));
+  }
+  s[0] = hsum8i(a0); s[1] = hsum8i(a1); s[2] = hsum8i(a2); s[3] = hsum8i(a3);
+  for(; i<in; ++i){ int v = w[i]; s[0] += v*x0[i]; s[1] += v*x1[i]; s[2] += v*x2[i]; s[3] += v*x3[i]; }
+}
+
+__attribute__((target("avx512f")))
+static float dot_h_avx512(const uint16_t* w, const float* x, int in){
+  __m512 a0 = _mm512_setzero_ps();
+  int i = 0;
+  for(; i+16<=in; i+=16)
+    a0 = _mm512_fmadd_ps(_mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(w+i))), _mm512_loadu_ps(x+i), a0);
+  float s = _mm512_reduce_add_ps(a0);
+  for(; i<in; ++i) s += h2f(w[i])*x[i];
+  return s;
+}
+
+__attribute__((target("avx512f")))
+static float dot_b_avx512(const int8_t* w, const float* x, int in){
+  __m512 a0 = _mm512_setzero_ps();
+  int i = 0;
+  for(; i+16<=in; i+=16)
+    a0 = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i*)(w+i)))),
+                         _mm512_loadu_ps(x+i), a0);
+  float s = _mm512_reduce_add_ps(a0);
+  for(; i<in; ++i) s += (float)w[i]*x[i];
+  return s;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static int dot_q_avx512(const int8_t* w, const int8_t* x, int in){
+  __m512i acc = _mm512_setzero_si512();
+  int i = 0;
+  for(; i+32<=in; i+=32){
+    __m512i a = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(w+i)));
+    __m512i b = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(x+i)));
+    acc = _mm512_add_epi32(acc, _mm512_madd_epi16(a, b));
+  }
+  int r = _mm512_reduce_add_epi32(acc);
+  for(; i<in; ++i) r += (int)w[i]*(int)x[i];
+  return r;
+}
+
+__attribute__((target("avx512f")))
+static void dot4_h_avx512(const uint16_t* w, const float* x, size_t ld, int in, float* s){
+  const float *x0 = x, *x1 = x+ld, *x2 = x+2*ld, *x3 = x+3*ld;
+  __m512 a0 = _mm512_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+  int i = 0;
+  for(; i+16<=in; i+=16){
+    __m512 wv = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(w+i)));
+    a0 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x0+i), a0);
+    a1 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x1+i), a1);
+    a2 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x2+i), a2);
+    a3 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x3+i), a3);
+  }
+  s[0] = _mm512_reduce_add_ps(a0); s[1] = _mm512_reduce_add_ps(a1);
+  s[2] = _mm512_reduce_add_ps(a2); s[3] = _mm512_reduce_add_ps(a3);
+  for(; i<in; ++i){ float v = h2f(w[i]); s[0] += v*x0[i]; s[1] += v*x1[i]; s[2] += v*x2[i]; s[3] += v*x3[i]; }
+}
+
+__attribute__((target("avx512f")))
+static void dot4_b_avx512(const int8_t* w, const float* x, size_t ld, int in, float* s){
+  const float *x0 = x, *x1 = x+ld, *x2 = x+2*ld, *x3 = x+3*ld;
+  __m512 a0 = _mm512_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+  int i = 0;
+  for(; i+16<=in; i+=16){
+    __m512 wv = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i*)(w+i))));
+    a0 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x0+i), a0);
+    a1 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x1+i), a1);
+    a2 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x2+i), a2);
+    a3 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x3+i), a3);
+  }
+  s[0] = _mm512_reduce_add_ps(a0); s[1] = _mm512_reduce_add_ps(a1);
+  s[2] = _mm512_reduce_add_ps(a2); s[3] = _mm512_reduce_add_ps(a3);
+  for(; i<in; ++i){ float v = (float)w[i]; s[0] += v*x0[i]; s[1] += v*x1[i]; s[2] += v*x2[i]; s[3] += v*x3[i]; }
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void dot4_q_avx512(const int8_t* w, const int8_t* x, size_t ld, int in, int* s){
+  const int8_t *x0 = x, *x1 = x+ld, *x2 = x+2*ld, *x3 = x+3*ld;
+  __m512i a0 = _mm512_setzero_si512(), a1 = a0, a2 = a0, a3 = a0;
+  int i = 0;
+  for(; i+32<=in; i+=32){
+    __m512i wv = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(w+i)));
+    a0 = _mm512_add_epi32(a0, _mm512_madd_epi16(wv, _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(x0+i)))));
+    a1 = _mm512_add_epi32(a1, _mm512_madd_epi16(wv, _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(x1+i)))));
+    a2 = _mm512_add_epi32(a2, _mm512_madd_epi16(wv, _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(x2+i)))));
+    a3 = _mm512_add_epi32(a3, _mm512_madd_epi16(wv, _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(x3+i)))));
+  }
+  s[0] = _mm512_reduce_add_epi32(a0); s[1] = _mm512_reduce_add_epi32(a1);
+  s[2] = _mm512_reduce_add_epi32(a2); s[3] = _mm512_reduce_add_epi32(a3);
+  for(; i<in; ++i){ int v = w[i]; s[0] += v*x0[i]; s[1] += v*x1[i]; s[2] += v*x2[i]; s[3] += v*x3[i]; }
+}
+#endif
+
+static dot_h_fn g_dot_h;
+static dot_b_fn g_dot_b;
+static dot_q_fn g_dot_q;
+static dot4_h_fn g_dot4_h;
+static dot4_b_fn g_dot4_b;
+static dot4_q_fn g_dot4_q;
+
+static void pick(void){
+  const char* want = getenv("PARAGON_REF_ISA");
+  if(want && !*want) want = NULL;
+  g_dot_h = dot_h_scalar; g_dot_b = dot_b_scalar; g_dot_q = dot_q_scalar;
+  g_dot4_h = dot4_h_scalar; g_dot4_b = dot4_b_scalar; g_dot4_q = dot4_q_scalar;
+  if(want && !strcmp(want, "scalar")) return;
+#ifdef Q_X86
+  __builtin_cpu_init();
+  int has512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+  int has2   = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  if(has512 && (!want || !strcmp(want, "avx512"))){
+    g_dot_h = dot_h_avx512; g_dot_b = dot_b_avx512; g_dot_q = dot_q_avx512;
+    g_dot4_h = dot4_h_avx512; g_dot4_b = dot4_b_avx512; g_dot4_q = dot4_q_avx512;
+    return;
+  }
+  if(has2 && (!want || !strcmp(want, "avx2") || !strcmp(want, "avx512"))){
+    g_dot_b = dot_b_avx2; g_dot_q = dot_q_avx2;
+    g_dot4_b = dot4_b_avx2; g_dot4_q = dot4_q_avx2;
+    if(__builtin_cpu_supports("f16c")){ g_dot_h = dot_h_avx2; g_dot4_h = dot4_h_avx2; }
+  }
+#endif
+}
+
+static pthread_once_t g_pick_once = PTHREAD_ONCE_INIT;
+
+const char* paragon_qtype_name(int dtype, int acc){
+  if(dtype==PARAGON_Q_F16)  return "fp16";
+  if(dtype==PARAGON_Q_INT8) return acc==PARAGON_QACC_F32 ? "int8-f32acc" : "int8";
+  return "fp32";
+}
+
+static size_t up64(size_t n){ return (n + 63) & ~(size_t)63; }
+
+int paragon_quantize(ParagonQModel* q, const ParagonModel* m, int dtype, int acc){
+  memset(q, 0, sizeof(*q));
+  if(!m || !m->base || (dtype!=PARAGON_Q_F16 && dtype!=PARAGON_Q_INT8)) return 0;
+  q->dtype = dtype; q->acc = dtype==PARAGON_Q_F16 ? PARAGON_QACC_F32 : acc;
+  q->nlayers = m->nlayers;
+  memcpy(q->dims, m->dims, sizeof(q->dims));
+  memcpy(q->act, m->act, sizeof(q->act));
+  size_t esz = dtype==PARAGON_Q_F16 ? 2 : 1, total = 0;
+  for(int l=0; l+1<m->nlayers; ++l){
+    size_t in = (size_t)m->dims[l], out = (size_t)m->dims[l+1];
+    total += up64(in*out*esz) + 2*up64(out*sizeof(float));
+  }
+  char* p = aligned_alloc(64, total ? total : 64);
+  if(!p){ fprintf(stderr, "quantize: out of memory (%zu bytes)\n", total); return 0; }
+  q->block = p; q->bytes = total;
+  for(int l=0; l+1<m->nlayers; ++l){
+    int in = m->dims[l], out = m->dims[l+1];
+    const float* W = m->W[l];
+    float* S = (float*)(p + up64((size_t)in*out*esz));
+    float* B = (float*)((char*)S + up64((size_t)out*sizeof(float)));
+    if(dtype==PARAGON_Q_F16){
+      uint16_t* h = (uint16_t*)p;
+      for(size_t i=0; i<(size_t)in*out; ++i) h[i] = f2h(W[i]);
+      for(int o=0;o<out;o++) S[o] = 1.f;
+    } else {
+      int8_t* b = (int8_t*)p;
+      for(int o=0;o<out;o++){
+        const float* w = W + (size_t)o*in;
+        float mx = 0.f;
+        for(int i=0;i<in;i++) if(fabsf(w[i])>mx) mx = fabsf(w[i]);
+        float s = mx>0.f ? mx/127.f : 1.f, inv = 1.f/s;
+        for(int i=0;i<in;i++){
+          long v = lrintf(w[i]*inv);
+          b[(size_t)o*in + i] = (int8_t)(v>127 ? 127 : v<-127 ? -127 : v);
+        }
+        S[o] = s;
+      }
+    }
+    memcpy(B, m->B[l], sizeof(float)*(size_t)out);
+    q->W[l] = p; q->S[l] = S; q->B[l] = B;
+    p = (char*)B + up64((size_t)out*sizeof(float));
+  }
+  return 1;
+}
+
+void paragon_qmodel_free(ParagonQModel* q){
+  if(!q) return;
+  free(q->block);
+  memset(q, 0, sizeof(*q));
+}
+
+int paragon_qmodel_dequant(const ParagonQModel* q, int l, float* W){
+  if(!q || !q->block || l<0 || l+1>=q->nlayers) return 0;
+  int in = q->dims[l], out = q->dims[l+1];
+  for(int o=0;o<out;o++){
+    float* w = W + (size_t)o*in;
+    if(q->dtype==PARAGON_Q_F16){
+      const uint16_t* h = (const uint16_t*)q->W[l] + (size_t)o*in;
+      for(int i=0;i<in;i++) w[i] = h2f(h[i]);
+    } else {
+      const int8_t* b = (const int8_t*)q->W[l] + (size_t)o*in;
+      for(int i=0;i<in;i++) w[i] = (float)b[i]*q->S[l][o];
+    }
+  }
+  return 1;
+}
+
+/* rows [r, r+nr) of one layer into Y (n×out); full blocks share each weight row */
+static void qdense(const ParagonQModel* q, int l, const float* X, const int8_t* Xq,
+                   const float* sx, int r, int nr, float* Y){
+  int in = q->dims[l], out = q->dims[l+1];
+  const float* S = q->S[l]; const float* B = q->B[l];
+  const float* x = X + (size_t)r*in; const int8_t* xb = Xq + (size_t)r*in;
+  float s[QROWS]; int si[QROWS];
+  for(int o=0; o<out; ++o){
+    size_t wo = (size_t)o*in;
+    if(q->dtype==PARAGON_Q_F16){
+      const uint16_t* w = (const uint16_t*)q->W[l] + wo;
+      if(nr==QROWS) g_dot4_h(w, x, (size_t)in, in, s);
+      else for(int k=0;k<nr;k++) s[k] = g_dot_h(w, x + (size_t)k*in, in);
+    } else if(q->acc==PARAGON_QACC_F32){
+      const int8_t* w = (const int8_t*)q->W[l] + wo;
+      if(nr==QROWS) g_dot4_b(w, x, (size_t)in, in, s);
+      else for(int k=0;k<nr;k++) s[k] = g_dot_b(w, x + (size_t)k*in, in);
+      for(int k=0;k<nr;k++) s[k] *= S[o];
+    } else {
+      const int8_t* w = (const int8_t*)q->W[l] + wo;
+      if(nr==QROWS) g_dot4_q(w, xb, (size_t)in, in, si);
+      else for(int k=0;k<nr;k++) si[k] = g_dot_q(w, xb + (size_t)k*in, in);
+      for(int k=0;k<nr;k++) s[k] = S[o]*sx[r+k]*(float)si[k];
+    }
+    for(int k=0;k<nr;k++) Y[(size_t)(r+k)*out + o] = s[k] + B[o];
+  }
+}
+
+static void quantize_rows(const float* X, int n, int in, int8_t* Xq, float* sx){
+  for(int r=0;r<n;r++){
+    const float* x = X + (size_t)r*in;
+    float mx = 0.f;
+    for(int i=0;i<in;i++) if(fabsf(x[i])>mx) mx = fabsf(x[i]);
+    float s = mx>0.f ? mx/127.f : 1.f, inv = 1.f/s;
+    for(int i=0;i<in;i++) Xq[(size_t)r*in + i] = (int8_t)lrintf(x[i]*inv);
+    sx[r] = s;
+  }
+}
+
+int paragon_qref_forward(const ParagonQModel* q, const float* X, int n, float* Y, int out_cap){
+  if(!q || !q->block || !X || !Y || n<=0) return -1;
+  int out = q->dims[q->nlayers-1];
+  if((long long)n*out > out_cap) return -1;
+  pthread_once(&g_pick_once, pick);
+  int maxd = 0;
+  for(int l=0; l<q->nlayers; ++l) if(q->dims[l]>maxd) maxd = q->dims[l];
+  int i32 = q->dtype==PARAGON_Q_INT8 && q->acc!=PARAGON_QACC_F32;
+  ParagonArena* sc = paragon_scratch();
+  size_t nf = (size_t)n*maxd;
+  float* buf = sc ? (float*)paragon_arena_alloc(sc, sizeof(float)*(nf*2 + (size_t)n) + (i32 ? nf : 0)) : NULL;
+  if(!buf) return -1;
+  float* ping = buf; float* pong = buf + nf; float* sx = pong + nf;
+  int8_t* xq = (int8_t*)(sx + n);
+  const float* cur = X;
+  for(int l=0; l+1<q->nlayers; ++l){
+    int o = q->dims[l+1];
+    float* dst = l+2==q->nlayers ? Y : (cur==ping ? pong : ping);
+    if(i32) quantize_rows(cur, n, q->dims[l], xq, sx);
+    for(int r=0; r<n; r+=QROWS) qdense(q, l, cur, xq, sx, r, n-r<QROWS ? n-r : QROWS, dst);
+    paragon_ref_activate(dst, n, o, q->act[l+1]);
+    cur = dst;
+  }
+  paragon_arena_reset(sc);
+  return out;
+}
+
+ParagonHandle paragon_new_quantized(ParagonAPI* api, const ParagonModel* m,
+                                    const ParagonQModel* q, bool prefer_gpu, int* how){
+  if(how) *how = PARAGON_MODEL_SHAPE_ONLY;
+  if(!api || !m || !m->base || !q || !q->block) return -1;
+  ParagonArena ar; paragon_arena_init(&ar, 1024);
+  char *layers, *activs, *trainable;
+  paragon_model_json(&ar, m, &layers, &activs, &trainable);
+  ParagonHandle h = layers ? paragon_new_handle(api, layers, activs, trainable, prefer_gpu, false) : -1;
+  paragon_arena_free(&ar);
+  if(h<=0) return h;
+
+  if(api->SetLayerWeightsQ){
+    for(int l=0; l+1<q->nlayers; ++l){
+      long long nw = (long long)q->dims[l]*q->dims[l+1], nb = q->dims[l+1];
+      if(api->SetLayerWeightsQ(h, l, q->dtype, q->acc, q->W[l], nw, q->S[l], nb, q->B[l], nb)){
+        fprintf(stderr, "quantize: SetLayerWeights_Q failed at layer %d\n", l);
+        return h;
+      }
+    }
+    paragon_weights_changed(api, h);
+    if(how) *how = PARAGON_MODEL_QUANTIZED;
+    return h;
+  }
+  if(!api->SetLayerWeights) return h;
+  /* no native quantized path: the library gets fp32 copies of the rounded weights, so
+     accuracy matches the quantized model but memory and speed stay fp32 */
+  for(int l=0; l+1<q->nlayers; ++l){
+    long long nw = (long long)q->dims[l]*q->dims[l+1], nb = q->dims[l+1];
+    float* W = malloc(sizeof(float)*(size_t)nw);
+    if(!W) return h;
+    (void)paragon_qmodel_dequant(q, l, W);
+    int bad = api->SetLayerWeights(h, l, W, nw, q->B[l], nb);
+    free(W);
+    if(bad){ fprintf(stderr, "quantize: SetLayerWeights_F32 failed at layer %d\n", l); return h; }
+  }
+  paragon_weights_changed(api, h);
+  if(how) *how = PARAGON_MODEL_DEQUANT;
+  return h;
+}
@@ -0,0 +1,258 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paragon.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REF_X86 1
+#endif
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define REF_NEON 1
+#endif
+
+/* Independent dense forward for ParagonModel weights: Y = act(X·Wᵀ + B) per layer.
+   Kernels work four input rows at a time against one weight row (W is out×in row-major,
+   so every output is a contiguous dot product). The ISA is picked once at runtime;
+   PARAGON_REF_ISA=scalar|avx2|avx512|neon forces one. The scalar kernel is the plain
+   definition the SIMD ones are checked against. */
+
+typedef void (*dense_fn)(const float* X, int n, int in, const float* W, const float* B,
+                         int out, float* Y);
+
+static void dense_scalar(const float* X, int n, int in, const float* W, const float* B,
+                         int out, float* Y){
+  for(int r=0; r<n; ++r){
+    const float* x = X + (size_t)r*in;
+    for(int o=0; o<out; ++o){
+      const float* w = W + (size_t)o*in;
+      float s = 0.f;
+      for(int i=0; i<in; ++i) s += w[i]*x[i];
+      Y[(size_t)r*out + o] = s + B[o];
+    }
+  }
+}
+
+#ifdef REF_X86
+__attribute__((target("avx2,fma")))
+static inline float hsum256(__m256 v){
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+  return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2,fma")))
+static void dense_avx2(const float* X, int n, int in, const float* W, const float* B,
+                       int out, float* Y){
+  int r = 0;
+  for(; r+4<=n; r+=4){
+    const float* x0 = X + (size_t)r*in;
+    const float* x1 = x0 + in; const float* x2 = x1 + in; const float* x3 = x2 + in;
+    for(int o=0; o<out; ++o){
+      const float* w = W + (size_t)o*in;
+      __m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+      int i = 0;
+      for(; i+8<=in; i+=8){
+        __m256 wv = _mm256_loadu_ps(w+i);
+        a0 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x0+i), a0);
+        a1 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x1+i), a1);
+        a2 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x2+i), a2);
+        a3 = _mm256_fmadd_ps(wv, _mm256_loadu_ps(x3+i), a3);
+      }
+      float s0 = hsum256(a0), s1 = hsum256(a1), s2 = hsum256(a2), s3 = hsum256(a3);
+      for(; i<in; ++i){ s0 += w[i]*x0[i]; s1 += w[i]*x1[i]; s2 += w[i]*x2[i]; s3 += w[i]*x3[i]; }
+      Y[(size_t)(r+0)*out + o] = s0 + B[o];
+      Y[(size_t)(r+1)*out + o] = s1 + B[o];
+      Y[(size_t)(r+2)*out + o] = s2 + B[o];
+      Y[(size_t)(r+3)*out + o] = s3 + B[o];
+    }
+  }
+  for(; r<n; ++r){
+    const float* x = X + (size_t)r*in;
+    for(int o=0; o<out; ++o){
+      const float* w = W + (size_t)o*in;
+      __m256 a0 = _mm256_setzero_ps(), a1 = a0;
+      int i = 0;
+      for(; i+16<=in; i+=16){
+        a0 = _mm256_fmadd_ps(_mm256_loadu_ps(w+i),   _mm256_loadu_ps(x+i),   a0);
+        a1 = _mm256_fmadd_ps(_mm256_loadu_ps(w+i+8), _mm256_loadu_ps(x+i+8), a1);
+      }
+      for(; i+8<=in; i+=8) a0 = _mm256_fmadd_ps(_mm256_loadu_ps(w+i), _mm256_loadu_ps(x+i), a0);
+      float s = hsum256(_mm256_add_ps(a0, a1));
+      for(; i<in; ++i) s += w[i]*x[i];
+      Y[(size_t)r*out + o] = s + B[o];
+    }
+  }
+}
+
+__attribute__((target("avx512f")))
+static void dense_avx512(const float* X, int n, int in, const float* W, const float* B,
+                         int out, float* Y){
+  int r = 0;
+  for(; r+4<=n; r+=4){
+    const float* x0 = X + (size_t)r*in;
+    const float* x1 = x0 + in; const float* x2 = x1 + in; const float* x3 = x2 + in;
+    for(int o=0; o<out; ++o){
+      const float* w = W + (size_t)o*in;
+      __m512 a0 = _mm512_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+      int i = 0;
+      for(; i+16<=in; i+=16){
+        __m512 wv = _mm512_loadu_ps(w+i);
+        a0 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x0+i), a0);
+        a1 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x1+i), a1);
+        a2 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x2+i), a2);
+        a3 = _mm512_fmadd_ps(wv, _mm512_loadu_ps(x3+i), a3);
+      }
+      if(i<in){   /* masked tail keeps the whole row in vector registers */
+        __mmask16 k = (__mmask16)((1u << (in-i)) - 1);
+        __m512 wv = _mm512_maskz_loadu_ps(k, w+i);
+        a0 = _mm512_fmadd_ps(wv, _mm512_maskz_loadu_ps(k, x0+i), a0);
+        a1 = _mm512_fmadd_ps(wv, _mm512_maskz_loadu_ps(k, x1+i), a1);
+        a2 = _mm512_fmadd_ps(wv, _mm512_maskz_loadu_ps(k, x2+i), a2);
+        a3 = _mm512_fmadd_ps(wv, _mm512_maskz_loadu_ps(k, x3+i), a3);
+      }
+      Y[(size_t)(r+0)*out + o] = _mm512_reduce_add_ps(a0) + B[o];
+      Y[(size_t)(r+1)*out + o] = _mm512_reduce_add_ps(a1) + B[o];
+      Y[(size_t)(r+2)*out + o] = _mm512_reduce_add_ps(a2) + B[o];
+      Y[(size_t)(r+3)*out + o] = _mm512_reduce_add_ps(a3) + B[o];
+    }
+  }
+  for(; r<n; ++r){
+    const float* x = X + (size_t)r*in;
+    for(int o=0; o<out; ++o){
+      const float* w = W + (size_t)o*in;
+      __m512 a0 = _mm512_setzero_ps(), a1 = a0;
+      int i = 0;
+      for(; i+32<=in; i+=32){
+        a0 = _mm512_fmadd_ps(_mm512_loadu_ps(w+i),    _mm512_loadu_ps(x+i),    a0);
+        a1 = _mm512_fmadd_ps(_mm512_loadu_ps(w+i+16), _mm512_loadu_ps(x+i+16), a1);
+      }
+      for(; i+16<=in; i+=16) a0 = _mm512_fmadd_ps(_mm512_loadu_ps(w+i), _mm512_loadu_ps(x+i), a0);
+      if(i<in){
+        __mmask16 k = (__mmask16)((1u << (in-i)) - 1);
+        a1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(k, w+i), _mm512_maskz_loadu_ps(k, x+i), a1);
+      }
+      Y[(size_t)r*out + o] = _mm512_reduce_add_ps(_mm512_add_ps(a0, a1)) + B[o];
+    }
+  }
+}
+#endif
+
+#ifdef REF_NEON
+static void dense_neon(const float* X, int n, int in, const float* W, const float* B,
+                       int out, float* Y){
+  int r = 0;
+  for(; r+4<=n; r+=4){
+    const float* x0 = X + (size_t)r*in;
+    const float* x1 = x0 + in; const float* x2 = x1 + in; const float* x3 = x2 + in;
+    for(int o=0; o<out; ++o){
+      const float* w = W + (size_t)o*in;
+      float32x4_t a0 = vdupq_n_f32(0.f), a1 = a0, a2 = a0, a3 = a0;
+      int i = 0;
+      for(; i+4<=in; i+=4){
+        float32x4_t wv = vld1q_f32(w+i);
+        a0 = vfmaq_f32(a0, wv, vld1q_f32(x0+i));
+        a1 = vfmaq_f32(a1, wv, vld1q_f32(x1+i));
+        a2 = vfmaq_f32(a2, wv, vld1q_f32(x2+i));
+        a3 = vfmaq_f32(a3, wv, vld1q_f32(x3+i));
+      }
+      float s0 = vaddvq_f32(a0), s1 = vaddvq_f32(a1), s2 = vaddvq_f32(a2), s3 = vaddvq_f32(a3);
+      for(; i<in; ++i){ s0 += w[i]*x0[i]; s1 += w[i]*x1[i]; s2 += w[i]*x2[i]; s3 += w[i]*x3[i]; }
+      Y[(size_t)(r+0)*out + o] = s0 + B[o];
+      Y[(size_t)(r+1)*out + o] = s1 + B[o];
+      Y[(size_t)(r+2)*out + o] = s2 + B[o];
+      Y[(size_t)(r+3)*out + o] = s3 + B[o];
+    }
+  }
+  for(; r<n; ++r){
+    const float* x = X + (size_t)r*in;
+    for(int o=0; o<out; ++o){
+      const float* w = W + (size_t)o*in;
+      float32x4_t a0 = vdupq_n_f32(0.f), a1 = a0;
+      int i = 0;
+      for(; i+8<=in; i+=8){
+        a0 = vfmaq_f32(a0, vld1q_f32(w+i),   vld1q_f32(x+i));
+        a1 = vfmaq_f32(a1, vld1q_f32(w+i+4), vld1q_f32(x+i+4));
+      }
+      for(; i+4<=in; i+=4) a0 = vfmaq_f32(a0, vld1q_f32(w+i), vld1q_f32(x+i));
+      float s = vaddvq_f32(vaddq_f32(a0, a1));
+      for(; i<in; ++i) s += w[i]*x[i];
+      Y[(size_t)r*out + o] = s + B[o];
+    }
+  }
+}
+#endif
+
+static dense_fn    g_dense;
+static const char* g_isa;
+
+static void pick(void){
+  const char* want = getenv("PARAGON_REF_ISA");
+  if(want && !*want) want = NULL;
+  g_dense = dense_scalar; g_isa = "scalar";
+  if(want && !strcmp(want, "scalar")) return;
+#ifdef REF_X86
+  __builtin_cpu_init();
+  int has512 = __builtin_cpu_supports("avx512f");
+  int has2   = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  if(has512 && (!want || !strcmp(want, "avx512"))){ g_dense = dense_avx512; g_isa = "avx512f"; return; }
+  if(has2 && (!want || !strcmp(want, "avx2") || !strcmp(want, "avx512"))){ g_dense = dense_avx2; g_isa = "avx2+fma"; return; }
+#endif
+#ifdef REF_NEON
+  g_dense = dense_neon; g_isa = "neon";
+#endif
+}
+
+static pthread_once_t g_pick_once = PTHREAD_ONCE_INIT;
+
+const char* paragon_ref_isa(void){
+  pthread_once(&g_pick_once, pick);
+  return g_isa;
+}
+
+void paragon_ref_activate(float* y, int n, int dim, int act){
+  for(int r=0; r<n; ++r){
+    float* v = y + (size_t)r*dim;
+    switch(act){
+      case PARAGON_ACT_RELU:    for(int i=0;i<dim;i++) if(v[i]<0.f) v[i] = 0.f; break;
+      case PARAGON_ACT_SIGMOID: for(int i=0;i<dim;i++) v[i] = 1.f/(1.f + expf(-v[i])); break;
+      case PARAGON_ACT_TANH:    for(int i=0;i<dim;i++) v[i] = tanhf(v[i]); break;
+      case PARAGON_ACT_SOFTMAX: {
+        float m = v[0], z = 0.f;
+        for(int i=1;i<dim;i++) if(v[i]>m) m = v[i];
+        for(int i=0;i<dim;i++){ v[i] = expf(v[i]-m); z += v[i]; }
+        for(int i=0;i<dim;i++) v[i] /= z;
+        break;
+      }
+      default: break;
+    }
+  }
+}
+
+int paragon_ref_forward(const ParagonModel* m, const float* X, int n, float* Y, int out_cap){
+  if(!m || !m->base || !X || !Y || n<=0) return -1;
+  int out = m->dims[m->nlayers-1];
+  if((long long)n*out > out_cap) return -1;
+  pthread_once(&g_pick_once, pick);
+  int maxd = 0;
+  for(int l=1; l<m->nlayers; ++l) if(m->dims[l]>maxd) maxd = m->dims[l];
+  ParagonArena* sc = paragon_scratch();
+  float* buf = sc ? (float*)paragon_arena_alloc(sc, sizeof(float)*(size_t)n*maxd*2) : NULL;
+  if(!buf) return -1;
+  float* ping = buf; float* pong = buf + (size_t)n*maxd;
+  const float* cur = X;
+  for(int l=0; l+1<m->nlayers; ++l){
+    int in = m->dims[l], o = m->dims[l+1];
+    float* dst = l+2==m->nlayers ? Y : (cur==ping ? pong : ping);
+    g_dense(cur, n, in, m->W[l], m->B[l], o, dst);
+    paragon_ref_activate(dst, n, o, m->act[l+1]);
+    cur = dst;
+  }
+  paragon_arena_reset(sc);
+  return out;
+}
@@ -0,0 +1,351 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paragon.h"
+
+/* Resolved-method cache + handle table.
+   Method slots are append-only: a slot is written before nmethods is published, so
+   paragon_call_id can read a token's slot without the lock. lib_id starts at
+   UNRESOLVED and is settled on first use with a live handle. */
+
+#define UNRESOLVED (-2)
+
+static const char* const BUILTIN[PARAGON_M_BUILTINS] = {
+  [PARAGON_M_FORWARD]        = "Forward",
+  [PARAGON_M_EXTRACT_OUTPUT] = "ExtractOutput",
+  [PARAGON_M_INIT_GPU]       = "InitializeOptimizedGPU",
+  [PARAGON_M_TOGGLE_GPU]     = "ToggleGPU",
+};
+
+void paragon_registry_init(ParagonAPI* api){
+  pthread_mutex_init(&api->lock, NULL);
+  for(int i=0; i<PARAGON_M_BUILTINS; ++i){
+    snprintf(api->methods[i].name, sizeof(api->methods[i].name), "%s", BUILTIN[i]);
+    api->methods[i].lib_id = UNRESOLVED;
+  }
+  api->nmethods = PARAGON_M_BUILTINS;
+}
+
+void paragon_registry_free(ParagonAPI* api){
+  free(api->handles);
+  api->handles = NULL; api->nhandles = api->caphandles = 0;
+  pthread_mutex_destroy(&api->lock);
+}
+
+static int resolve_lib_id(ParagonAPI* api, ParagonHandle h, ParagonMethodSlot* s){
+  int id = __atomic_load_n(&s->lib_id, __ATOMIC_ACQUIRE);
+  if(id!=UNRESOLVED) return id;
+  if(!api->MethodID || !api->CallID){ id = -1; }
+  else if(h<=0) return UNRESOLVED;       /* need a live handle to ask */
+  else { id = api->MethodID(h, s->name); if(id<0) id = -1; }
+  __atomic_store_n(&s->lib_id, id, __ATOMIC_RELEASE);
+  return id;
+}
+
+ParagonMethod paragon_method_id(ParagonAPI* api, ParagonHandle h, const char* method){
+  if(!api || !method || !*method) return -1;
+  if(strlen(method) >= sizeof(api->methods[0].name)) return -1;
+  pthread_mutex_lock(&api->lock);
+  int n = api->nmethods, m = -1;
+  for(int i=0; i<n; ++i){
+    if(!strcmp(api->methods[i].name, method)){ m = i; break; }
+  }
+  if(m<0 && n<PARAGON_MAX_METHODS){
+    m = n;
+    snprintf(api->methods[m].name, sizeof(api->methods[m].name), "%s", method);
+    api->methods[m].lib_id = UNRESOLVED;
+    __atomic_store_n(&api->nmethods, n+1, __ATOMIC_RELEASE);
+  }
+  pthread_mutex_unlock(&api->lock);
+  if(m>=0) (void)resolve_lib_id(api, h, &api->methods[m]);
+  return m;
+}
+
+char* paragon_call_id(ParagonAPI* api, ParagonHandle h, ParagonMethod m, const char* args_json){
+  if(!api || m<0 || m>=__atomic_load_n(&api->nmethods, __ATOMIC_ACQUIRE)) return NULL;
+  ParagonMethodSlot* s = &api->methods[m];
+  const char* args = args_json ? args_json : "[]";
+  int t = paragon_mem_touch(api, h);
+  if(t<0) return NULL;
+  ParagonSpan sp; paragon_span_begin(api, &sp, s->name, h);
+  int id = resolve_lib_id(api, h, s);
+  paragon_span_lib(&sp);
+  char* r = id>=0 ? api->CallID(h, id, args) : api->Call ? api->Call(h, s->name, args) : NULL;
+  paragon_span_ret(&sp);
+  paragon_span_end(&sp, sp.t ? (long long)strlen(args) : 0, sp.t && r ? (long long)strlen(r) : 0);
+  paragon_mem_untouch(api, h, t);
+  if(m==PARAGON_M_TOGGLE_GPU) paragon_gpu_toggled(api, h, r);
+  if(m!=PARAGON_M_FORWARD && m!=PARAGON_M_EXTRACT_OUTPUT) paragon_weights_changed(api, h);
+  return r;
+}
+
+/* ---- handle table ---- */
+
+static unsigned slot_of(ParagonHandle h, int cap){
+  unsigned long long x = (unsigned long long)h * 0x9E3779B97F4A7C15ull;
+  return (unsigned)(x >> 32) & (unsigned)(cap-1);
+}
+
+static ParagonHandleInfo* find_locked(ParagonAPI* api, ParagonHandle h){
+  if(!api->caphandles) return NULL;
+  for(unsigned i = slot_of(h, api->caphandles); ; i = (i+1) & (unsigned)(api->caphandles-1)){
+    ParagonHandleInfo* e = &api->handles[i];
+    if(e->h==h) return e;
+    if(e->h==0) return NULL;
+  }
+}
+
+static ParagonHandleInfo* insert_locked(ParagonAPI* api, ParagonHandle h){
+  if((api->nhandles+1)*10 > api->caphandles*7){
+    int ncap = api->caphandles ? api->caphandles*2 : 64;
+    ParagonHandleInfo* nt = (ParagonHandleInfo*)calloc((size_t)ncap, sizeof(*nt));
+    if(!nt) return NULL;
+    for(int i=0; i<api->caphandles; ++i){
+      ParagonHandleInfo* e = &api->handles[i];
+      if(!e->h) continue;
+      unsigned j = slot_of(e->h, ncap);
+      while(nt[j].h) j = (j+1) & (unsigned)(ncap-1);
+      nt[j] = *e;
+    }
+    free(api->handles);
+    api->handles = nt; api->caphandles = ncap;
+  }
+  ParagonHandleInfo* e = find_locked(api, h);
+  if(e) return e;
+  unsigned i = slot_of(h, api->caphandles);
+  while(api->handles[i].h) i = (i+1) & (unsigned)(api->caphandles-1);
+  e = &api->handles[i];
+  memset(e, 0, sizeof(*e));
+  e->h = h;
+  e->adapter = -1;
+  ++api->nhandles;
+  return e;
+}
+
+ParagonHandleInfo* paragon_handle_locked(ParagonAPI* api, ParagonHandle h, int create){
+  ParagonHandleInfo* e = find_locked(api, h);
+  return e || !create ? e : insert_locked(api, h);
+}
+
+/* first and last Width×Height in the layers JSON */
+static void io_dims(const char* layers, int* in_dim, int* out_dim){
+  *in_dim = *out_dim = 0;
+  for(const char* p = layers; p && (p = strstr(p, "\"Width\"")); ){
+    const char* w = strchr(p, ':');
+    if(!w) break;
+    int width = atoi(w+1), height = 1;
+    const char* hh = strstr(p, "\"Height\"");
+    const char* close = strchr(p, '}');
+    if(hh && (!close || hh<close)){ const char* c = strchr(hh, ':'); if(c) height = atoi(c+1); }
+    if(height<1) height = 1;
+    if(!*in_dim) *in_dim = width*height;
+    *out_dim = width*height;
+    p = w;
+  }
+}
+
+ParagonHandle paragon_new_handle(ParagonAPI* api,
+                                 const char* layers_json,
+                                 const char* activs_json,
+                                 const char* trainable_json,
+                                 bool prefer_gpu,
+                                 bool expose_methods_json)
+{
+  return paragon_new_handle_ex(api, layers_json, activs_json, trainable_json,
+                               prefer_gpu, expose_methods_json, 0);
+}
+
+/* "[false,false,...]", one per layer in the layers JSON */
+static char* frozen_json(const char* layers){
+  int n = 0;
+  for(const char* p = layers; p && (p = strstr(p, "\"Width\"")); p += 7) ++n;
+  char* b = (char*)malloc((size_t)n*6 + 3);
+  if(!b) return NULL;
+  size_t len = 0;
+  b[len++] = '[';
+  for(int i=0;i<n;i++){ if(i) b[len++] = ','; memcpy(b+len, "false", 5); len += 5; }
+  b[len++] = ']'; b[len] = 0;
+  return b;
+}
+
+static int set_inference(ParagonAPI* api, ParagonHandle h){
+  if(api->SetInferenceOnly) return api->SetInferenceOnly(h)==0;
+  if(!(api->caps & PARAGON_CAP_INFERENCE)) return 0;
+  ParagonMethod m = paragon_method_id(api, h, "SetInferenceOnly");
+  char* r = m>=0 ? paragon_call_id(api, h, m, "[]") : NULL;
+  int ok = r && !strstr(r, "\"error\"");
+  paragon_free_result(api, r);
+  return ok;
+}
+
+ParagonHandle paragon_new_handle_ex(ParagonAPI* api, const char* layers_json,
+                                    const char* activs_json, const char* trainable_json,
+                                    bool prefer_gpu, bool expose_methods_json, unsigned flags){
+  if(!api) return -1;
+  int inference = (flags & PARAGON_NEW_INFERENCE)!=0;
+  int lean = inference && (api->SetInferenceOnly || (api->caps & PARAGON_CAP_INFERENCE));
+  long long est_host, est_device;
+  if(lean) paragon_mem_estimate_inference(layers_json, &est_host, &est_device);
+  else     paragon_mem_estimate(layers_json, &est_host, &est_device);
+  if(!paragon_mem_admit(api, est_host, 0, 0)) return -1;
+  char* frozen = inference ? frozen_json(layers_json) : NULL;
+  if(inference && !frozen){ paragon_mem_unreserve(api, est_host, 0); return -1; }
+  long long rss0 = paragon_rss_bytes();
+  char* r = paragon_new_net_any(api, layers_json, activs_json, frozen ? frozen : trainable_json,
+                                prefer_gpu, expose_methods_json);
+  free(frozen);
+  ParagonHandle h = paragon_parse_handle(r);
+  if(h<=0){
+    fprintf(stderr, "NewNetwork failed or missing. newr=%s\n", r?r:"<null>");
+    paragon_free_result(api, r);
+    paragon_mem_unreserve(api, est_host, 0);
+    return -1;
+  }
+  (void)paragon_register_handle(api, h, layers_json, expose_methods_json ? r : NULL);
+  paragon_free_result(api, r);
+  if(lean && set_inference(api, h)){
+    pthread_mutex_lock(&api->lock);
+    ParagonHandleInfo* e = find_locked(api, h);
+    if(e) e->flags |= PARAGON_HF_INFERENCE;
+    pthread_mutex_unlock(&api->lock);
+  }
+  paragon_mem_created(api, h, layers_json, rss0, est_host);   /* after the library let go */
+  return h;
+}
+
+int paragon_register_handle(ParagonAPI* api, ParagonHandle h, const char* layers_json,
+                            const char* advertised){
+  if(!api || h<=0) return 0;
+  int in_dim, out_dim;
+  io_dims(layers_json, &in_dim, &out_dim);
+
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = insert_locked(api, h);
+  if(e){
+    e->in_dim = in_dim; e->out_dim = out_dim;
+    e->shape_key = paragon_hash64(layers_json, layers_json ? strlen(layers_json) : 0, 0);
+    if(advertised){
+      char pat[64];
+      for(int i=0; i<api->nmethods && i<64; ++i){
+        snprintf(pat, sizeof(pat), "\"%s\"", api->methods[i].name);
+        if(strstr(advertised, pat)) e->methods |= 1ull<<i;
+      }
+    }
+  }
+  pthread_mutex_unlock(&api->lock);
+  return e!=NULL;
+}
+
+int paragon_handle_info(ParagonAPI* api, ParagonHandle h, ParagonHandleInfo* out){
+  if(!api || h<=0) return 0;
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = find_locked(api, h);
+  if(e && out) *out = *e;
+  pthread_mutex_unlock(&api->lock);
+  return e!=NULL;
+}
+
+unsigned long long paragon_handle_version(ParagonAPI* api, ParagonHandle h){
+  if(!api || h<=0) return 0;
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = find_locked(api, h);
+  unsigned long long v = e ? e->version : 0;
+  pthread_mutex_unlock(&api->lock);
+  return v;
+}
+
+/* unknown handles get an entry, so a version handed out before stays stale */
+void paragon_weights_changed(ParagonAPI* api, ParagonHandle h){
+  if(!api || h<=0) return;
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = find_locked(api, h);
+  if(!e) e = insert_locked(api, h);
+  if(e) ++e->version;
+  pthread_mutex_unlock(&api->lock);
+}
+
+void paragon_gpu_toggled(ParagonAPI* api, ParagonHandle h, const char* reply){
+  if(!api || h<=0 || !reply || strstr(reply, "\"error\"")) return;
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = paragon_handle_locked(api, h, 1);
+  if(e) e->flags ^= PARAGON_HF_ON_GPU;
+  pthread_mutex_unlock(&api->lock);
+}
+
+int paragon_perturb_weights(ParagonAPI* api, ParagonHandle h, const char* args_json){
+  if(!api || h<=0) return 0;
+  const char* args = args_json ? args_json : "[0.1, 42]";
+  int ok = 1;
+  if(api->PerturbWeights) api->PerturbWeights(h, args);
+  else {
+    ParagonMethod m = paragon_method_id(api, h, "PerturbWeights");
+    char* r = m>=0 ? paragon_call_id(api, h, m, args) : NULL;
+    ok = r!=NULL;
+    paragon_free_result(api, r);
+  }
+  paragon_weights_changed(api, h);    /* even on failure: the library may have got halfway */
+  return ok;
+}
+
+static char* init_gpu(ParagonAPI* api, ParagonHandle h, int k){
+  long long need = 0;
+  int was = -1;
+  pthread_mutex_lock(&api->lock);
+  ParagonHandleInfo* e = find_locked(api, h);
+  if(e){
+    was = e->adapter;
+    e->adapter = k;                   /* part of the pipeline-cache key */
+    if(!(e->flags & PARAGON_HF_GPU_INIT)) need = e->est_device;
+  }
+  pthread_mutex_unlock(&api->lock);
+  if(need && !paragon_mem_admit(api, 0, need, h)) return NULL;
+  long long rss0 = paragon_rss_bytes();
+  int cached = paragon_gpu_cache_import(api, h);   /* first, so the library can skip compiles */
+  char* r = NULL;
+  if(k>=0){
+    int t = paragon_mem_touch(api, h);     /* paragon_call_id does this for the default path */
+    if(t>=0) r = api->InitGPUOn(h, k);
+    paragon_mem_untouch(api, h, t);
+  }
+  else r = paragon_call_id(api, h, PARAGON_M_INIT_GPU, "[]");
+  int ok = r && !strstr(r, "\"error\"");
+  if(!ok){                            /* no GPU state, nothing to flag, bind or charge */
+    pthread_mutex_lock(&api->lock);
+    e = find_locked(api, h);
+    if(e) e->adapter = was;
+    pthread_mutex_unlock(&api->lock);
+    paragon_mem_unreserve(api, 0, need);
+    return r;
+  }
+  if(!cached) paragon_gpu_cache_export(api, h, r);
+  pthread_mutex_lock(&api->lock);
+  e = find_locked(api, h);
+  if(e) e->flags |= PARAGON_HF_GPU_INIT | (cached ? PARAGON_HF_GPU_CACHED : 0u);
+  pthread_mutex_unlock(&api->lock);
+  paragon_mem_gpu_ready(api, h, rss0, need);
+  return r;
+}
+
+char* paragon_init_gpu(ParagonAPI* api, ParagonHandle h){
+  if(!api) return NULL;
+  return init_gpu(api, h, -1);
+}
+
+int paragon_adapter_count(ParagonAPI* api){
+  int n = api && api->AdapterCount ? api->AdapterCount() : 1;
+  return n>0 ? n : 1;
+}
+
+char* paragon_adapter_info(ParagonAPI* api, int k){
+  if(!api || !api->AdapterInfo || k<0 || k>=paragon_adapter_count(api)) return NULL;
+  return api->AdapterInfo(k);
+}
+
+char* paragon_init_gpu_on(ParagonAPI* api, ParagonHandle h, int k){
+  if(!api) return NULL;
+  if(k<0 || !api->InitGPUOn || k>=paragon_adapter_count(api)) return init_gpu(api, h, -1);
+  return init_gpu(api, h, k);
+}
@@ -0,0 +1,184 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "paragon.h"
+
+/* CPU/GPU routing by measured cost. Calibration times paragon_forward_batch on both
+   handles at batch 1, 2, 4 … max_batch and keeps the median of each; between sizes the
+   curve is interpolated log-log, past the last one it grows linearly. A request goes to
+   the backend with the smaller (queued work + predicted time for its batch), where
+   queued work is the predicted time of everything already admitted to that backend.
+   Each completed call nudges a per-backend scale (EWMA of observed/predicted), so the
+   curves follow drift such as clocks, other tenants or a warming GPU. */
+
+#define EWMA 0.05
+
+struct ParagonRouter {
+  ParagonAPI*     api;
+  ParagonHandle   h[2];
+  int             in_dim, out_dim, nsizes;
+  int             sizes[PARAGON_ROUTE_MAX_SIZES];
+  double          ms[2][PARAGON_ROUTE_MAX_SIZES];   /* INFINITY: backend unusable */
+  double          scale[2];
+  long long       backlog_ns[2];                    /* predicted work admitted, not yet done */
+  long long       routed[2];
+  pthread_mutex_t mu[2];                            /* a handle takes one call at a time */
+};
+
+static double mono_ms(void){
+  struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec*1000.0 + ts.tv_nsec/1e6;
+}
+
+static int cmp_double(const void* a, const void* b){
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x>y) - (x<y);
+}
+
+ParagonRouter* paragon_router_new(ParagonAPI* api, ParagonHandle cpu, ParagonHandle gpu,
+                                  int in_dim, int out_dim){
+  if(!api || cpu<=0 || in_dim<=0 || out_dim<=0) return NULL;
+  ParagonRouter* r = (ParagonRouter*)calloc(1, sizeof(*r));
+  if(!r) return NULL;
+  r->api = api; r->h[PARAGON_ROUTE_CPU] = cpu; r->h[PARAGON_ROUTE_GPU] = gpu;
+  r->in_dim = in_dim; r->out_dim = out_dim;
+  r->nsizes = 1; r->sizes[0] = 1;
+  r->ms[PARAGON_ROUTE_CPU][0] = 1.0;                 /* uncalibrated: everything to CPU */
+  r->ms[PARAGON_ROUTE_GPU][0] = INFINITY;
+  r->scale[0] = r->scale[1] = 1.0;
+  pthread_mutex_init(&r->mu[0], NULL);
+  pthread_mutex_init(&r->mu[1], NULL);
+  return r;
+}
+
+int paragon_router_calibrate(ParagonRouter* r, int max_batch, int iters){
+  if(!r) return 0;
+  if(max_batch<1) max_batch = 256;
+  if(iters<1) iters = 5;
+  int n = 0;
+  for(int b=1; b<=max_batch && n<PARAGON_ROUTE_MAX_SIZES; b*=2) r->sizes[n++] = b;
+  int top = r->sizes[n-1];
+  float* X = (float*)malloc(sizeof(float)*(size_t)top*r->in_dim);
+  float* Y = (float*)malloc(sizeof(float)*(size_t)top*r->out_dim);
+  double* v = (double*)malloc(sizeof(double)*(size_t)iters);
+  if(!X || !Y || !v){ free(X); free(Y); free(v); return 0; }
+  for(size_t i=0; i<(size_t)top*r->in_dim; i++) X[i] = (float)((i*2654435761u % 1000u)/1000.0);
+
+  int usable = 0;
+  for(int b=0; b<2; b++){
+    pthread_mutex_lock(&r->mu[b]);
+    for(int k=0;k<n;k++){
+      double* ms = &r->ms[b][k];
+      if(r->h[b]<=0){ *ms = INFINITY; continue; }
+      if(paragon_forward_batch(r->api, r->h[b], X, r->sizes[k], r->in_dim, Y, r->out_dim)!=r->sizes[k]){
+        *ms = INFINITY; continue;                    /* warmup doubles as the health check */
+      }
+      for(int i=0;i<iters;i++){
+        double t0 = mono_ms();
+        (void)paragon_forward_batch(r->api, r->h[b], X, r->sizes[k], r->in_dim, Y, r->out_dim);
+        v[i] = mono_ms() - t0;
+      }
+      qsort(v, (size_t)iters, sizeof(double), cmp_double);
+      *ms = v[iters/2] > 1e-6 ? v[iters/2] : 1e-6;
+    }
+    r->scale[b] = 1.0;
+    pthread_mutex_unlock(&r->mu[b]);
+    if(isfinite(r->ms[b][0])) ++usable;
+  }
+  r->nsizes = n;
+  free(X); free(Y); free(v);
+  if(!usable) fprintf(stderr, "paragon_router_calibrate: neither backend completed a forward\n");
+  return usable>0;
+}
+
+/* calibrated curve at batch n, before the drift scale */
+static double curve(const ParagonRouter* r, int b, int n){
+  const double* ms = r->ms[b];
+  const int* s = r->sizes;
+  int last = r->nsizes-1;
+  if(n<=s[0]) return ms[0];
+  if(n>=s[last]) return ms[last] * n / s[last];
+  int k = 0;
+  while(s[k+1] < n) ++k;
+  if(!isfinite(ms[k]) || !isfinite(ms[k+1])) return INFINITY;
+  double f = (log((double)n) - log((double)s[k])) / (log((double)s[k+1]) - log((double)s[k]));
+  return exp(log(ms[k]) + f*(log(ms[k+1]) - log(ms[k])));
+}
+
+double paragon_router_predict(const ParagonRouter* r, int backend, int n){
+  if(!r || (backend!=PARAGON_ROUTE_CPU && backend!=PARAGON_ROUTE_GPU) || n<1) return INFINITY;
+  double s; __atomic_load(&r->scale[backend], &s, __ATOMIC_RELAXED);
+  return curve(r, backend, n) * s;
+}
+
+int paragon_router_pick(const ParagonRouter* r, int n, double* cost_ms){
+  double c[2];
+  for(int b=0;b<2;b++)
+    c[b] = paragon_router_predict(r, b, n)
+         + __atomic_load_n(&r->backlog_ns[b], __ATOMIC_RELAXED)/1e6;
+  int b = c[PARAGON_ROUTE_GPU] < c[PARAGON_ROUTE_CPU] ? PARAGON_ROUTE_GPU : PARAGON_ROUTE_CPU;
+  if(cost_ms) *cost_ms = c[b];
+  return b;
+}
+
+int paragon_router_forward(ParagonRouter* r, const float* X, int n, int dim,
+                           float* Y, int out_dim, int* used){
+  if(!r || !X || !Y || n<=0) return -1;
+  int b = paragon_router_pick(r, n, NULL);
+  double pred = paragon_router_predict(r, b, n);
+  long long pred_ns = isfinite(pred) ? (long long)(pred*1e6) : 0;
+  __atomic_add_fetch(&r->backlog_ns[b], pred_ns, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&r->routed[b], 1, __ATOMIC_RELAXED);
+
+  pthread_mutex_lock(&r->mu[b]);
+  double t0 = mono_ms();
+  int got = paragon_forward_batch(r->api, r->h[b], X, n, dim, Y, out_dim);
+  double dt = mono_ms() - t0;
+  double base = curve(r, b, n);
+  if(got==n && isfinite(base) && base>0){
+    double s = r->scale[b]*(1.0-EWMA) + (dt/base)*EWMA;   /* writers hold mu[b] */
+    __atomic_store(&r->scale[b], &s, __ATOMIC_RELAXED);
+  }
+  pthread_mutex_unlock(&r->mu[b]);
+
+  __atomic_sub_fetch(&r->backlog_ns[b], pred_ns, __ATOMIC_RELAXED);
+  if(used) *used = b;
+  return got;
+}
+
+int paragon_router_crossover(const ParagonRouter* r){
+  if(!r) return -1;
+  int from = -1;                               /* GPU must keep winning from here up */
+  for(int k=r->nsizes-1; k>=0 && r->ms[PARAGON_ROUTE_GPU][k] < r->ms[PARAGON_ROUTE_CPU][k]; --k)
+    from = r->sizes[k];
+  return from;
+}
+
+void paragon_router_stats(const ParagonRouter* r, ParagonRouterStats* st){
+  memset(st, 0, sizeof(*st));
+  if(!r) return;
+  st->nsizes = r->nsizes;
+  for(int k=0;k<r->nsizes;k++){
+    st->sizes[k]  = r->sizes[k];
+    st->cpu_ms[k] = r->ms[PARAGON_ROUTE_CPU][k];
+    st->gpu_ms[k] = r->ms[PARAGON_ROUTE_GPU][k];
+  }
+  for(int b=0;b<2;b++){
+    st->routed[b] = __atomic_load_n(&r->routed[b], __ATOMIC_RELAXED);
+    __atomic_load(&r->scale[b], &st->scale[b], __ATOMIC_RELAXED);
+  }
+  st->crossover = paragon_router_crossover(r);
+}
+
+void paragon_router_free(ParagonRouter* r){
+  if(!r) return;
+  pthread_mutex_destroy(&r->mu[0]);
+  pthread_mutex_destroy(&r->mu[1]);
+  free(r);
+}
@@ -0,0 +1,226 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "paragon.h"
+
+/* Per-call spans. A span is opened by the outermost bridge call on a thread (nested
+   calls, e.g. Forward's JSON path going through paragon_call_id, fold into it) and
+   marks three instants: library entered, library returned, done. Everything before
+   the first is marshalling the arguments, everything after the second is unmarshalling
+   the result. Finished spans are claimed with one fetch_add on the ring head and
+   published seqlock-style, so writers never wait and the exporter skips torn slots.
+   Totals are kept separately and survive the ring wrapping. */
+
+typedef struct {
+  size_t         seq;        /* index+1 once published, 0 while being written */
+  ParagonSpanRec r;
+} Slot;
+
+struct ParagonTrace {
+  Slot*                   ring;
+  size_t                  mask;
+  int                     on;
+  unsigned long long      t_start;    /* ns */
+  char                    path[512];  /* PARAGON_TRACE: exported by paragon_unload */
+  _Alignas(64) size_t     head;
+  _Alignas(64) long long  calls, arg_bytes, result_bytes;
+  unsigned long long      ser_ns, lib_ns, deser_ns;
+};
+
+static __thread int tls_depth;
+static __thread int tls_tid;
+
+static unsigned long long mono_ns(void){
+  struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec*1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+int paragon_trace_start(ParagonAPI* api, int cap){
+  if(!api) return 0;
+  if(!api->trace){
+    size_t n = 1024;
+    while(n < (size_t)(cap>0 ? cap : PARAGON_TRACE_DEFAULT_CAP)) n <<= 1;
+    ParagonTrace* t = (ParagonTrace*)aligned_alloc(64, (sizeof(*t) + 63) & ~(size_t)63);
+    if(!t) return 0;
+    memset(t, 0, sizeof(*t));
+    t->ring = (Slot*)calloc(n, sizeof(Slot));
+    if(!t->ring){ free(t); return 0; }
+    t->mask = n-1;
+    t->t_start = mono_ns();
+    api->trace = t;
+  }
+  __atomic_store_n(&api->trace->on, 1, __ATOMIC_RELEASE);
+  return 1;
+}
+
+void paragon_trace_stop(ParagonAPI* api){
+  if(api && api->trace) __atomic_store_n(&api->trace->on, 0, __ATOMIC_RELEASE);
+}
+
+void paragon_trace_free(ParagonAPI* api){
+  if(!api || !api->trace) return;
+  if(api->trace->path[0]) (void)paragon_trace_export(api, api->trace->path);
+  free(api->trace->ring);
+  free(api->trace);
+  api->trace = NULL;
+}
+
+void paragon_trace_env(ParagonAPI* api){
+  const char* p = getenv("PARAGON_TRACE");
+  if(!p || !*p || !paragon_trace_start(api, 0)) return;
+  snprintf(api->trace->path, sizeof(api->trace->path), "%s", p);
+}
+
+/* ---- hot path ---- */
+
+void paragon_span_begin(ParagonAPI* api, ParagonSpan* s, const char* name, ParagonHandle h){
+  ParagonTrace* t = api ? api->trace : NULL;
+  if(!t || tls_depth || !__atomic_load_n(&t->on, __ATOMIC_RELAXED)){ s->t = NULL; return; }
+  tls_depth = 1;
+  s->t = t; s->name = name; s->h = h;
+  s->t0 = s->t1 = s->t2 = mono_ns();
+}
+
+void paragon_span_lib(ParagonSpan* s){ if(s->t) s->t1 = mono_ns(); }
+void paragon_span_ret(ParagonSpan* s){ if(s->t) s->t2 = mono_ns(); }
+
+void paragon_span_end(ParagonSpan* s, long long arg_bytes, long long result_bytes){
+  ParagonTrace* t = s->t;
+  if(!t) return;
+  tls_depth = 0;
+  unsigned long long t3 = mono_ns();
+  if(!tls_tid) tls_tid = (int)syscall(SYS_gettid);
+
+  size_t i = __atomic_fetch_add(&t->head, 1, __ATOMIC_RELAXED);
+  Slot* sl = &t->ring[i & t->mask];
+  __atomic_store_n(&sl->seq, 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  ParagonSpanRec* r = &sl->r;
+  size_t k = 0;
+  for(const char* p = s->name ? s->name : "?"; *p && k+1<sizeof(r->name); ++p)
+    r->name[k++] = (*p=='"' || *p=='\\' || (unsigned char)*p<0x20) ? '_' : *p;   /* JSON-safe */
+  r->name[k] = 0;
+  r->h = s->h; r->tid = tls_tid;
+  r->t0 = s->t0 - t->t_start;
+  r->ser_ns = s->t1 - s->t0; r->lib_ns = s->t2 - s->t1; r->deser_ns = t3 - s->t2;
+  r->arg_bytes = arg_bytes; r->result_bytes = result_bytes;
+  __atomic_store_n(&sl->seq, i+1, __ATOMIC_RELEASE);
+
+  __atomic_add_fetch(&t->calls, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&t->arg_bytes, arg_bytes, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&t->result_bytes, result_bytes, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&t->ser_ns, r->ser_ns, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&t->lib_ns, r->lib_ns, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&t->deser_ns, r->deser_ns, __ATOMIC_RELAXED);
+}
+
+/* ---- readers ---- */
+
+void paragon_trace_stats(const ParagonAPI* api, ParagonTraceStats* st){
+  memset(st, 0, sizeof(*st));
+  const ParagonTrace* t = api ? api->trace : NULL;
+  if(!t) return;
+  st->calls        = __atomic_load_n(&t->calls, __ATOMIC_RELAXED);
+  st->arg_bytes    = __atomic_load_n(&t->arg_bytes, __ATOMIC_RELAXED);
+  st->result_bytes = __atomic_load_n(&t->result_bytes, __ATOMIC_RELAXED);
+  st->ser_ms       = __atomic_load_n(&t->ser_ns, __ATOMIC_RELAXED)/1e6;
+  st->lib_ms       = __atomic_load_n(&t->lib_ns, __ATOMIC_RELAXED)/1e6;
+  st->deser_ms     = __atomic_load_n(&t->deser_ns, __ATOMIC_RELAXED)/1e6;
+  st->elapsed_ms   = (mono_ns() - t->t_start)/1e6;
+  st->calls_per_s  = st->elapsed_ms>0 ? st->calls*1000.0/st->elapsed_ms : 0.0;
+  size_t head = __atomic_load_n(&t->head, __ATOMIC_RELAXED);
+  st->dropped      = head > t->mask+1 ? (long long)(head - (t->mask+1)) : 0;
+}
+
+int paragon_trace_spans(const ParagonAPI* api, ParagonSpanRec* out, int cap){
+  const ParagonTrace* t = api ? api->trace : NULL;
+  if(!t || !out || cap<=0) return 0;
+  size_t head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+  size_t n = t->mask+1, first = head > n ? head - n : 0;
+  int got = 0;
+  for(size_t i=first; i<head && got<cap; ++i){
+    const Slot* sl = &t->ring[i & t->mask];
+    size_t s1 = __atomic_load_n(&sl->seq, __ATOMIC_ACQUIRE);
+    if(s1 != i+1) continue;                     /* still being written, or lapped */
+    ParagonSpanRec r = sl->r;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if(__atomic_load_n(&sl->seq, __ATOMIC_RELAXED) != s1) continue;
+    out[got++] = r;
+  }
+  return got;
+}
+
+static void put_str(FILE* f, const char* s){
+  fputc('"', f);
+  for(; *s; ++s){
+    unsigned char c = (unsigned char)*s;
+    if(c=='"' || c=='\\') { fputc('\\', f); fputc(c, f); }
+    else if(c<0x20)       fprintf(f, "\\u%04x", c);
+    else                  fputc(c, f);
+  }
+  fputc('"', f);
+}
+
+static int by_t0(const void* a, const void* b){
+  unsigned long long x = ((const ParagonSpanRec*)a)->t0, y = ((const ParagonSpanRec*)b)->t0;
+  return x<y ? -1 : x>y;
+}
+
+/* Trace Event Format: one complete ("X") event per call with its serialize / library /
+   deserialize phases nested under it, plus counter tracks for calls/s (10 ms buckets)
+   and cumulative bytes marshalled. Loads in chrome://tracing and ui.perfetto.dev. */
+int paragon_trace_export(const ParagonAPI* api, const char* path){
+  const ParagonTrace* t = api ? api->trace : NULL;
+  if(!t || !path) return 0;
+  int cap = (int)(t->mask+1);
+  ParagonSpanRec* v = (ParagonSpanRec*)malloc(sizeof(*v)*(size_t)cap);
+  if(!v) return 0;
+  int n = paragon_trace_spans(api, v, cap);
+  qsort(v, (size_t)n, sizeof(*v), by_t0);
+  FILE* f = fopen(path, "w");
+  if(!f){ fprintf(stderr, "paragon_trace_export: cannot write %s\n", path); free(v); return 0; }
+
+  ParagonTraceStats st; paragon_trace_stats(api, &st);
+  fprintf(f, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"library\":");
+  put_str(f, api->lib_version);
+  fprintf(f, ",\"calls\":%lld,\"arg_bytes\":%lld,\"result_bytes\":%lld,\"dropped\":%lld},\"traceEvents\":[\n",
+    st.calls, st.arg_bytes, st.result_bytes, st.dropped);
+  fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"paragon bridge\"}}");
+  static const char* const PHASE[3] = { "serialize", "library", "deserialize" };
+  long long bytes = 0, bucket = -1, in_bucket = 0;
+  for(int i=0;i<n;i++){
+    const ParagonSpanRec* r = &v[i];
+    double ts = r->t0/1e3, dur = (r->ser_ns + r->lib_ns + r->deser_ns)/1e3;
+    fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"paragon\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+               "\"pid\":1,\"tid\":%d,\"args\":{\"handle\":%lld,\"arg_bytes\":%lld,\"result_bytes\":%lld}}",
+      r->name, ts, dur, r->tid, r->h, r->arg_bytes, r->result_bytes);
+    unsigned long long ph[3] = { r->ser_ns, r->lib_ns, r->deser_ns }, at = r->t0;
+    for(int k=0;k<3;k++){
+      if(ph[k]) fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"paragon\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+        PHASE[k], at/1e3, ph[k]/1e3, r->tid);
+      at += ph[k];
+    }
+    bytes += r->arg_bytes + r->result_bytes;
+    fprintf(f, ",\n{\"name\":\"bytes marshalled\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"bytes\":%lld}}", ts, bytes);
+    long long b = (long long)(r->t0/10000000ull);
+    if(b!=bucket){
+      if(bucket>=0) fprintf(f, ",\n{\"name\":\"calls/s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"calls\":%lld}}",
+        bucket*1e4, in_bucket*100);
+      bucket = b; in_bucket = 0;
+    }
+    ++in_bucket;
+  }
+  if(bucket>=0) fprintf(f, ",\n{\"name\":\"calls/s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"calls\":%lld}}",
+    bucket*1e4, in_bucket*100);
+  fprintf(f, "\n]}\n");
+  int ok = !ferror(f);
+  if(fclose(f)) ok = 0;
+  free(v);
+  return ok;
+}
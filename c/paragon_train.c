@@ -0,0 +1,162 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paragon.h"
+
+/* Batched training. The N rows are cut into steps of opts.step rows; each step is one
+   library call with epochs=1, so the caller controls epochs, step size and order while
+   the library runs backward + update. Train_F32 takes the step straight from float
+   buffers; otherwise the step goes through Call("Train") as [inputs, targets, 1, lr,
+   false, clip_max, clip_min], the Go Network.Train argument order. Shuffling gathers the
+   step's rows into scratch first. Every step bumps the handle's model version. */
+
+void paragon_train_defaults(ParagonTrainOpts* o){
+  memset(o, 0, sizeof(*o));
+  o->epochs = 1;
+  o->lr = 0.05f;
+  o->clip_min = -2.0f; o->clip_max = 2.0f;
+  o->seed = 1;
+}
+
+/* [[[x0,...]],[[x1,...]],...]: one Height=1 grid per sample */
+static char* json_samples(ParagonArena* a, const float* X, int n, int dim){
+  size_t cap = (size_t)n*dim*16 + (size_t)n*8 + 8;
+  char* b = (char*)paragon_arena_alloc(a, cap);
+  if(!b) return NULL;
+  size_t len = 0;
+  b[len++] = '[';
+  for(int r=0; r<n; ++r){
+    if(r) b[len++] = ',';
+    b[len++] = '['; b[len++] = '[';
+    for(int c=0; c<dim; ++c)
+      len += (size_t)snprintf(b+len, cap-len, c?",%.9g":"%.9g", (double)X[(size_t)r*dim+c]);
+    b[len++] = ']'; b[len++] = ']';
+  }
+  b[len++] = ']'; b[len] = 0;
+  return b;
+}
+
+static int train_step(ParagonAPI* api, ParagonHandle h, ParagonMethod m, const float* X,
+                      const float* Y, int rows, int dim, int ydim, const ParagonTrainOpts* o){
+  ParagonSpan sp; paragon_span_begin(api, &sp, "Train", h);
+  long long bytes = (long long)rows*(dim + ydim)*(long long)sizeof(float);
+  int ok;
+  if(api->Train_F32){
+    ok = api->Train_F32(h, X, rows, dim, Y, ydim, 1, o->lr, o->clip_min, o->clip_max)==0;
+    paragon_span_ret(&sp);
+  } else {
+    ParagonArena* sc = paragon_scratch();
+    char* xs = sc ? json_samples(sc, X, rows, dim) : NULL;
+    char* ys = xs ? json_samples(sc, Y, rows, ydim) : NULL;
+    char* args = ys ? paragon_arena_printf(sc, "[%s,%s,1,%.9g,false,%.9g,%.9g]",
+                                           xs, ys, (double)o->lr, (double)o->clip_max, (double)o->clip_min) : NULL;
+    if(!args){ paragon_span_end(&sp, 0, 0); if(sc) paragon_arena_reset(sc); return 0; }
+    bytes = (long long)strlen(args);
+    paragon_span_lib(&sp);
+    char* r = paragon_call_id(api, h, m, args);
+    paragon_span_ret(&sp);
+    ok = r && !strstr(r, "\"error\"");
+    paragon_free_result(api, r);
+    paragon_arena_reset(sc);
+  }
+  paragon_span_end(&sp, bytes, 0);
+  return ok;
+}
+
+static int train(ParagonAPI* api, ParagonHandle h, const float* X, int n, int dim,
+                 const float* Y, int ydim, const ParagonTrainOpts* opts){
+  ParagonTrainOpts o;
+  if(opts) o = *opts; else paragon_train_defaults(&o);
+  if(o.epochs<1) o.epochs = 1;
+  ParagonHandleInfo hi;
+  if(paragon_handle_info(api, h, &hi) && (hi.flags & PARAGON_HF_INFERENCE)){
+    fprintf(stderr, "paragon_train: handle %lld was built inference-only\n", (long long)h);
+    return -1;
+  }
+  int step = o.step>0 && o.step<n ? o.step : n;
+
+  ParagonMethod m = -1;
+  if(!api->Train_F32){
+    m = api->Call ? paragon_method_id(api, h, "Train") : -1;
+    if(m<0){ fprintf(stderr, "paragon_train: library exports neither Train_F32 nor Call\n"); return -1; }
+  }
+  if(o.gpu){
+    /* same sequence as the pool's warm(): init, enable, then ToggleGPU only if not there yet */
+    if(!paragon_handle_info(api, h, &hi) || !(hi.flags & PARAGON_HF_GPU_INIT)){
+      paragon_free_result(api, paragon_init_gpu(api, h));
+      (void)paragon_enable_gpu(api, h);
+    }
+    if(!paragon_handle_info(api, h, &hi) || !(hi.flags & PARAGON_HF_ON_GPU))
+      paragon_free_result(api, paragon_call_id(api, h, PARAGON_M_TOGGLE_GPU, "[]"));
+  }
+
+  int* order = NULL;
+  float *gx = NULL, *gy = NULL;
+  if(o.shuffle){
+    order = (int*)malloc(sizeof(int)*(size_t)n);
+    gx = (float*)malloc(sizeof(float)*(size_t)step*dim);
+    gy = (float*)malloc(sizeof(float)*(size_t)step*ydim);
+    if(!order || !gx || !gy){ free(order); free(gx); free(gy); return -1; }
+    for(int i=0;i<n;i++) order[i] = i;
+  }
+  unsigned s = o.seed ? o.seed : 1u;
+  int steps = 0;
+  for(int e=0; e<o.epochs; e++){
+    if(order)
+      for(int i=n-1;i>0;i--){
+        s = s*1664525u + 1013904223u;
+        int j = (int)((s>>8) % (unsigned)(i+1)), t = order[i];
+        order[i] = order[j]; order[j] = t;
+      }
+    for(int r0=0; r0<n; r0+=step){
+      int rows = n-r0<step ? n-r0 : step;
+      const float* x = X + (size_t)r0*dim;
+      const float* y = Y + (size_t)r0*ydim;
+      if(order){
+        for(int i=0;i<rows;i++){
+          memcpy(gx + (size_t)i*dim,  X + (size_t)order[r0+i]*dim,  sizeof(float)*(size_t)dim);
+          memcpy(gy + (size_t)i*ydim, Y + (size_t)order[r0+i]*ydim, sizeof(float)*(size_t)ydim);
+        }
+        x = gx; y = gy;
+      }
+      int ok = train_step(api, h, m, x, y, rows, dim, ydim, &o);
+      paragon_weights_changed(api, h);
+      if(!ok){
+        fprintf(stderr, "paragon_train: step %d (epoch %d) failed\n", steps, e);
+        free(order); free(gx); free(gy);
+        return steps ? steps : -1;
+      }
+      ++steps;
+      if(o.on_step) o.on_step(e, steps, o.user);
+    }
+  }
+  free(order); free(gx); free(gy);
+  return steps;
+}
+
+/* the handle stays in flight for the whole run, so an EVICT budget cannot free it
+   between steps */
+int paragon_train(ParagonAPI* api, ParagonHandle h, const float* X, int n, int dim,
+                  const float* Y, int ydim, const ParagonTrainOpts* opts){
+  if(!api || h<=0 || !X || !Y || n<=0 || dim<=0 || ydim<=0) return -1;
+  int t = paragon_mem_touch(api, h);
+  if(t<0) return -1;
+  int r = train(api, h, X, n, dim, Y, ydim, opts);
+  paragon_mem_untouch(api, h, t);
+  return r;
+}
+
+int paragon_train_labels(ParagonAPI* api, ParagonHandle h, const float* X, int n, int dim,
+                         const int* labels, int classes, const ParagonTrainOpts* opts){
+  if(!labels || n<=0 || classes<=0) return -1;
+  float* Y = (float*)calloc((size_t)n*classes, sizeof(float));
+  if(!Y) return -1;
+  for(int i=0;i<n;i++)
+    if(labels[i]>=0 && labels[i]<classes) Y[(size_t)i*classes + labels[i]] = 1.0f;
+  int r = paragon_train(api, h, X, n, dim, Y, classes, opts);
+  free(Y);
+  return r;
+}